@@ -4,6 +4,10 @@
 #include <stdbool.h>
 #include <netinet/in.h>
 
+#define MESSAGE_TYPE_HEARTBEAT 5 ///< Value of `MessageType::HEARTBEAT` on the server.
+#define HEARTBEAT_PING 0 ///< Value of `HeartbeatSubType::PING` on the server.
+#define HEARTBEAT_PONG 1 ///< Value of `HeartbeatSubType::PONG` on the server.
+
 /**
  * @struct Client
  * @brief Represents a client connection, supporting both TCP and UDP protocols.
@@ -18,6 +22,8 @@ typedef struct {
 /**
  * @brief Initializes a client connection.
  *
+ * The outcome is logged through `logEvent` once `initLogger` has been called.
+ *
  * @param client Pointer to the Client structure to initialize.
  * @param ip IP address of the server to connect to.
  * @param port Port number of the server.
@@ -45,6 +51,18 @@ bool sendMessage(Client* client, const char* message);
  */
 bool receiveMessage(Client* client, char* buffer, int buffer_size);
 
+/**
+ * @brief Answers a heartbeat ping from the server.
+ *
+ * If the message is a HEARTBEAT/PING, the same message is sent back as a
+ * HEARTBEAT/PONG so the server can measure the round-trip time.
+ *
+ * @param client Pointer to the Client structure.
+ * @param message Message received from the server.
+ * @return true if the message was a ping and the pong was sent, false otherwise.
+ */
+bool answerHeartbeat(Client* client, const char* message);
+
 /**
  * @brief Closes the client connection.
  *
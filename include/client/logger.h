@@ -14,13 +14,21 @@
  /**
   * @brief Logs an event with a timestamp and component.
   *
+  * Records use the server's format, "[timestamp] [component] [INFO] message", and are
+  * written by a background thread.
+  *
   * @param component Component name (e.g., "Client", "Server", "Inventory").
   * @param message Message to log.
   */
  void logEvent(const char* component, const char* message);
 
  /**
-  * @brief Closes the log file.
+  * @brief Writes every event logged so far to the log file.
+  */
+ void flushLogger();
+
+ /**
+  * @brief Writes pending events and closes the log file.
   */
  void closeLogger();
 
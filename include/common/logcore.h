@@ -0,0 +1,149 @@
+#ifndef LOGCORE_H
+#define LOGCORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_CORE_TIMESTAMP_SECONDS_LENGTH 19 ///< Length of "YYYY-MM-DD HH:MM:SS".
+#define LOG_CORE_TIMESTAMP_MAX_LENGTH 26 ///< Length of a timestamp with microseconds.
+#define LOG_CORE_LEVEL_MAX_LENGTH 7 ///< Length of the longest level name.
+#define LOG_CORE_DEFAULT_BUFFER_BYTES (64 * 1024) ///< Default size of a sink buffer.
+#define LOG_CORE_DEFAULT_FLUSH_INTERVAL_MS 50 ///< Default time records wait in an asynchronous sink.
+
+/**
+ * @enum LogCoreLevel
+ * @brief Severity level of a record. Matches `EventLogger::LogLevel`.
+ */
+typedef enum {
+    LOG_CORE_DEBUG,
+    LOG_CORE_INFO,
+    LOG_CORE_WARNING,
+    LOG_CORE_ERROR
+} LogCoreLevel;
+
+/**
+ * @struct LogCoreOptions
+ * @brief Settings of a log sink.
+ */
+typedef struct {
+    size_t bufferBytes; ///< Size of the write buffer.
+    bool async; ///< Whether a background thread performs the writes.
+    unsigned flushIntervalMs; ///< Maximum time a record waits in an asynchronous sink.
+    int timestampDigits; ///< Fractional-second digits of timestamps: 0, 3 or 6.
+} LogCoreOptions;
+
+/**
+ * @struct LogCoreSink
+ * @brief Buffered log file. Opaque; see `logCoreOpen`.
+ */
+typedef struct LogCoreSink LogCoreSink;
+
+/**
+ * @brief Gets the name of a level.
+ *
+ * @param level The level.
+ * @return "DEBUG", "INFO", "WARNING", "ERROR", or "UNKNOWN" for other values.
+ */
+const char* logCoreLevelName(int level);
+
+/**
+ * @brief Writes a timestamp as "YYYY-MM-DD HH:MM:SS" followed by the requested fraction.
+ *
+ * The date and time part is cached per thread and only reformatted when the second changes.
+ *
+ * @param out Buffer of at least `LOG_CORE_TIMESTAMP_MAX_LENGTH` characters. Not null-terminated.
+ * @param time The time to format.
+ * @param fractionDigits Fractional-second digits: 0, 3 or 6.
+ * @return The number of characters written.
+ */
+size_t logCoreFormatTimestamp(char* out, const struct timespec* time, int fractionDigits);
+
+/**
+ * @brief Gets the buffer size `logCoreFormatRecord` needs.
+ *
+ * @param componentLength Length of the component name.
+ * @param messageLength Length of the message.
+ * @return The maximum length of the record.
+ */
+size_t logCoreRecordCapacity(size_t componentLength, size_t messageLength);
+
+/**
+ * @brief Writes a record as "[timestamp] [component] [LEVEL] message\n".
+ *
+ * This is the record format of both the server's `EventLogger` and the client logger.
+ *
+ * @param out Buffer of at least `logCoreRecordCapacity` characters. Not null-terminated.
+ * @param time The time of the event.
+ * @param fractionDigits Fractional-second digits of the timestamp: 0, 3 or 6.
+ * @param component The component name.
+ * @param componentLength Length of the component name.
+ * @param level The severity level.
+ * @param message The message.
+ * @param messageLength Length of the message.
+ * @return The number of characters written.
+ */
+size_t logCoreFormatRecord(char* out, const struct timespec* time, int fractionDigits,
+                           const char* component, size_t componentLength, int level,
+                           const char* message, size_t messageLength);
+
+/**
+ * @brief Gets the default sink settings.
+ * @return Synchronous sink with a `LOG_CORE_DEFAULT_BUFFER_BYTES` buffer and second timestamps.
+ */
+LogCoreOptions logCoreDefaultOptions(void);
+
+/**
+ * @brief Opens a log file for appending through a buffered sink.
+ *
+ * A synchronous sink writes when its buffer fills and on flush. An asynchronous sink
+ * hands full buffers to a writer thread, which also writes every `flushIntervalMs`.
+ *
+ * @param path The path of the log file.
+ * @param options The sink settings, or NULL for the defaults.
+ * @return The sink, or NULL if the file cannot be opened or the writer cannot start.
+ */
+LogCoreSink* logCoreOpen(const char* path, const LogCoreOptions* options);
+
+/**
+ * @brief Appends a formatted record to the sink.
+ *
+ * @param sink The sink.
+ * @param record The record bytes.
+ * @param length The number of bytes.
+ * @return true if the record was accepted, false if the sink is NULL.
+ */
+bool logCoreWrite(LogCoreSink* sink, const char* record, size_t length);
+
+/**
+ * @brief Formats a record with the current time and appends it to the sink.
+ *
+ * @param sink The sink.
+ * @param level The severity level.
+ * @param component The component name.
+ * @param message The message.
+ * @return true if the record was accepted, false otherwise.
+ */
+bool logCoreLog(LogCoreSink* sink, int level, const char* component, const char* message);
+
+/**
+ * @brief Writes every record appended so far to the file.
+ * @param sink The sink.
+ */
+void logCoreFlush(LogCoreSink* sink);
+
+/**
+ * @brief Flushes the sink, stops its writer thread, closes the file and frees the sink.
+ * @param sink The sink. May be NULL.
+ */
+void logCoreClose(LogCoreSink* sink);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //LOGCORE_H
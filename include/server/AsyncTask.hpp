@@ -0,0 +1,31 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+
+/**
+ * @class AsyncTask
+ * @brief Return type for fire-and-forget coroutine handlers.
+ *
+ * A coroutine returning `AsyncTask` starts running immediately in the caller's
+ * thread and keeps running there until its first `co_await` that suspends.
+ * From then on it is resumed by whoever completes the awaited operation
+ * (typically the `EventLoop`). The coroutine frame frees itself when the body
+ * finishes, so the caller does not need to keep the returned object.
+ *
+ * Handlers must not let exceptions escape: there is nobody left to report them
+ * to, so an unhandled exception terminates the program.
+ */
+class AsyncTask {
+    public:
+        /**
+         * @brief Coroutine promise for `AsyncTask`.
+         */
+        struct promise_type {
+            AsyncTask get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+};
@@ -1,10 +1,38 @@
 #pragma once
 
+#include "CredentialDatabase.hpp"
+#include "Crypto.hpp"
+#include "RateLimiter.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace AuthenticationConstants {
     constexpr int MAX_FAILED_ATTEMPTS = 3; /**< Maximum number of failed login attempts before blocking. */
+    constexpr std::uint32_t DEFAULT_KDF_ITERATIONS = 100000; /**< PBKDF2 iterations for new password hashes. */
+    constexpr std::size_t SALT_BYTES = 16; /**< Random salt stored with each password hash. */
+    constexpr std::size_t HASH_BYTES = 32; /**< Derived key length. */
+    constexpr std::chrono::seconds DEFAULT_VERIFIED_LOGIN_TTL{300}; /**< How long a verified login skips the KDF. */
+    constexpr std::chrono::seconds DEFAULT_SESSION_TOKEN_TTL{3600}; /**< Lifetime of an issued session token. */
+    constexpr std::size_t SESSION_TOKEN_BYTES = 16; /**< Random bytes in a session token, hex-encoded on the wire. */
+    constexpr int STATUS_SLOT_BITS = 16; /**< Low bits of a client ID selecting its status slot, the connection slot of `ConnectionTable` IDs. */
+    constexpr std::size_t STATUS_SLOTS = std::size_t{1} << STATUS_SLOT_BITS; /**< Entries of the status table. */
+    constexpr int STATUS_CHUNK_BITS = 12; /**< log2 of the slots covered by one status chunk. */
+    constexpr std::size_t STATUS_CHUNK_SIZE = std::size_t{1} << STATUS_CHUNK_BITS; /**< Slots per status chunk. */
+    constexpr std::size_t STATUS_CHUNKS = STATUS_SLOTS / STATUS_CHUNK_SIZE; /**< Status chunks, allocated on first use. */
+    constexpr std::size_t LOCKDOWN_GROUPS = 256; /**< Number of groups that can be locked down separately. */
+    constexpr double DEFAULT_CLIENT_LOGINS_PER_SECOND = 1.0; /**< Password checks each client ID earns per second. */
+    constexpr double DEFAULT_CLIENT_LOGIN_BURST = 5.0; /**< Password checks a client ID can make back to back. */
+    constexpr double DEFAULT_SOURCE_LOGINS_PER_SECOND = 20.0; /**< Password checks each source address earns per second. */
+    constexpr double DEFAULT_SOURCE_LOGIN_BURST = 50.0; /**< Password checks a source address can make back to back. */
 }
 
 /**
@@ -19,16 +47,85 @@ namespace AuthenticationConstants {
  * Additionally, this class logs key events such as successful logins, failed login
  * attempts, client blocking, and credential modifications. These logs are essential
  * for auditing and debugging purposes.
+ *
+ * Passwords are stored as salted PBKDF2-HMAC-SHA-256 hashes, which are deliberately
+ * slow to compute. To keep reconnecting hubs from paying that cost on every login, a
+ * successful verification is remembered for a short time as an HMAC tag of the client
+ * ID, stored hash and password under a per-instance random key; a login that presents
+ * the same password again within the TTL is checked against the tag instead.
+ *
+ * After a password login the server can issue an opaque session token. Clients attach
+ * it to later messages and reconnections, and it is validated with a single hash table
+ * lookup. Each client has at most one live token; logging out, blocking or removing
+ * the client revokes it.
+ *
+ * All methods are thread-safe. Changes are serialized by a mutex, and password hashes
+ * are computed outside it. Each change republishes the client's authorization in a flat
+ * table of atomic flags indexed by client ID, so `isAuthorized`, which runs for every
+ * message, is a lock-free load. The table is allocated in chunks on first use and chunks
+ * are never freed, so readers need no reclamation scheme. Each connection takes its
+ * entry with `openConnection`, so the load answers for every live connection.
+ *
+ * Emergency alerts lock down every client, or every client of a group (a region), at
+ * once. Each lockdown takes a new epoch number and stores it in the global or group
+ * slot; a client is locked down while the active epoch of its scope is newer than the
+ * epoch at which it last unlocked with the secret phrase. Starting or ending a lockdown
+ * is therefore a single store, and the check in `authenticate` and `isAuthorized` is a
+ * couple of loads. Verification cache entries and session tokens record the epoch they
+ * were created in and are not accepted after a newer lockdown of their client.
+ *
+ * Before a password is hashed, the attempt takes a token from a bucket for its client ID
+ * and one for its source address. Attempts over either rate are refused without hashing
+ * and without counting as failed attempts, so a login flood costs the server no KDF work
+ * and cannot block a hub by guessing on its behalf. Logins answered by the verification
+ * cache are not limited.
+ *
+ * Credentials can also come from a `CredentialDatabase` file, which is memory-mapped
+ * and looked up in place; a client from the database gets its runtime state (login,
+ * failed attempts, blocks) the first time it is seen. `loadDatabase` swaps in a new
+ * file atomically while logins continue, then brings the clients already seen in line
+ * with it. Credentials added with `addCredentials` take precedence over the database.
  */
 class Authentication {
     public:
+        using GroupId = std::uint8_t; ///< Region or group a client belongs to, for scoped lockdowns.
+
+        /**
+         * @struct Config
+         * @brief Password hashing and verification cache settings.
+         */
+        struct Config {
+            std::uint32_t kdfIterations = AuthenticationConstants::DEFAULT_KDF_ITERATIONS; /**< PBKDF2 iterations for new hashes. */
+            std::chrono::milliseconds verifiedLoginTtl = AuthenticationConstants::DEFAULT_VERIFIED_LOGIN_TTL; /**< Lifetime of a verified login; zero disables the cache. */
+            std::chrono::milliseconds sessionTokenTtl = AuthenticationConstants::DEFAULT_SESSION_TOKEN_TTL; /**< Lifetime of a session token. */
+            RateLimiter::Options clientLoginLimit{AuthenticationConstants::DEFAULT_CLIENT_LOGINS_PER_SECOND,
+                                                  AuthenticationConstants::DEFAULT_CLIENT_LOGIN_BURST}; /**< Password checks allowed per client ID. */
+            RateLimiter::Options sourceLoginLimit{AuthenticationConstants::DEFAULT_SOURCE_LOGINS_PER_SECOND,
+                                                  AuthenticationConstants::DEFAULT_SOURCE_LOGIN_BURST}; /**< Password checks allowed per source address. */
+        };
+
+        /**
+         * @brief Constructs an Authentication object with the default settings.
+         */
+        Authentication();
+
+        /**
+         * @brief Constructs an Authentication object.
+         * @param config The hashing and cache settings.
+         */
+        explicit Authentication(const Config& config);
+
+        Authentication(const Authentication&) = delete;
+        Authentication& operator=(const Authentication&) = delete;
+
         /**
          * @brief Authenticates a client using their ID and password.
          *
          * This method verifies the provided password against the stored hashed password.
          * If the password is incorrect, the number of failed attempts is incremented.
          * After 3 consecutive failed attempts, the client is blocked. Additionally,
-         * authentication will fail if the client is already blocked or emergency blocked.
+         * authentication will fail if the client is already blocked or emergency blocked,
+         * or if the client ID or source address is over its login rate.
          *
          * Logs:
          * - Successful login.
@@ -37,14 +134,18 @@ class Authentication {
          *
          * @param client_id The unique identifier of the client.
          * @param password The plaintext password provided by the client.
+         * @param source The client's network address, or empty if unknown.
          * @return `true` if authentication is successful, `false` otherwise.
          */
-        bool authenticate(int client_id, const std::string& password);
+        bool authenticate(int client_id, const std::string& password, const std::string& source = "");
 
         /**
          * @brief Checks if a client is authorized to perform actions.
          *
-         * A client is considered authorized if they are logged in and not blocked.
+         * A client is considered authorized if they are logged in, not blocked and not
+         * locked down.
+         * Lock-free for every connection between `openConnection` and `closeConnection`.
+         * Other IDs take the lock when their status slot is held by another ID.
          *
          * @param client_id The unique identifier of the client.
          * @return `true` if the client is authorized, `false` otherwise.
@@ -65,6 +166,26 @@ class Authentication {
          */
         void setLoggedOut(int client_id);
 
+        /**
+         * @brief Takes the status slot of a new connection.
+         *
+         * Publishes the status of `client_id`, unauthorized unless it already has a
+         * login, in place of whatever ID held the slot before, so `isAuthorized` answers
+         * for the connection without taking the lock.
+         *
+         * @param client_id The connection's client ID.
+         */
+        void openConnection(int client_id);
+
+        /**
+         * @brief Logs out a closed connection and clears its status.
+         *
+         * The session token is kept, so the hub can resume on its next connection.
+         *
+         * @param client_id The connection's client ID.
+         */
+        void closeConnection(int client_id);
+
         /**
          * @brief Adds a new client with a hashed password.
          *
@@ -79,11 +200,37 @@ class Authentication {
          */
         void addCredentials(int client_id, const std::string& newPassword);
 
+        /**
+         * @brief Loads or reloads the credential database.
+         *
+         * The new database replaces the current one atomically; logins in progress finish
+         * against whichever database they started with. Clients of the previous database
+         * that are missing from the new one are removed, and clients whose password changed
+         * are logged out. On failure the current database stays in use.
+         *
+         * Each swap starts a new database generation. A client is reconciled with the
+         * database when it is next looked up, and the reload then walks the known clients,
+         * taking the lock once per client, so changes reach idle clients too without
+         * holding up logins for the whole walk.
+         *
+         * @param path The path of the database file.
+         * @throws std::runtime_error If the file cannot be opened or is not a valid database.
+         */
+        void loadDatabase(const std::string& path);
+
+        /**
+         * @brief Gets the number of clients in the loaded credential database.
+         * @return The number of entries, or 0 if no database is loaded.
+         */
+        [[nodiscard]] std::size_t getDatabaseSize() const;
+
         /**
          * @brief Removes the credentials of a client.
          *
          * This method deletes the authentication data of a client, effectively removing
          * them from the system. If the client ID does not exist, the method does nothing.
+         * A client from the credential database stays removed, across reloads, until it is
+         * added again with `addCredentials`.
          *
          * Logs:
          * - Client credentials removed.
@@ -122,7 +269,8 @@ class Authentication {
          * @brief Unlocks a client using a predefined secret phrase.
          *
          * If the client is blocked due to an emergency, this method allows unlocking them
-         * by providing the correct secret phrase.
+         * by providing the correct secret phrase. The phrase is checked against the hash in
+         * the credential database. Without a database holding a phrase, nobody can unlock.
          *
          * Logs:
          * - Client unlocked using the secret phrase.
@@ -131,7 +279,106 @@ class Authentication {
          * @param secretPhrase The secret phrase used to unlock the client.
          * @return `true` if the client was successfully unlocked, `false` otherwise.
          */
-        bool unlockWithSecretPhrase(int client_id, const std::string& secretPhrase);    // TODO: Implement it to read from a config file
+        bool unlockWithSecretPhrase(int client_id, const std::string& secretPhrase);
+
+        /**
+         * @brief Assigns a client to a lockdown group.
+         *
+         * Clients are in group 0 until assigned.
+         *
+         * @param client_id The unique identifier of the client.
+         * @param group The group.
+         */
+        void setGroup(int client_id, GroupId group);
+
+        /**
+         * @brief Locks down every client until `endLockdown` is called.
+         *
+         * Takes constant time regardless of the number of clients. Locked-down clients
+         * cannot authenticate and are not authorized; one can still be let through
+         * individually with `unlockWithSecretPhrase`.
+         */
+        void beginLockdown();
+
+        /**
+         * @brief Locks down every client of a group until `endLockdown(group)` is called.
+         * @param group The group to lock down.
+         */
+        void beginLockdown(GroupId group);
+
+        /**
+         * @brief Ends the global lockdown, unlocking every client it blocked.
+         *
+         * Group lockdowns and individual emergency blocks stay in place.
+         */
+        void endLockdown();
+
+        /**
+         * @brief Ends the lockdown of a group.
+         * @param group The group to unlock.
+         */
+        void endLockdown(GroupId group);
+
+        /**
+         * @brief Checks if a client is blocked by a global or group lockdown.
+         * @param client_id The unique identifier of the client.
+         * @return `true` if the client is locked down, `false` otherwise.
+         */
+        [[nodiscard]] bool isLockedDown(int client_id) const;
+
+        /**
+         * @brief Issues a session token to a logged-in client.
+         *
+         * Replaces any token the client already had.
+         *
+         * @param client_id The unique identifier of the client.
+         * @return The token, or an empty string if the client is not authorized.
+         */
+        std::string issueSessionToken(int client_id);
+
+        /**
+         * @brief Authenticates a client by session token.
+         *
+         * Succeeds if the token has not expired and the client it was issued to is not
+         * blocked. The client is then marked as logged in, as after `authenticate`.
+         *
+         * A hub that reconnects gets a new connection ID. When the token was issued to
+         * another ID, the session, the credentials and the authorization move to
+         * `client_id`, and the old ID is no longer authorized. The move is refused if
+         * `client_id` already has credentials of its own.
+         *
+         * @param client_id The connection presenting the token.
+         * @param token The token presented by the client.
+         * @return `true` if the token is valid, `false` otherwise.
+         */
+        bool validateSessionToken(int client_id, const std::string& token);
+
+        /**
+         * @brief Revokes the session token of a client, if it has one.
+         * @param client_id The unique identifier of the client.
+         */
+        void revokeSessionToken(int client_id);
+
+        /**
+         * @brief Gets the lifetime of issued session tokens.
+         * @return The token lifetime.
+         */
+        [[nodiscard]] std::chrono::milliseconds getSessionTokenTtl() const;
+
+        /**
+         * @brief Gets the number of password hashes computed to verify logins.
+         *
+         * Logins answered from the verification cache do not count.
+         *
+         * @return The number of KDF evaluations.
+         */
+        [[nodiscard]] std::size_t getKdfEvaluations() const;
+
+        /**
+         * @brief Gets the number of login attempts refused by the rate limits.
+         * @return The number of throttled attempts.
+         */
+        [[nodiscard]] std::size_t getThrottledLogins() const;
 
     private:
         /**
@@ -147,18 +394,178 @@ class Authentication {
             int failedAttempts; /**< Number of consecutive failed login attempts. */
             bool isBlocked; /**< Indicates if the client is blocked. */
             bool emergencyBlocked; /**< Indicates if the client is blocked due to an emergency. */
+            GroupId group = 0; /**< Lockdown group of the client. */
+            std::uint64_t unlockedEpoch = 0; /**< Lockdown epoch at which the client last unlocked with the secret phrase. */
+            bool fromDatabase = false; /**< Whether the password hash came from the credential database. */
+            int accountID = 0; /**< Database ID of the client, which a resumed session may have moved to another connection ID. */
+            std::uint64_t generation = 0; /**< Database generation the client was last reconciled with. */
+        };
+
+        /**
+         * @struct VerifiedLogin
+         * @brief A recent successful password verification.
+         */
+        struct VerifiedLogin {
+            Crypto::Sha256Digest tag; /**< HMAC of the client ID, stored hash and password. */
+            std::chrono::steady_clock::time_point expiresAt; /**< When the entry stops being accepted. */
+            std::uint64_t epoch; /**< Lockdown epoch when the entry was made. */
         };
 
+        /**
+         * @struct LockdownScope
+         * @brief Lockdown state of all clients or of one group.
+         */
+        struct LockdownScope {
+            std::atomic<std::uint64_t> active{0}; /**< Epoch of the lockdown in force, or 0 if none. */
+            std::atomic<std::uint64_t> latest{0}; /**< Epoch of the most recent lockdown, even if ended. */
+        };
+
+        /**
+         * @brief A block of published client states, one per status slot.
+         *
+         * Each entry packs the authorized flag, the group, the high bits of the client ID
+         * and the unlock epoch; see `publishStatus`.
+         */
+        using StatusChunk = std::array<std::atomic<std::uint64_t>, AuthenticationConstants::STATUS_CHUNK_SIZE>;
+
         std::map<int, AuthData> credentials; /**< Map of client IDs to their authentication data. */
-        std::string emergencySecretPhrase = "defaultSecret"; /**< Predefined secret phrase for emergency unlock. */ // TODO: Implement in a config file
+        mutable std::mutex writeMutex; /**< Serializes changes to credentials, caches and sessions. */
+        std::array<std::atomic<StatusChunk*>, AuthenticationConstants::STATUS_CHUNKS> statusChunks{}; /**< Published authorization flags. */
+        std::array<std::unique_ptr<StatusChunk>, AuthenticationConstants::STATUS_CHUNKS> ownedChunks; /**< Owners of the allocated chunks. */
+        std::atomic<std::uint64_t> lockdownEpoch{0}; /**< Number of the most recent lockdown epoch. */
+        LockdownScope globalLockdown; /**< Lockdown of all clients. */
+        std::array<LockdownScope, AuthenticationConstants::LOCKDOWN_GROUPS> groupLockdowns; /**< Lockdowns of each group. */
+        Config config; /**< Hashing and cache settings. */
+        Crypto::HmacSha256 verificationKey; /**< Random per-instance key for verification tags. */
+        /**
+         * @struct Session
+         * @brief A live session token.
+         */
+        struct Session {
+            int clientID; /**< Client the token was issued to. */
+            std::chrono::steady_clock::time_point expiresAt; /**< When the token stops being accepted. */
+            std::uint64_t epoch; /**< Lockdown epoch when the token was issued. */
+        };
+
+        std::unordered_map<int, VerifiedLogin> verifiedLogins; /**< Recent verifications, by client ID. */
+        std::unordered_map<std::string, Session> sessions; /**< Live session tokens. */
+        std::unordered_map<int, std::string> sessionByClient; /**< Token of each client that has one. */
+        std::atomic<std::size_t> kdfEvaluations; /**< Number of KDF evaluations done to verify logins. */
+        RateLimiter clientLoginLimiter; /**< Login buckets by client ID. */
+        RateLimiter sourceLoginLimiter; /**< Login buckets by source address. */
+        std::atomic<std::size_t> throttledLogins{0}; /**< Number of attempts refused by the limiters. */
+        std::atomic<std::shared_ptr<const CredentialDatabase>> database; /**< Loaded credential database, if any. */
+        std::uint64_t databaseGeneration = 0; /**< Number of database swaps; guarded by `writeMutex`. */
+        std::unordered_set<int> removedClients; /**< Database clients removed at runtime; guarded by `writeMutex`. */
 
         /**
          * @brief Hashes a plaintext password.
          *
-         * Converts a plaintext password into a hashed string for secure storage.
+         * Derives a PBKDF2-HMAC-SHA-256 key with a fresh random salt and encodes it as
+         * "pbkdf2-sha256$<iterations>$<salt hex>$<hash hex>".
          *
          * @param password The plaintext password to hash.
          * @return The hashed password as a string.
          */
         [[nodiscard]] std::string hashPassword(const std::string& password) const;
+
+        /**
+         * @brief Encodes a database entry in the stored hash format.
+         * @param entry The entry.
+         * @return The hashed password as a string.
+         */
+        [[nodiscard]] static std::string encodeHash(const CredentialDatabase::Entry& entry);
+
+        /**
+         * @brief Finds a client's data, creating it from the credential database if needed.
+         *
+         * A client from an older database generation is reconciled first, and clients
+         * removed with `removeCredentials` are not created again.
+         *
+         * Requires `writeMutex` to be held.
+         *
+         * @param client_id The client ID.
+         * @return An iterator to the client's data, or `credentials.end()` if the client is unknown.
+         */
+        std::map<int, AuthData>::iterator findCredentials(int client_id);
+
+        /**
+         * @brief Brings a database client up to date with the current database generation.
+         *
+         * Removes the client if it is no longer in the database; otherwise updates its
+         * group and, if its password changed, logs it out. Other clients are left alone.
+         *
+         * Requires `writeMutex` to be held.
+         *
+         * @param it The client's data.
+         * @return `it`, or `credentials.end()` if the client was removed.
+         */
+        std::map<int, AuthData>::iterator reconcile(std::map<int, AuthData>::iterator it);
+
+        /**
+         * @brief Checks a plaintext password against a stored hash.
+         *
+         * Uses the iteration count and salt recorded in the hash, so hashes made with
+         * other settings still verify.
+         *
+         * @param password The plaintext password.
+         * @param hashedPassword The stored hash.
+         * @return `true` if the password matches, `false` otherwise or if the hash is malformed.
+         */
+        bool verifyPassword(const std::string& password, const std::string& hashedPassword);
+
+        /**
+         * @brief Computes the verification cache tag of a login attempt.
+         * @param client_id The client ID.
+         * @param hashedPassword The stored hash.
+         * @param password The plaintext password presented.
+         * @return The tag.
+         */
+        [[nodiscard]] Crypto::Sha256Digest verificationTag(int client_id, const std::string& hashedPassword,
+                                                            const std::string& password) const;
+
+        /**
+         * @brief Checks if a login matches an unexpired cached verification.
+         * @param client_id The client ID.
+         * @param tag The tag of the login attempt.
+         * @return `true` if the login was verified recently with the same password.
+         */
+        [[nodiscard]] bool hasVerifiedLogin(int client_id, const Crypto::Sha256Digest& tag) const;
+
+        /**
+         * @brief Publishes the authorization of a client to the lock-free table.
+         *
+         * Client IDs whose low `STATUS_SLOT_BITS` bits match share a slot. The entry holds
+         * the rest of the ID, so readers of the other IDs fall back to the locked map; an
+         * authorized client is not displaced by another ID of the slot that is not,
+         * unless `claimSlot` is set.
+         *
+         * Must be called with `writeMutex` held after any change to the client's data.
+         *
+         * @param client_id The client ID.
+         * @param claimSlot Whether the ID replaces the slot's entry whatever it holds.
+         */
+        void publishStatus(int client_id, bool claimSlot = false);
+
+        /**
+         * @brief Checks if a client is locked down.
+         * @param group The client's group.
+         * @param unlockedEpoch The epoch at which the client last unlocked.
+         * @return `true` if a global or group lockdown newer than `unlockedEpoch` is active.
+         */
+        [[nodiscard]] bool isLockedDown(GroupId group, std::uint64_t unlockedEpoch) const;
+
+        /**
+         * @brief Checks if credentials made in an epoch survived the client's lockdowns.
+         * @param group The client's group.
+         * @param epoch The epoch the cache entry or token was made in.
+         * @return `true` if no lockdown of the client started after `epoch`.
+         */
+        [[nodiscard]] bool survivesLockdowns(GroupId group, std::uint64_t epoch) const;
+
+        /**
+         * @brief Revokes a session token. Requires `writeMutex` to be held.
+         * @param client_id The client ID.
+         */
+        void revokeSessionTokenLocked(int client_id);
 };
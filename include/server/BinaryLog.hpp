@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @namespace BinaryLog
+ * @brief Layout of the binary log format written by `EventLogger` and read by `LogDecoder`.
+ *
+ * A binary log is a sequence of records, each made of a one-byte kind, a four-byte
+ * payload length and the payload. Integers are stored in host byte order. Every
+ * logger session starts with a SESSION record, after which components and formats
+ * are defined once and events refer to them by ID:
+ *
+ * - SESSION:   magic "EVLG", uint16 version.
+ * - COMPONENT: uint16 ID, name bytes.
+ * - FORMAT:    uint16 ID, pattern bytes. "{}" in the pattern is replaced by the next argument.
+ * - EVENT:     uint16 component ID, uint8 level, int64 nanoseconds since the epoch,
+ *              uint16 format ID, uint8 argument count, then the encoded arguments.
+ *
+ * Each argument is a one-byte type followed by its value: INT64 and DOUBLE take
+ * eight bytes, STRING takes a uint32 length and the bytes.
+ */
+namespace BinaryLog {
+    constexpr char MAGIC[4] = {'E', 'V', 'L', 'G'}; /**< Identifies a binary log session. */
+    constexpr std::uint16_t VERSION = 2; /**< Version of the record layout. */
+    constexpr std::size_t RECORD_HEADER_SIZE = 5; /**< Kind byte plus payload length. */
+    constexpr std::size_t EVENT_FIXED_SIZE = 14; /**< Size of an event payload without its arguments. */
+    constexpr std::uint16_t MESSAGE_FORMAT_ID = 0; /**< Format "{}", used for plain text messages. */
+    constexpr std::size_t MAX_ARGUMENTS = 255; /**< Maximum number of arguments of an event. */
+
+    /**
+     * @enum RecordKind
+     * @brief Kind of a record in the binary log.
+     */
+    enum class RecordKind : std::uint8_t {
+        SESSION = 1,
+        COMPONENT = 2,
+        FORMAT = 3,
+        EVENT = 4
+    };
+
+    /**
+     * @enum ArgType
+     * @brief Type tag of an encoded event argument.
+     */
+    enum class ArgType : std::uint8_t {
+        INT64 = 1,
+        DOUBLE = 2,
+        STRING = 3
+    };
+
+    /**
+     * @brief Appends the raw bytes of a trivially copyable value.
+     */
+    template <typename T>
+    void appendRaw(std::string& out, T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+
+    /**
+     * @brief Reads a trivially copyable value and advances the input.
+     * @return `true` if the input held enough bytes, `false` otherwise.
+     */
+    template <typename T>
+    bool readRaw(std::string_view& in, T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (in.size() < sizeof(T)) return false;
+        std::memcpy(&value, in.data(), sizeof(T));
+        in.remove_prefix(sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Appends a record header.
+     * @param out The buffer to append to.
+     * @param kind The kind of the record.
+     * @param payloadSize The number of payload bytes that follow.
+     */
+    inline void appendRecordHeader(std::string& out, RecordKind kind, std::size_t payloadSize) {
+        appendRaw(out, static_cast<std::uint8_t>(kind));
+        appendRaw(out, static_cast<std::uint32_t>(payloadSize));
+    }
+
+    /**
+     * @brief Encodes an event argument.
+     *
+     * Integers are stored as INT64, floating point values as DOUBLE and anything
+     * convertible to `std::string_view` as STRING.
+     *
+     * @param out The buffer to append to.
+     * @param value The argument.
+     */
+    template <typename T>
+    void appendArg(std::string& out, const T& value) {
+        if constexpr (std::is_integral_v<T>) {
+            appendRaw(out, ArgType::INT64);
+            appendRaw(out, static_cast<std::int64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            appendRaw(out, ArgType::DOUBLE);
+            appendRaw(out, static_cast<double>(value));
+        } else {
+            const std::string_view text(value);
+            appendRaw(out, ArgType::STRING);
+            appendRaw(out, static_cast<std::uint32_t>(text.size()));
+            out.append(text);
+        }
+    }
+
+    /**
+     * @brief Renders a format pattern with its encoded arguments.
+     *
+     * Each "{}" in the pattern is replaced by the next argument. Placeholders without
+     * an argument are kept as they are, and arguments without a placeholder are ignored.
+     *
+     * @param pattern The format pattern.
+     * @param args The encoded arguments.
+     * @param argc The number of encoded arguments.
+     * @param out Receives the rendered message; appended to.
+     * @return `true` if the arguments were well formed, `false` otherwise.
+     */
+    bool renderMessage(std::string_view pattern, std::string_view args, std::size_t argc, std::string& out);
+}
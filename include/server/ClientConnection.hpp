@@ -1,14 +1,24 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <deque>
 #include <netinet/in.h>
 #include <string>
+#include <sys/uio.h>
+#include "Message.hpp"
+
+namespace ClientConnectionConstants {
+    constexpr std::size_t DEFAULT_OUTBOUND_HIGH_WATER_MARK = 1024 * 1024; /**< Default limit of queued outbound bytes. */
+}
 
 /**
  * @brief Represents a client's connection to the server.
  *
  * This class encapsulates the details of a client's connection, including
  * its unique identifier, socket information, address, and protocol type.
- * It also tracks the connection status of the client.
+ * It also tracks the connection status of the client, the time it was last
+ * heard from, and owns the queue of serialized messages waiting to be written to it.
  */
 class ClientConnection {
     public:
@@ -47,7 +57,7 @@ class ClientConnection {
          * @brief Gets the address information of the client.
          * @return The client's address as a `sockaddr_storage` object.
          */
-        [[nodiscard]] sockaddr_storage getAddress() const;
+        [[nodiscard]] const sockaddr_storage& getAddress() const;
 
         /**
          * @brief Gets the length of the client's address.
@@ -74,6 +84,99 @@ class ClientConnection {
          */
         void disconnect();
 
+        /**
+         * @brief Records that data was received from the client.
+         * @param now The time the data arrived.
+         */
+        void touch(std::chrono::steady_clock::time_point now);
+
+        /**
+         * @brief Gets the time the client was last heard from.
+         * @return The time of the last `touch`, or the creation time if it was never touched.
+         */
+        [[nodiscard]] std::chrono::steady_clock::time_point getLastActivity() const;
+
+        /**
+         * @brief Appends a serialized message to the outbound queue.
+         *
+         * The buffer is shared, not copied, so the same payload can be queued on many connections.
+         *
+         * @param payload The serialized message to send.
+         */
+        void queueOutbound(SharedPayload payload);
+
+        /**
+         * @brief Checks if there are queued bytes waiting to be written.
+         * @return `true` if the outbound queue is not empty, `false` otherwise.
+         */
+        [[nodiscard]] bool hasPendingOutput() const;
+
+        /**
+         * @brief Gets the number of messages waiting in the outbound queue.
+         * @return The number of queued messages, including a partially written one.
+         */
+        [[nodiscard]] std::size_t getPendingOutputCount() const;
+
+        /**
+         * @brief Gets the number of bytes waiting in the outbound queue.
+         * @return The number of queued bytes not yet written.
+         */
+        [[nodiscard]] std::size_t getPendingOutputBytes() const;
+
+        /**
+         * @brief Gets the limit of queued outbound bytes for this connection.
+         * @return The high-water mark, in bytes.
+         */
+        [[nodiscard]] std::size_t getHighWaterMark() const;
+
+        /**
+         * @brief Sets the limit of queued outbound bytes for this connection.
+         * @param bytes The new high-water mark, in bytes.
+         */
+        void setHighWaterMark(std::size_t bytes);
+
+        /**
+         * @brief Checks if queuing more bytes would exceed the high-water mark.
+         * @param additionalBytes The number of bytes about to be queued.
+         * @return `true` if the queue would grow past the high-water mark, `false` otherwise.
+         */
+        [[nodiscard]] bool wouldExceedHighWaterMark(std::size_t additionalBytes) const;
+
+        /**
+         * @brief Describes the queued output as an I/O vector for `writev`/`sendmmsg`.
+         *
+         * The first entry starts after the bytes of the front message already written.
+         *
+         * @param iov Array receiving the buffer descriptions.
+         * @param maxEntries Capacity of `iov`.
+         * @return The number of entries filled.
+         */
+        std::size_t fillOutboundIov(iovec* iov, std::size_t maxEntries) const;
+
+        /**
+         * @brief Gets a queued message, to keep its buffer alive during an asynchronous write.
+         * @param index The position in the outbound queue, below `getPendingOutputCount()`.
+         * @return The serialized message.
+         */
+        [[nodiscard]] SharedPayload getOutboundAt(std::size_t index) const;
+
+        /**
+         * @brief Marks bytes of the outbound queue as written (stream sockets).
+         *
+         * Fully written messages are released; a partially written front message
+         * keeps its progress so the next write resumes where this one stopped.
+         *
+         * @param bytes The number of bytes the socket accepted.
+         */
+        void consumeOutboundBytes(std::size_t bytes);
+
+        /**
+         * @brief Releases whole messages from the front of the outbound queue (datagram sockets).
+         *
+         * @param count The number of messages that were sent.
+         */
+        void consumeOutboundMessages(std::size_t count);
+
     private:
         int clientID; ///< Unique identifier for the client.
         int socket; ///< Socket descriptor for the client's connection.
@@ -81,4 +184,9 @@ class ClientConnection {
         socklen_t addressLength; ///< Length of the client's address.
         Protocol protocol; ///< Protocol type used by the client (TCP or UDP).
         bool connected; ///< Indicates whether the client is currently connected.
+        std::chrono::steady_clock::time_point lastActivity; ///< When data was last received from the client.
+        std::deque<SharedPayload> outbound; ///< Serialized messages waiting to be written.
+        std::size_t outboundOffset = 0; ///< Bytes of the front message already written.
+        std::size_t outboundBytes = 0; ///< Bytes queued and not yet written.
+        std::size_t highWaterMark = ClientConnectionConstants::DEFAULT_OUTBOUND_HIGH_WATER_MARK; ///< Limit of queued outbound bytes.
 };
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "ClientConnection.hpp"
+
+namespace ConnectionTableConstants {
+    constexpr int INDEX_BITS = 16; /**< Low bits of a client ID holding the slot number. */
+    constexpr std::size_t MAX_CONNECTIONS = (std::size_t{1} << INDEX_BITS) - 1; /**< Slots a table can hold. */
+    constexpr std::uint32_t MAX_GENERATION = (std::uint32_t{1} << (31 - INDEX_BITS)) - 1; /**< Generations before a slot's IDs repeat. */
+}
+
+/**
+ * @class ConnectionTable
+ * @brief Slab of client connections addressed by generation-tagged client IDs.
+ *
+ * A client ID holds the slot number plus one in its low `INDEX_BITS` bits and the
+ * slot's generation above them, so a lookup is an index and a generation compare.
+ * Closed slots go on a free list and are reused first; their generation is bumped so
+ * the IDs of closed connections no longer resolve and are not handed out again for
+ * `MAX_GENERATION` reuses of the slot. The first connection gets ID 1.
+ *
+ * Slots live in a `std::deque`, so connections never move: pointers and references
+ * returned by `find` stay valid until that connection is erased.
+ */
+class ConnectionTable {
+    public:
+        /**
+         * @brief Adds a connection in a free slot.
+         *
+         * @param sock Socket descriptor of the connection.
+         * @param addr Address of the client.
+         * @param len Length of the client's address.
+         * @param proto Protocol of the connection.
+         * @return The new client ID, or -1 if the table is full.
+         */
+        int emplace(int sock, const sockaddr_storage& addr, socklen_t len, ClientConnection::Protocol proto);
+
+        /**
+         * @brief Looks up a connection.
+         * @param clientID The client ID.
+         * @return The connection, or `nullptr` if the ID is not open.
+         */
+        ClientConnection* find(int clientID);
+
+        /**
+         * @brief Looks up a connection.
+         * @param clientID The client ID.
+         * @return The connection, or `nullptr` if the ID is not open.
+         */
+        [[nodiscard]] const ClientConnection* find(int clientID) const;
+
+        /**
+         * @brief Checks if a client ID is open.
+         * @param clientID The client ID.
+         * @return `true` if the ID refers to a connection in the table.
+         */
+        [[nodiscard]] bool contains(int clientID) const;
+
+        /**
+         * @brief Removes a connection and frees its slot.
+         * @param clientID The client ID.
+         * @return `true` if the connection was removed, `false` if the ID was not open.
+         */
+        bool erase(int clientID);
+
+        /**
+         * @brief Gets the number of open connections.
+         * @return The number of connections.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * @brief Calls a function for every open connection, in slot order.
+         *
+         * The function must not add or erase connections.
+         *
+         * @param visit Called with each `ClientConnection&`.
+         */
+        template<typename Visitor>
+        void forEach(Visitor&& visit) {
+            for (Slot& slot : slots) {
+                if (slot.connection) visit(*slot.connection);
+            }
+        }
+
+    private:
+        /**
+         * @struct Slot
+         * @brief One entry of the slab.
+         */
+        struct Slot {
+            std::optional<ClientConnection> connection; ///< The connection, if the slot is in use.
+            std::uint32_t generation = 0; ///< Bumped each time the slot is freed.
+        };
+
+        /**
+         * @brief Resolves a client ID to its slot.
+         * @param clientID The client ID.
+         * @return The slot number, or `std::nullopt` if the ID is not open.
+         */
+        [[nodiscard]] std::optional<std::size_t> slotOf(int clientID) const;
+
+        std::deque<Slot> slots; ///< The slab; grows but never shrinks.
+        std::vector<std::size_t> freeSlots; ///< Slots available for reuse.
+        std::size_t count = 0; ///< Number of open connections.
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CredentialDatabaseConstants {
+    constexpr char MAGIC[4] = {'C', 'R', 'D', 'B'}; /**< First bytes of a credential database file. */
+    constexpr std::uint16_t VERSION = 1; /**< File format version. */
+    constexpr std::size_t SALT_BYTES = 16; /**< Salt stored with each hash. */
+    constexpr std::size_t HASH_BYTES = 32; /**< PBKDF2-HMAC-SHA-256 output stored for each hash. */
+}
+
+/**
+ * @class CredentialDatabase
+ * @brief Read-only credential file mapped into memory.
+ *
+ * The file is a 64-byte header holding the entry count and the PBKDF2 hash of the
+ * emergency secret phrase, followed by 64-byte entries sorted by client ID, each with
+ * the client's PBKDF2 iterations, salt, hash and lockdown group. Integers are in host
+ * byte order. The file is mapped read-only and looked up in place by binary search,
+ * so opening a database of any size costs one `mmap` and no parsing.
+ *
+ * Instances are immutable and can be shared between threads. `write` replaces a file
+ * atomically, so a database can be regenerated while the server has the old one open.
+ */
+class CredentialDatabase {
+    public:
+        /**
+         * @struct Entry
+         * @brief Stored credentials of one client.
+         */
+        struct Entry {
+            int clientID; /**< The client the entry belongs to. */
+            std::uint32_t iterations; /**< PBKDF2 iterations of the hash. */
+            std::array<std::uint8_t, CredentialDatabaseConstants::SALT_BYTES> salt; /**< Salt of the hash. */
+            std::array<std::uint8_t, CredentialDatabaseConstants::HASH_BYTES> hash; /**< PBKDF2-HMAC-SHA-256 of the password. */
+            std::uint8_t group; /**< Lockdown group of the client. */
+        };
+
+        /**
+         * @brief Opens and maps a database file.
+         *
+         * @param path The path of the file.
+         * @throws std::runtime_error If the file cannot be opened or mapped, or is not a valid database.
+         */
+        explicit CredentialDatabase(const std::string& path);
+
+        /**
+         * @brief Unmaps the file.
+         */
+        ~CredentialDatabase();
+
+        CredentialDatabase(const CredentialDatabase&) = delete;
+        CredentialDatabase& operator=(const CredentialDatabase&) = delete;
+
+        /**
+         * @brief Looks up the entry of a client.
+         * @param clientID The client ID.
+         * @return The entry, or `std::nullopt` if the client is not in the database.
+         */
+        [[nodiscard]] std::optional<Entry> find(int clientID) const;
+
+        /**
+         * @brief Gets the number of entries.
+         * @return The number of clients in the database.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * @brief Checks if the database holds an emergency secret phrase.
+         * @return `true` if a phrase hash is stored.
+         */
+        [[nodiscard]] bool hasSecretPhrase() const;
+
+        /**
+         * @brief Checks a phrase against the stored emergency secret phrase.
+         * @param phrase The phrase to check.
+         * @return `true` if a phrase is stored and matches.
+         */
+        [[nodiscard]] bool verifySecretPhrase(const std::string& phrase) const;
+
+        /**
+         * @brief Hashes a password into a new entry with a random salt.
+         *
+         * @param clientID The client ID.
+         * @param password The plaintext password.
+         * @param iterations The PBKDF2 iteration count.
+         * @param group The lockdown group.
+         * @return The entry.
+         */
+        static Entry makeEntry(int clientID, const std::string& password, std::uint32_t iterations, std::uint8_t group = 0);
+
+        /**
+         * @brief Writes a database file.
+         *
+         * The file is written next to `path` and renamed over it, so readers see either
+         * the old or the new database.
+         *
+         * @param path The path of the file.
+         * @param entries The entries, in any order. Client IDs must be unique.
+         * @param secretPhrase The emergency secret phrase, or an empty string to store none.
+         * @param iterations The PBKDF2 iteration count for the phrase hash.
+         * @throws std::invalid_argument If a client ID appears twice.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        static void write(const std::string& path, std::vector<Entry> entries, const std::string& secretPhrase,
+                          std::uint32_t iterations);
+
+    private:
+        const unsigned char* mapped; /**< Start of the mapping. */
+        std::size_t mappedBytes; /**< Size of the mapping. */
+        std::size_t entryCount; /**< Number of entries. */
+
+        /**
+         * @brief Reads the entry at a position.
+         * @param index The position, below `entryCount`.
+         * @return The entry.
+         */
+        [[nodiscard]] Entry entryAt(std::size_t index) const;
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @namespace Crypto
+ * @brief Hashing primitives used for credential storage.
+ *
+ * Self-contained SHA-256, HMAC-SHA-256 and PBKDF2-HMAC-SHA-256, plus helpers for
+ * random salts, hex encoding and constant-time comparison. Binary values are
+ * carried in `std::string`.
+ */
+namespace Crypto {
+    constexpr std::size_t SHA256_DIGEST_BYTES = 32; /**< Size of a SHA-256 digest. */
+    constexpr std::size_t SHA256_BLOCK_BYTES = 64; /**< Size of a SHA-256 input block. */
+
+    using Sha256Digest = std::array<std::uint8_t, SHA256_DIGEST_BYTES>; ///< A SHA-256 digest.
+
+    /**
+     * @class Sha256
+     * @brief Incremental SHA-256 hasher.
+     *
+     * Copyable, so a state after a common prefix can be reused.
+     */
+    class Sha256 {
+        public:
+            Sha256();
+
+            /**
+             * @brief Adds data to the hash.
+             * @param data The bytes to add.
+             * @param length The number of bytes.
+             */
+            void update(const void* data, std::size_t length);
+
+            /**
+             * @brief Adds data to the hash.
+             * @param data The bytes to add.
+             */
+            void update(std::string_view data);
+
+            /**
+             * @brief Completes the hash.
+             *
+             * The hasher must not be updated afterwards.
+             *
+             * @return The digest.
+             */
+            Sha256Digest finish();
+
+            /**
+             * @brief Hashes a digest-sized message on top of the current state.
+             *
+             * Equivalent to copying the hasher, adding `data` and finishing, but pads and
+             * compresses a single block directly. Requires the bytes hashed so far to be a
+             * whole number of blocks, as in the HMAC key states.
+             *
+             * @param data The message.
+             * @return The digest.
+             */
+            [[nodiscard]] Sha256Digest finishWith(const Sha256Digest& data) const;
+
+        private:
+            /**
+             * @brief Processes one 64-byte block.
+             * @param block The block.
+             */
+            void compress(const std::uint8_t* block);
+
+            std::array<std::uint32_t, 8> state; ///< Current hash state.
+            std::array<std::uint8_t, SHA256_BLOCK_BYTES> buffer; ///< Bytes of an incomplete block.
+            std::size_t buffered; ///< Number of bytes in `buffer`.
+            std::uint64_t totalBytes; ///< Number of bytes hashed so far.
+    };
+
+    /**
+     * @class HmacSha256
+     * @brief HMAC-SHA-256 with a fixed key.
+     *
+     * The key is absorbed once into the inner and outer hash states, so each MAC only
+     * costs the hashing of the message.
+     */
+    class HmacSha256 {
+        public:
+            /**
+             * @brief Prepares the hash states for a key.
+             * @param key The key.
+             */
+            explicit HmacSha256(std::string_view key);
+
+            /**
+             * @brief Computes the MAC of a message.
+             * @param data The message bytes.
+             * @param length The number of bytes.
+             * @return The MAC.
+             */
+            [[nodiscard]] Sha256Digest compute(const void* data, std::size_t length) const;
+
+            /**
+             * @brief Computes the MAC of a message.
+             * @param data The message.
+             * @return The MAC.
+             */
+            [[nodiscard]] Sha256Digest compute(std::string_view data) const;
+
+            /**
+             * @brief Computes the MAC of a digest, as in the PBKDF2 iteration.
+             * @param data The message.
+             * @return The MAC.
+             */
+            [[nodiscard]] Sha256Digest compute(const Sha256Digest& data) const;
+
+        private:
+            Sha256 inner; ///< State after absorbing the key XOR ipad.
+            Sha256 outer; ///< State after absorbing the key XOR opad.
+    };
+
+    /**
+     * @brief Computes the SHA-256 digest of data.
+     * @param data The data.
+     * @return The digest.
+     */
+    Sha256Digest sha256(std::string_view data);
+
+    /**
+     * @brief Derives a key with PBKDF2-HMAC-SHA-256 (RFC 8018).
+     * @param password The password.
+     * @param salt The salt.
+     * @param iterations The iteration count.
+     * @param length The number of bytes to derive.
+     * @return The derived key.
+     */
+    std::string pbkdf2Sha256(std::string_view password, std::string_view salt, std::uint32_t iterations, std::size_t length);
+
+    /**
+     * @brief Generates cryptographically secure random bytes.
+     * @param count The number of bytes.
+     * @return The random bytes.
+     * @throws std::runtime_error If the kernel random source fails.
+     */
+    std::string randomBytes(std::size_t count);
+
+    /**
+     * @brief Encodes bytes as lowercase hexadecimal.
+     * @param data The bytes.
+     * @return The hex string.
+     */
+    std::string toHex(std::string_view data);
+
+    /**
+     * @brief Decodes a hexadecimal string.
+     * @param hex The hex string.
+     * @param out Receives the bytes.
+     * @return `true` if the string was valid hex, `false` otherwise.
+     */
+    bool fromHex(std::string_view hex, std::string& out);
+
+    /**
+     * @brief Compares two byte strings in time independent of where they differ.
+     * @param a The first string.
+     * @param b The second string.
+     * @return `true` if they are equal.
+     */
+    bool constantTimeEquals(std::string_view a, std::string_view b);
+}
@@ -1,14 +1,57 @@
 #pragma once
 
+#include "BinaryLog.hpp"
+#include "RotatingLogFile.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <fstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace EventLoggerConstants {
+    constexpr std::size_t DEFAULT_RING_CAPACITY = 8192; /**< Default number of records the ring buffer holds. Power of two. */
+    constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{50}; /**< Default time between writer batches. */
+    constexpr std::size_t WRITE_BATCH_BYTES = 64 * 1024; /**< Size at which the writer issues a `write()` without waiting for more records. */
+    constexpr std::size_t MAX_COMPONENTS = 65536; /**< Number of component IDs, one per `ComponentId` value. */
+    constexpr std::uint8_t INHERIT_LEVEL = 0xFF; /**< Component filter value meaning "use the global level". */
+}
 
 /**
  * @class EventLogger
  * @brief A utility class for logging events to a file with timestamps and log levels.
  *
  * The `EventLogger` class provides functionality to log messages with a timestamp,
- * component name, and log level (INFO, WARNING, or ERROR) to a specified log file.
+ * component name, and log level (DEBUG, INFO, WARNING, or ERROR) to a specified log file.
+ *
+ * Logging is asynchronous: `logEvent` formats the record and appends it to a lock-free
+ * ring buffer, and a dedicated writer thread collects records into large batches that
+ * are written with a single `write()`. The caller never touches the file. `flush`
+ * waits until everything logged so far is in the file, and the destructor flushes
+ * before closing it.
+ *
+ * In `Format::BINARY` mode records are written in the `BinaryLog` layout instead of as
+ * text: components and format patterns are registered once and events only carry their
+ * IDs, the level, a raw timestamp and the raw arguments, leaving all formatting to the
+ * offline `LogDecoder`.
+ *
+ * When `Config::rotateBytes` or `Config::rotateInterval` is set, the log is written through
+ * a `RotatingLogFile` instead: pre-allocated, memory-mapped segments that are rotated by
+ * size or age, keeping `Config::keepSegments` old segments. In binary mode each segment
+ * starts with the session and definition records, so it can be decoded on its own.
+ *
+ * Events below the global level, or below the level set for their component, are dropped
+ * before anything is formatted. The levels are atomics read with relaxed loads, so they can
+ * be changed at runtime, including from a signal handler (see `enableSignalControl`).
+ * The `LOG_EVENT` and `LOG_MESSAGE` macros check the filter before evaluating their
+ * arguments, which makes disabled DEBUG tracing cost a load and a compare.
  */
 class EventLogger {
     public:
@@ -16,13 +59,50 @@ class EventLogger {
          * @enum LogLevel
          * @brief Represents the severity level of a log message.
          */
-        enum LogLevel { INFO, WARNING, ERROR };
-    
+        enum LogLevel { DEBUG, INFO, WARNING, ERROR };
+
+        /**
+         * @enum TimestampPrecision
+         * @brief Fractional-second digits appended to each timestamp.
+         */
+        enum class TimestampPrecision {
+            SECONDS,      ///< "YYYY-MM-DD HH:MM:SS"
+            MILLISECONDS, ///< "YYYY-MM-DD HH:MM:SS.mmm"
+            MICROSECONDS  ///< "YYYY-MM-DD HH:MM:SS.uuuuuu"
+        };
+
+        /**
+         * @enum Format
+         * @brief Encoding of the records written to the log file.
+         */
+        enum class Format {
+            TEXT,  ///< Human-readable lines.
+            BINARY ///< `BinaryLog` records, rendered by `LogDecoder`.
+        };
+
+        using ComponentId = std::uint16_t; ///< ID of a registered component.
+        using FormatId = std::uint16_t; ///< ID of a registered format pattern.
+
+        /**
+         * @struct Config
+         * @brief Tuning parameters of the asynchronous writer.
+         */
+        struct Config {
+            std::size_t ringCapacity = EventLoggerConstants::DEFAULT_RING_CAPACITY; /**< Records the ring buffer holds; rounded up to a power of two. */
+            std::chrono::milliseconds flushInterval = EventLoggerConstants::DEFAULT_FLUSH_INTERVAL; /**< Maximum time a record waits before being written. */
+            TimestampPrecision precision = TimestampPrecision::SECONDS; /**< Sub-second precision of timestamps. */
+            Format format = Format::TEXT; /**< Encoding of the log file. */
+            LogLevel level = INFO; /**< Minimum level logged, restored by SIGUSR2 under signal control. */
+            std::size_t rotateBytes = 0; /**< Segment size for rotation; zero with no interval appends to one file. */
+            std::chrono::milliseconds rotateInterval{0}; /**< Segment age for rotation; zero disables time-based rotation. */
+            std::size_t keepSegments = RotatingLogFileConstants::DEFAULT_KEEP_SEGMENTS; /**< Rotated segments kept on disk. */
+        };
+
         /**
          * @brief Constructs an EventLogger object.
          *
-         * Opens the specified log file for appending log messages. If no file path
-         * is provided, it defaults to "logs/system.log".
+         * Opens the specified log file for appending log messages and starts the writer
+         * thread. If no file path is provided, it defaults to "logs/system.log".
          *
          * @param logFilePath The path to the log file. Defaults to "logs/system.log".
          * @throws std::runtime_error If the log file cannot be opened.
@@ -30,17 +110,30 @@ class EventLogger {
         explicit EventLogger(const std::string& logFilePath = "logs/system.log");
 
         /**
-             * @brief Destroys the EventLogger object.
-             *
-             * Closes the log file if it is open.
-             */
+         * @brief Constructs an EventLogger object with a custom writer configuration.
+         *
+         * @param logFilePath The path to the log file.
+         * @param config The writer configuration.
+         * @throws std::runtime_error If the log file cannot be opened.
+         */
+        EventLogger(const std::string& logFilePath, const Config& config);
+
+        /**
+         * @brief Destroys the EventLogger object.
+         *
+         * Writes every pending record, stops the writer thread and closes the log file.
+         */
         ~EventLogger();
 
+        EventLogger(const EventLogger&) = delete;
+        EventLogger& operator=(const EventLogger&) = delete;
+
         /**
          * @brief Logs an event to the log file.
          *
-         * Writes a log entry with the current timestamp, component name, log level,
-         * and message to the log file.
+         * Formats a log entry with the current timestamp, component name, log level,
+         * and message and hands it to the writer thread. If the ring buffer is full,
+         * the caller waits for the writer to make room rather than losing the record.
          *
          * @param component The name of the component generating the log.
          * @param level The severity level of the log message.
@@ -48,17 +141,321 @@ class EventLogger {
          */
         void logEvent(const std::string& component, LogLevel level, const std::string& message);
 
+        /**
+         * @brief Checks if events of a level pass the global filter.
+         * @param level The severity level.
+         * @return `true` if such events are logged.
+         */
+        [[nodiscard]] bool isEnabled(LogLevel level) const {
+            return level >= minLevel.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Checks if events of a component and level are logged.
+         *
+         * A level set for the component takes precedence over the global level.
+         *
+         * @param component A registered component ID.
+         * @param level The severity level.
+         * @return `true` if such events are logged.
+         */
+        [[nodiscard]] bool isEnabled(ComponentId component, LogLevel level) const {
+            const std::uint8_t componentLevel = componentLevels[component].load(std::memory_order_relaxed);
+            return componentLevel == EventLoggerConstants::INHERIT_LEVEL ? isEnabled(level) : level >= componentLevel;
+        }
+
+        /**
+         * @brief Checks if events of a component name and level are logged.
+         *
+         * Only looks the name up when some component has its own level, and then
+         * without locking once the calling thread has seen the name.
+         *
+         * @param component The component name. Registered if it is not yet.
+         * @param level The severity level.
+         * @return `true` if such events are logged.
+         * @throws std::runtime_error If the name is new and no more IDs are available.
+         */
+        [[nodiscard]] bool isEnabled(const std::string& component, LogLevel level);
+
+        /**
+         * @brief Sets the global minimum level.
+         * @param level The new minimum level.
+         */
+        void setLevel(LogLevel level);
+
+        /**
+         * @brief Gets the global minimum level.
+         * @return The minimum level.
+         */
+        [[nodiscard]] LogLevel getLevel() const;
+
+        /**
+         * @brief Sets a minimum level for one component, overriding the global level.
+         *
+         * The level may be lower than the global one, e.g. to trace a single component.
+         *
+         * @param component The component name. Registered if it is not yet.
+         * @param level The minimum level for the component.
+         */
+        void setComponentLevel(const std::string& component, LogLevel level);
+
+        /**
+         * @brief Makes a component follow the global level again.
+         * @param component The component name.
+         */
+        void clearComponentLevel(const std::string& component);
+
+        /**
+         * @brief Lets SIGUSR1 and SIGUSR2 switch DEBUG logging on and off.
+         *
+         * SIGUSR1 sets the global level to DEBUG and SIGUSR2 restores `Config::level`.
+         * Only one logger is controlled at a time; the destructor releases it.
+         *
+         * @param logger The logger to control, or `nullptr` to stop controlling any.
+         */
+        static void enableSignalControl(EventLogger* logger);
+
+        /**
+         * @brief Registers a component name for structured logging.
+         *
+         * Registering the same name again returns the same ID. In binary mode the
+         * definition is written to the log before the ID is returned.
+         *
+         * @param name The component name.
+         * @return The ID of the component.
+         * @throws std::runtime_error If no more IDs are available.
+         */
+        ComponentId registerComponent(const std::string& name);
+
+        /**
+         * @brief Registers a format pattern for structured logging.
+         *
+         * Each "{}" in the pattern is replaced by the next argument when the event is
+         * rendered. Registering the same pattern again returns the same ID.
+         *
+         * @param pattern The format pattern.
+         * @return The ID of the format.
+         * @throws std::runtime_error If no more IDs are available.
+         */
+        FormatId registerFormat(const std::string& pattern);
+
+        /**
+         * @brief Logs an event by component and format ID.
+         *
+         * The arguments are encoded without formatting. In binary mode they are written
+         * as they are; in text mode the pattern is rendered before the record is queued.
+         * Arguments may be integers, floating point values or strings.
+         *
+         * @param component A registered component ID.
+         * @param level The severity level of the event.
+         * @param format A registered format ID.
+         * @param args The arguments of the format pattern.
+         */
+        template <typename... Args>
+        void logStructured(ComponentId component, LogLevel level, FormatId format, const Args&... args) {
+            static_assert(sizeof...(Args) <= BinaryLog::MAX_ARGUMENTS, "too many log arguments");
+            if (!isEnabled(component, level)) return;
+            std::string encoded;
+            (BinaryLog::appendArg(encoded, args), ...);
+            logEncoded(component, level, format, sizeof...(Args), encoded);
+        }
+
+        /**
+         * @brief Writes every record logged before the call.
+         *
+         * Blocks until the writer thread has written all of them to the file.
+         * Intended for shutdown and for readers that need the file up to date.
+         */
+        void flush();
+
+        /**
+         * @brief Appends a record in the text format.
+         *
+         * Produces "[timestamp] [component] [LEVEL] message\n" through the shared logging
+         * core, so server and client logs line up. Used by the logger in text mode and by
+         * `LogDecoder` to render binary records identically.
+         *
+         * @param out The buffer to append to.
+         * @param time The time of the event.
+         * @param precision The sub-second precision of the timestamp.
+         * @param component The component name.
+         * @param level The severity level.
+         * @param message The message.
+         */
+        static void formatTextRecord(std::string& out, const timespec& time, TimestampPrecision precision,
+                                     std::string_view component, LogLevel level, std::string_view message);
+
     private:
-        std::ofstream logFile; /**< The output file stream for the log file. */
+        /**
+         * @brief Signal handler installed by `enableSignalControl`.
+         * @param signal The received signal.
+         */
+        static void handleLevelSignal(int signal);
+
+        /**
+         * @class RecordRing
+         * @brief Bounded lock-free multi-producer queue of formatted records.
+         *
+         * Each cell carries a sequence number that tells producers and the consumer
+         * whether it is free or filled, so pushes from many threads only contend on
+         * a single atomic counter.
+         */
+        class RecordRing {
+            public:
+                explicit RecordRing(std::size_t capacity);
+
+                /**
+                 * @brief Appends a record if there is room.
+                 * @param record The record to append. Moved from on success.
+                 * @return `true` if the record was appended, `false` if the ring is full.
+                 */
+                bool tryPush(std::string& record);
+
+                /**
+                 * @brief Removes the oldest record if there is one. Only the writer thread calls this.
+                 * @param record Receives the record.
+                 * @return `true` if a record was removed, `false` if the ring is empty.
+                 */
+                bool tryPop(std::string& record);
+
+                /**
+                 * @brief Gets the number of records pushed so far.
+                 * @return The total number of pushes, including ones still being completed.
+                 */
+                [[nodiscard]] std::uint64_t pushedCount() const;
+
+                /**
+                 * @brief Gets the approximate number of records waiting in the ring.
+                 * @return The approximate occupancy.
+                 */
+                [[nodiscard]] std::size_t approximateSize() const;
+
+                /**
+                 * @brief Gets the number of records the ring holds.
+                 * @return The capacity.
+                 */
+                [[nodiscard]] std::size_t capacity() const;
+
+            private:
+                struct Cell {
+                    std::atomic<std::uint64_t> sequence; ///< Position the cell is ready for.
+                    std::string record; ///< Formatted record stored in the cell.
+                };
+
+                std::unique_ptr<Cell[]> cells; ///< Ring storage.
+                std::size_t mask; ///< Capacity minus one, used to wrap positions.
+                alignas(64) std::atomic<std::uint64_t> enqueuePos; ///< Next position producers claim.
+                alignas(64) std::atomic<std::uint64_t> dequeuePos; ///< Next position the writer reads.
+        };
+
+        /**
+         * @brief Body of the writer thread.
+         *
+         * Drains the ring into a batch buffer, writes the batch when it is large,
+         * when the ring is empty, or when the flush interval expires.
+         */
+        void writerLoop();
+
+        /**
+         * @brief Tells whether the log is written through rotating segments.
+         * @return `true` if rotation is configured.
+         */
+        [[nodiscard]] bool isRotating() const;
+
+        /**
+         * @brief Keeps the definitions of a binary log for the start of later segments.
+         *
+         * Called by the writer thread for each record before it is written.
+         *
+         * @param record A complete binary record.
+         */
+        void trackPreamble(const std::string& record);
+
+        /**
+         * @brief Writes a buffer to the log file, retrying on partial writes.
+         * @param data The bytes to write.
+         * @param length The number of bytes to write.
+         */
+        void writeAll(const char* data, std::size_t length) const;
+
+        /**
+         * @brief Wakes the writer thread up.
+         */
+        void wakeWriter();
+
+        /**
+         * @brief Hands a finished record to the writer thread.
+         *
+         * Waits for room if the ring is full.
+         *
+         * @param record The record. Moved from.
+         */
+        void pushRecord(std::string& record);
+
+        /**
+         * @brief Logs an event whose arguments are already encoded.
+         * @param component The component ID.
+         * @param level The severity level.
+         * @param format The format ID.
+         * @param argc The number of encoded arguments.
+         * @param args The encoded arguments.
+         */
+        void logEncoded(ComponentId component, LogLevel level, FormatId format, std::size_t argc, const std::string& args);
+
+        /**
+         * @brief Queues a binary EVENT record.
+         * @param component The component ID.
+         * @param level The severity level.
+         * @param format The format ID.
+         * @param argc The number of encoded arguments.
+         * @param args The encoded arguments.
+         * @param time The time of the event.
+         */
+        void pushBinaryEvent(ComponentId component, LogLevel level, FormatId format, std::size_t argc,
+                             std::string_view args, const timespec& time);
+
+        /**
+         * @brief Queues a binary COMPONENT or FORMAT definition record.
+         * @param kind The kind of the definition.
+         * @param id The defined ID.
+         * @param text The component name or format pattern.
+         */
+        void pushDefinition(BinaryLog::RecordKind kind, std::uint16_t id, std::string_view text);
+
+        /**
+         * @brief Looks up or assigns the ID of a name in one of the registries.
+         *
+         * Must be called with `registryMutex` held.
+         *
+         * @param ids The name to ID map of the registry.
+         * @param names The names of the registry, indexed by ID.
+         * @param kind The definition record written for a new name in binary mode.
+         * @param name The name to register.
+         * @return The ID of the name.
+         * @throws std::runtime_error If no more IDs are available.
+         */
+        std::uint16_t registerName(std::unordered_map<std::string, std::uint16_t>& ids,
+                                   std::vector<std::string>& names, BinaryLog::RecordKind kind,
+                                   const std::string& name);
 
         /**
-         * @brief Gets the current timestamp as a string.
+         * @brief Gets the ID of a component name, registering it if needed.
          *
-         * Generates a timestamp in the format "YYYY-MM-DD HH:MM:SS".
+         * Each thread caches the names it has resolved, so only the first use of a
+         * name on a thread takes `registryMutex`.
          *
-         * @return A string representing the current timestamp.
+         * @param name The component name.
+         * @return The ID of the component.
+         * @throws std::runtime_error If the name is new and no more IDs are available.
          */
-        std::string getCurrentTimestamp() const;
+        ComponentId resolveComponent(const std::string& name);
+
+        /**
+         * @brief Maps a timestamp precision to its number of fractional digits.
+         * @param precision The precision.
+         * @return 0, 3 or 6.
+         */
+        static int fractionDigits(TimestampPrecision precision);
 
         /**
          * @brief Converts a log level to its string representation.
@@ -66,7 +463,57 @@ class EventLogger {
          * Maps the `LogLevel` enum to a corresponding string (e.g., "INFO", "WARNING", "ERROR").
          *
          * @param level The log level to convert.
-         * @return A string representation of the log level.
+         * @return A view of a static string naming the log level.
          */
-        std::string logLevelToString(LogLevel level) const;
+        static std::string_view logLevelToString(LogLevel level);
+
+        int logFd; /**< Descriptor of the log file, opened in append mode, or -1 when rotating. */
+        std::unique_ptr<RotatingLogFile> rotatingFile; /**< Segments written instead of `logFd` when rotating. */
+        Config config; /**< Writer configuration. */
+        RecordRing ring; /**< Records waiting for the writer thread. */
+
+        std::mutex registryMutex; /**< Protects the component and format registries. */
+        std::unordered_map<std::string, ComponentId> componentIds; /**< Registered component names. */
+        std::vector<std::string> componentNames; /**< Component names, indexed by ID. */
+        const std::uint64_t instance; /**< Distinguishes this logger in the per-thread component caches. */
+        static std::atomic<std::uint64_t> nextInstance; /**< Source of `instance` values. */
+        std::unordered_map<std::string, FormatId> formatIds; /**< Registered format patterns. */
+        std::vector<std::string> formatPatterns; /**< Format patterns, indexed by ID. */
+
+        std::atomic<LogLevel> minLevel; /**< Global minimum level. */
+        std::unique_ptr<std::atomic<std::uint8_t>[]> componentLevels; /**< Per-component minimum level, or `INHERIT_LEVEL`. */
+        std::atomic<std::size_t> componentOverrides; /**< Number of components with their own level. */
+        static std::atomic<EventLogger*> signalTarget; /**< Logger controlled by SIGUSR1/SIGUSR2. */
+
+        std::mutex writerMutex; /**< Protects the writer's wake-up and flush bookkeeping. */
+        std::condition_variable writerWake; /**< Wakes the writer before its interval expires. */
+        std::condition_variable flushDone; /**< Signalled after each batch is written. */
+        std::atomic<std::uint64_t> writtenCount; /**< Records written to the file so far. */
+        std::size_t flushWaiters; /**< Number of callers waiting in `flush`. */
+        bool stopping; /**< Whether the writer thread should exit once the ring is empty. */
+        std::thread writer; /**< The writer thread. */
 };
+
+/**
+ * @brief Logs a structured event if its component and level are enabled.
+ *
+ * The format arguments are not evaluated when the event is filtered out.
+ */
+#define LOG_EVENT(logger, component, level, format, ...)                                   \
+    do {                                                                                    \
+        if ((logger).isEnabled((component), (level))) {                                     \
+            (logger).logStructured((component), (level), (format) __VA_OPT__(, ) __VA_ARGS__); \
+        }                                                                                   \
+    } while (0)
+
+/**
+ * @brief Logs a text message if its component and level are enabled.
+ *
+ * The message expression is not evaluated when the event is filtered out.
+ */
+#define LOG_MESSAGE(logger, component, level, message)              \
+    do {                                                             \
+        if ((logger).isEnabled((component), (level))) {              \
+            (logger).logEvent((component), (level), (message));      \
+        }                                                            \
+    } while (0)
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace EventLoopConstants {
+    constexpr int MAX_EVENTS_PER_WAIT = 64; /**< Maximum number of epoll events handled per iteration. */
+}
+
+/**
+ * @class EventLoop
+ * @brief Single-threaded epoll event loop for the server's I/O.
+ *
+ * The loop waits for readiness on registered file descriptors and runs their
+ * handlers, and also runs callbacks posted from any thread. It is the place
+ * where coroutine handlers are resumed: awaiting `schedule()`, `readable()` or
+ * `writable()` suspends the coroutine and lets the loop resume it later,
+ * so no worker thread is held while the operation is pending.
+ *
+ * A descriptor may carry several registrations as long as their events do not
+ * overlap, e.g. a reader on `EPOLLIN` and a writer on `EPOLLOUT`. The loop keeps
+ * the union of their events as the descriptor's epoll interest.
+ *
+ * `post`, `stop` and the awaitables may be used from any thread. `watch` and
+ * `unwatch` must be called from the loop thread, or before the loop starts running.
+ */
+class EventLoop {
+    public:
+        using Callback = std::function<void()>; ///< Callback posted to the loop.
+        using IoHandler = std::function<void(std::uint32_t events)>; ///< Handler for fd readiness events.
+
+        /**
+         * @class ScheduleAwaiter
+         * @brief Awaitable that resumes the coroutine on the loop thread.
+         */
+        class ScheduleAwaiter {
+            public:
+                explicit ScheduleAwaiter(EventLoop* loop) : loop(loop) {}
+                [[nodiscard]] bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> handle) const;
+                void await_resume() const noexcept {}
+
+            private:
+                EventLoop* loop; ///< Loop the coroutine is resumed on.
+        };
+
+        /**
+         * @class IoAwaiter
+         * @brief Awaitable that resumes the coroutine when a file descriptor becomes ready.
+         *
+         * The awaiter holds a one-shot registration for its events, so the descriptor may
+         * be watched for other events meanwhile. `co_await` yields the epoll events that
+         * were reported, or `EPOLLERR` if the registration was refused.
+         */
+        class IoAwaiter {
+            public:
+                IoAwaiter(EventLoop* loop, int fd, std::uint32_t events) : loop(loop), fd(fd), events(events) {}
+                [[nodiscard]] bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> handle);
+                [[nodiscard]] std::uint32_t await_resume() const noexcept { return revents; }
+
+            private:
+                EventLoop* loop; ///< Loop the coroutine is resumed on.
+                int fd; ///< File descriptor being awaited.
+                std::uint32_t events; ///< Requested epoll events.
+                std::uint32_t revents = 0; ///< Events reported when the coroutine was resumed.
+        };
+
+        /**
+         * @brief Constructs an event loop.
+         *
+         * @throws std::runtime_error If the epoll instance or the wake-up descriptor cannot be created.
+         */
+        EventLoop();
+
+        /**
+         * @brief Destroys the event loop and closes its internal descriptors.
+         *
+         * Registered descriptors are not closed; they belong to their owners.
+         */
+        ~EventLoop();
+
+        EventLoop(const EventLoop&) = delete;
+        EventLoop& operator=(const EventLoop&) = delete;
+
+        /**
+         * @brief Queues a callback to run on the loop thread.
+         *
+         * Safe to call from any thread. The loop is woken up if it is waiting.
+         *
+         * @param callback The callback to run.
+         */
+        void post(Callback callback);
+
+        /**
+         * @brief Registers a handler for readiness events of a file descriptor.
+         *
+         * The descriptor is added to epoll on its first registration; later ones
+         * extend its interest with `EPOLL_CTL_MOD`.
+         *
+         * @param fd The file descriptor to watch.
+         * @param events The epoll events of interest (e.g. `EPOLLIN | EPOLLOUT`).
+         * @param handler The handler invoked with the reported events.
+         * @return `true` if the handler was registered, `false` if `events` overlap
+         *         another registration of `fd` or epoll refused the descriptor.
+         */
+        bool watch(int fd, std::uint32_t events, IoHandler handler);
+
+        /**
+         * @brief Removes the registrations of a file descriptor that cover `events`.
+         *
+         * The descriptor stays in epoll with the remaining interest, and is removed
+         * once no registration is left. If it is not watched, the method does nothing.
+         *
+         * @param fd The file descriptor to stop watching.
+         * @param events The events whose handlers are removed; all of them by default.
+         */
+        void unwatch(int fd, std::uint32_t events = ~0u);
+
+        /**
+         * @brief Runs one iteration of the loop.
+         *
+         * Waits up to `timeoutMs` for events, runs the handlers of ready descriptors
+         * and then every callback posted so far.
+         *
+         * @param timeoutMs Maximum time to wait, in milliseconds. -1 waits indefinitely.
+         * @return The number of handlers and callbacks that were run.
+         */
+        std::size_t runOnce(int timeoutMs);
+
+        /**
+         * @brief Runs the loop until `stop` is called.
+         *
+         * A `stop` issued before `run` makes it return without waiting.
+         */
+        void run();
+
+        /**
+         * @brief Asks the loop to return from `run`.
+         *
+         * Safe to call from any thread.
+         */
+        void stop();
+
+        /**
+         * @brief Checks if the caller is running on the loop thread.
+         * @return `true` if called from inside `run`/`runOnce`, `false` otherwise.
+         */
+        [[nodiscard]] bool isInLoopThread() const;
+
+        /**
+         * @brief Returns an awaitable that resumes the coroutine on the loop thread.
+         * @return The awaitable.
+         */
+        ScheduleAwaiter schedule();
+
+        /**
+         * @brief Returns an awaitable that resumes the coroutine when `fd` is readable.
+         * @param fd The file descriptor to wait on.
+         * @return The awaitable.
+         */
+        IoAwaiter readable(int fd);
+
+        /**
+         * @brief Returns an awaitable that resumes the coroutine when `fd` is writable.
+         * @param fd The file descriptor to wait on.
+         * @return The awaitable.
+         */
+        IoAwaiter writable(int fd);
+
+    private:
+        /**
+         * @struct Registration
+         * @brief A handler and the events it was registered for.
+         */
+        struct Registration {
+            std::uint32_t events; ///< Events the handler is interested in.
+            std::shared_ptr<IoHandler> handler; ///< Handler invoked with the reported events.
+        };
+
+        /**
+         * @brief Computes the epoll interest of a descriptor from its registrations.
+         * @param registrations The descriptor's registrations.
+         * @return The union of their events.
+         */
+        static std::uint32_t interestOf(const std::vector<Registration>& registrations);
+
+        /**
+         * @brief Wakes the loop up if it is blocked in `epoll_wait`.
+         */
+        void wakeUp() const;
+
+        /**
+         * @brief Runs every callback posted so far.
+         * @return The number of callbacks run.
+         */
+        std::size_t runPosted();
+
+        int epollFd; ///< The epoll instance.
+        int wakeFd; ///< eventfd used to interrupt `epoll_wait`.
+        std::atomic<bool> stopRequested; ///< Set by `stop`, consumed when `run` returns.
+        std::atomic<std::thread::id> loopThread; ///< Thread currently running the loop.
+
+        std::unordered_map<int, std::vector<Registration>> registrations; ///< Handlers of watched descriptors.
+
+        std::mutex postedMutex; ///< Protects `posted`.
+        std::vector<Callback> posted; ///< Callbacks waiting to run on the loop thread.
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "LatencyHistogram.hpp"
+#include "Message.hpp"
+#include "NetworkManager.hpp"
+#include "TimerWheel.hpp"
+
+namespace HeartbeatConstants {
+    constexpr std::chrono::milliseconds DEFAULT_INTERVAL{5000}; /**< Time between pings to a client. */
+    constexpr std::uint32_t DEFAULT_MISSED_LIMIT = 3; /**< Unanswered pings before a client is declared dead. */
+    constexpr std::chrono::milliseconds TIMER_TICK{50}; /**< Resolution of the ping timers. */
+}
+
+/**
+ * @class HeartbeatMonitor
+ * @brief Pings registered clients and measures their round-trip time.
+ *
+ * Every interval each registered client is sent a HEARTBEAT/PING message whose content
+ * holds a sequence number; the client answers with a HEARTBEAT/PONG carrying the same
+ * content. The round-trip time of every matched pong is added to the client's
+ * `LatencyHistogram`. The send time is kept on the server, so the measurement does not
+ * depend on the client's clock. A client that leaves `missedLimit` pings in a row
+ * unanswered is closed through the `NetworkManager`.
+ *
+ * Ping timers live on a `TimerWheel`, so a tick only touches the clients that are due.
+ * The class is not thread-safe; it runs on the thread that dispatches messages.
+ */
+class HeartbeatMonitor {
+    public:
+        /**
+         * @struct Options
+         * @brief Heartbeat settings.
+         */
+        struct Options {
+            std::chrono::milliseconds interval = HeartbeatConstants::DEFAULT_INTERVAL; /**< Time between pings. */
+            std::uint32_t missedLimit = HeartbeatConstants::DEFAULT_MISSED_LIMIT; /**< Unanswered pings before closing. */
+        };
+
+        /**
+         * @brief Constructs a monitor with the default settings.
+         * @param networkManager The manager used to send pings and close dead clients.
+         */
+        explicit HeartbeatMonitor(NetworkManager* networkManager);
+
+        /**
+         * @brief Constructs a monitor.
+         *
+         * @param networkManager The manager used to send pings and close dead clients.
+         * @param options The heartbeat settings.
+         * @param start The current time.
+         * @throws std::invalid_argument If the interval is not positive or the missed limit is zero.
+         */
+        HeartbeatMonitor(NetworkManager* networkManager, Options options,
+                         TimerWheel::Clock::time_point start = TimerWheel::Clock::now());
+
+        /**
+         * @brief Starts pinging a client one interval from now.
+         *
+         * Does nothing if the client is already registered.
+         *
+         * @param clientID The client ID.
+         * @param now The current time.
+         */
+        void registerClient(int clientID, TimerWheel::Clock::time_point now = TimerWheel::Clock::now());
+
+        /**
+         * @brief Stops pinging a client and forgets its measurements.
+         * @param clientID The client ID.
+         */
+        void removeClient(int clientID);
+
+        /**
+         * @brief Sends the pings that are due and closes clients that stopped answering.
+         *
+         * @param now The current time.
+         * @return The number of pings sent.
+         */
+        std::size_t tick(TimerWheel::Clock::time_point now = TimerWheel::Clock::now());
+
+        /**
+         * @brief Records the answer to a ping.
+         *
+         * @param clientID The client that sent the pong.
+         * @param pong The HEARTBEAT/PONG message.
+         * @param now The time the pong arrived.
+         * @return `true` if the pong answered the client's outstanding ping.
+         */
+        bool handlePong(int clientID, const Message& pong, TimerWheel::Clock::time_point now = TimerWheel::Clock::now());
+
+        /**
+         * @brief Builds the answer to a ping.
+         * @param ping The HEARTBEAT/PING message.
+         * @return A HEARTBEAT/PONG message for the same client with the same content.
+         */
+        static Message makePong(const Message& ping);
+
+        /**
+         * @brief Gets the round-trip times measured for a client.
+         * @param clientID The client ID.
+         * @return The histogram, or `nullptr` if the client is not registered.
+         */
+        [[nodiscard]] const LatencyHistogram* getRttHistogram(int clientID) const;
+
+        /**
+         * @brief Gets the number of clients closed for missing their pings.
+         * @return The number of dead clients closed.
+         */
+        [[nodiscard]] std::size_t getDeadClients() const;
+
+        /**
+         * @brief Exports the round-trip times of every registered client.
+         *
+         * The JSON object maps each client ID to `LatencyHistogram::toJSON` of its
+         * round-trip times, plus the number of pings it has not answered.
+         *
+         * @return The serialized JSON object.
+         */
+        [[nodiscard]] std::string exportRttHistograms() const;
+
+    private:
+        /**
+         * @struct Peer
+         * @brief Heartbeat state of one client.
+         */
+        struct Peer {
+            std::uint64_t lastSequence = 0; ///< Sequence number of the last ping sent.
+            bool awaitingPong = false; ///< Whether the last ping is unanswered.
+            TimerWheel::Clock::time_point sentAt; ///< When the last ping was sent.
+            std::uint32_t missed = 0; ///< Consecutive unanswered pings.
+            LatencyHistogram rtt; ///< Measured round-trip times.
+        };
+
+        NetworkManager* network; ///< Sends pings and closes dead clients.
+        Options options; ///< Heartbeat settings.
+        TimerWheel timers; ///< Next ping of each client, by client ID.
+        std::unordered_map<int, Peer> peers; ///< Registered clients.
+        std::size_t deadClients = 0; ///< Clients closed for missing their pings.
+};
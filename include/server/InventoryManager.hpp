@@ -1,8 +1,16 @@
 #pragma once
 
 #include "cjson/cJSON.h"
+#include <chrono>
+#include <cstddef>
+#include <deque>
 #include <string>
 #include <map>
+#include <vector>
+
+namespace InventoryConstants {
+    constexpr std::size_t MAX_TRANSACTIONS = 4096; /**< Transactions kept in the journal; older ones are dropped. */
+}
 
 /**
  * @brief Manages inventory operations and client-specific inventories.
@@ -16,6 +24,17 @@
  */
 class InventoryManager {
     public:
+        /**
+         * @struct Transaction
+         * @brief A stock movement recorded by `logTransaction`.
+         */
+        struct Transaction {
+            int itemID; /**< Item that moved. */
+            int quantity; /**< Quantity that moved. */
+            std::string clientID; /**< Client the movement was made for. */
+            std::chrono::system_clock::time_point time; /**< When the movement was recorded. */
+        };
+
         /**
          * @brief Constructs an `InventoryManager` instance.
          *
@@ -91,7 +110,8 @@ class InventoryManager {
         /**
          * @brief Logs a transaction involving a specific item and client.
          *
-         * This method is currently unimplemented.
+         * The transaction is appended to an in-memory journal holding the last
+         * `InventoryConstants::MAX_TRANSACTIONS` transactions.
          *
          * @param itemID The unique identifier for the item.
          * @param quantity The quantity involved in the transaction.
@@ -99,6 +119,14 @@ class InventoryManager {
          */
         void logTransaction(int itemID, int quantity, const std::string& clientID);
 
+        /**
+         * @brief Retrieves the journaled transactions of a client, oldest first.
+         *
+         * @param clientID The unique identifier for the client.
+         * @return The client's transactions still held in the journal.
+         */
+        [[nodiscard]] std::vector<Transaction> getTransactionHistory(const std::string& clientID) const;
+
         /**
          * @brief Updates the inventory of a specific client.
          *
@@ -119,7 +147,20 @@ class InventoryManager {
          */
         [[nodiscard]] cJSON* detectInventoryAnomalies(int clientID) const;
 
+        /**
+         * @brief Writes the global and client inventories to a JSON file.
+         *
+         * The snapshot holds a "global" object with the stock levels and a "clients" object
+         * with each client's inventory by ID. It is written to a temporary file that is
+         * synced and renamed over `path`, so a crash never leaves a partial snapshot.
+         *
+         * @param path The snapshot file.
+         * @return `true` if the snapshot was written, `false` otherwise.
+         */
+        bool saveSnapshot(const std::string& path) const;
+
     private:
         cJSON* globalInventory; ///< Stores global inventory data as a JSON object.
         std::map<int, cJSON*> clientInventories; ///< Maps client IDs to their individual inventory data.
+        std::deque<Transaction> transactions; ///< Journal of the most recent transactions, oldest first.
 };
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace IoUringConstants {
+    constexpr unsigned DEFAULT_ENTRIES = 256; /**< Submission queue size. */
+    constexpr unsigned BUFFER_COUNT = 256; /**< Provided receive buffers. */
+    constexpr std::size_t BUFFER_SIZE = 4096; /**< Size of each provided receive buffer. */
+    constexpr std::uint16_t BUFFER_GROUP = 0; /**< Buffer group ID of the receive buffers. */
+}
+
+/**
+ * @class IoUring
+ * @brief Minimal io_uring instance driven through the raw system calls.
+ *
+ * Wraps the submission and completion rings and one group of provided buffers, and
+ * prepares the few operations the network layer uses: multishot accept, multishot
+ * receive into provided buffers, and sends that can be linked so they run in order.
+ * Operations are queued with the `prepare` methods and handed to the kernel by
+ * `submitAndWait`; their results are collected with `drainCompletions`.
+ *
+ * The class is not thread-safe; the ring belongs to the thread that drives it.
+ */
+class IoUring {
+    public:
+        /**
+         * @struct Completion
+         * @brief Result of a finished operation.
+         */
+        struct Completion {
+            std::uint64_t userData; /**< Value given when the operation was prepared. */
+            std::int32_t result; /**< Operation result, or a negated `errno`. */
+            std::uint32_t flags; /**< `IORING_CQE_F_*` flags. */
+
+            /**
+             * @brief Checks if a multishot operation stays armed.
+             * @return `true` if more completions will follow for the same operation.
+             */
+            [[nodiscard]] bool hasMore() const;
+
+            /**
+             * @brief Gets the provided buffer holding received data.
+             * @return The buffer ID, or `std::nullopt` if no buffer was used.
+             */
+            [[nodiscard]] std::optional<std::uint16_t> bufferId() const;
+        };
+
+        /**
+         * @brief Creates the rings.
+         *
+         * @param entries The submission queue size.
+         * @throws std::runtime_error If io_uring is unavailable or the rings cannot be mapped.
+         */
+        explicit IoUring(unsigned entries = IoUringConstants::DEFAULT_ENTRIES);
+
+        /**
+         * @brief Closes the ring and unmaps its memory.
+         */
+        ~IoUring();
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        /**
+         * @brief Hands a group of buffers to the kernel for `prepareMultishotRecv`.
+         *
+         * Must be called before any other operation is prepared.
+         *
+         * @param count The number of buffers.
+         * @param size The size of each buffer.
+         * @param group The buffer group ID.
+         * @throws std::runtime_error If the buffers cannot be allocated or provided.
+         */
+        void provideBuffers(unsigned count, std::size_t size, std::uint16_t group);
+
+        /**
+         * @brief Gets the data a receive left in a provided buffer.
+         *
+         * @param id The buffer ID from the completion.
+         * @param length The number of bytes received.
+         * @return The received bytes, valid until the buffer is recycled.
+         */
+        [[nodiscard]] std::string_view buffer(std::uint16_t id, std::size_t length) const;
+
+        /**
+         * @brief Gives a provided buffer back to the kernel with the next submission.
+         * @param id The buffer ID.
+         */
+        void recycleBuffer(std::uint16_t id);
+
+        /**
+         * @brief Queues a multishot accept: one completion, holding the new socket, per connection.
+         *
+         * @param listenFd The listening socket.
+         * @param userData The value reported with each completion.
+         * @return `false` if the submission queue is full.
+         */
+        bool prepareMultishotAccept(int listenFd, std::uint64_t userData);
+
+        /**
+         * @brief Queues a multishot receive into the provided buffers.
+         *
+         * @param fd The connected socket.
+         * @param userData The value reported with each completion.
+         * @return `false` if the submission queue is full.
+         */
+        bool prepareMultishotRecv(int fd, std::uint64_t userData);
+
+        /**
+         * @brief Queues a send of a whole buffer.
+         *
+         * The send does not complete until every byte is written or an error occurs,
+         * so a chain of linked sends puts their buffers on the stream in order; an
+         * error cancels the rest of the chain.
+         *
+         * @param fd The connected socket.
+         * @param data The bytes to send; they must stay valid until the completion.
+         * @param length The number of bytes.
+         * @param userData The value reported with the completion.
+         * @param linkNext Whether the next prepared operation waits for this one.
+         * @return `false` if the submission queue is full.
+         */
+        bool prepareSend(int fd, const void* data, std::size_t length, std::uint64_t userData, bool linkNext);
+
+        /**
+         * @brief Gets the ring descriptor, which polls readable while completions are waiting.
+         * @return The io_uring descriptor.
+         */
+        [[nodiscard]] int getFd() const;
+
+        /**
+         * @brief Gets the number of free submission queue entries.
+         * @return The entries that can be prepared before the queue is full.
+         */
+        [[nodiscard]] unsigned getFreeEntries() const;
+
+        /**
+         * @brief Submits the prepared operations and optionally waits for completions.
+         *
+         * @param minComplete The number of completions to wait for.
+         * @param timeoutMs Maximum time to wait, in milliseconds. -1 waits indefinitely.
+         * @return The number of operations submitted, or a negated `errno`.
+         */
+        int submitAndWait(unsigned minComplete, int timeoutMs);
+
+        /**
+         * @brief Moves the available completions out of the completion queue.
+         *
+         * @param completions Receives the completions.
+         * @return The number of completions collected.
+         */
+        std::size_t drainCompletions(std::vector<Completion>& completions);
+
+    private:
+        /**
+         * @brief Takes the next free submission queue entry.
+         * @return The cleared entry, or `nullptr` if the queue is full.
+         */
+        io_uring_sqe* nextSqe();
+
+        /**
+         * @brief Queues the return of consecutive buffers to the kernel.
+         *
+         * @param first The ID of the first buffer.
+         * @param count The number of buffers.
+         * @param skipSuccess Whether a successful return posts no completion.
+         * @return `false` if the submission queue is full.
+         */
+        bool prepareProvideBuffers(std::uint16_t first, unsigned count, bool skipSuccess);
+
+        int ringFd = -1; ///< The io_uring descriptor.
+        std::uint32_t features = 0; ///< `IORING_FEAT_*` flags of the kernel.
+
+        void* sqRing = nullptr; ///< Mapping of the submission ring.
+        std::size_t sqRingBytes = 0; ///< Size of `sqRing`.
+        void* cqRing = nullptr; ///< Mapping of the completion ring; equals `sqRing` with a single mapping.
+        std::size_t cqRingBytes = 0; ///< Size of `cqRing`.
+        io_uring_sqe* sqes = nullptr; ///< Submission queue entries.
+        std::size_t sqesBytes = 0; ///< Size of `sqes`.
+
+        unsigned* sqHead = nullptr; ///< Kernel-owned submission head.
+        unsigned* sqTail = nullptr; ///< Submission tail published to the kernel.
+        unsigned* sqArray = nullptr; ///< Submission index array.
+        unsigned sqMask = 0; ///< Submission ring mask.
+        unsigned sqEntries = 0; ///< Submission ring size.
+        unsigned sqLocalTail = 0; ///< Tail including prepared, unpublished entries.
+        unsigned sqPublished = 0; ///< Tail last handed to the kernel.
+
+        unsigned* cqHead = nullptr; ///< Completion head owned by this side.
+        unsigned* cqTail = nullptr; ///< Kernel-owned completion tail.
+        unsigned cqMask = 0; ///< Completion ring mask.
+        io_uring_cqe* cqes = nullptr; ///< Completion queue entries.
+
+        char* buffers = nullptr; ///< Memory of the provided buffers.
+        std::size_t buffersBytes = 0; ///< Size of `buffers`.
+        std::size_t bufferSize = 0; ///< Size of each provided buffer.
+        std::uint16_t bufferGroup = 0; ///< Buffer group ID of the provided buffers.
+};
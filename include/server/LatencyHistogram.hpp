@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "cjson/cJSON.h"
+
+namespace LatencyHistogramConstants {
+    constexpr std::size_t BUCKETS = 32; /**< Power-of-two buckets; the last one also holds longer samples. */
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-scale histogram of durations in microseconds.
+ *
+ * Bucket 0 counts samples under one microsecond and bucket `i` counts samples in
+ * [2^(i-1), 2^i) microseconds, so recording is a bit count and the histogram has a
+ * fixed size whatever the spread of the samples. Percentiles are reported as the upper
+ * bound of their bucket, which overestimates by less than a factor of two.
+ */
+class LatencyHistogram {
+    public:
+        /**
+         * @brief Adds a sample.
+         * @param sample The duration. Negative durations count as zero.
+         */
+        void record(std::chrono::microseconds sample);
+
+        /**
+         * @brief Gets the number of samples.
+         * @return The number of recorded samples.
+         */
+        [[nodiscard]] std::uint64_t getCount() const;
+
+        /**
+         * @brief Gets the shortest sample.
+         * @return The minimum, or zero without samples.
+         */
+        [[nodiscard]] std::chrono::microseconds getMin() const;
+
+        /**
+         * @brief Gets the longest sample.
+         * @return The maximum, or zero without samples.
+         */
+        [[nodiscard]] std::chrono::microseconds getMax() const;
+
+        /**
+         * @brief Gets the average sample.
+         * @return The mean, or zero without samples.
+         */
+        [[nodiscard]] std::chrono::microseconds getMean() const;
+
+        /**
+         * @brief Estimates a percentile.
+         *
+         * @param fraction The percentile as a fraction, e.g. 0.99.
+         * @return The upper bound of the bucket holding the percentile, capped at the maximum,
+         *         or zero without samples.
+         */
+        [[nodiscard]] std::chrono::microseconds getPercentile(double fraction) const;
+
+        /**
+         * @brief Gets the bucket counts.
+         * @return The number of samples in each bucket.
+         */
+        [[nodiscard]] const std::array<std::uint64_t, LatencyHistogramConstants::BUCKETS>& getBuckets() const;
+
+        /**
+         * @brief Exports the histogram.
+         *
+         * The object holds `count`, `minUs`, `maxUs`, `meanUs`, `p50Us`, `p90Us`, `p99Us`
+         * and `buckets`, the bucket counts up to the last non-empty one.
+         *
+         * @return A new JSON object owned by the caller.
+         */
+        [[nodiscard]] cJSON* toJSON() const;
+
+    private:
+        std::array<std::uint64_t, LatencyHistogramConstants::BUCKETS> buckets{}; ///< Sample counts by bucket.
+        std::uint64_t count = 0; ///< Number of samples.
+        std::uint64_t totalUs = 0; ///< Sum of the samples.
+        std::uint64_t minUs = 0; ///< Shortest sample.
+        std::uint64_t maxUs = 0; ///< Longest sample.
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "EventLogger.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace LogDecoderConstants {
+    constexpr std::size_t READ_CHUNK = 64 * 1024; /**< Payload bytes read, and allocated, at a time. */
+}
+
+/**
+ * @class LogDecoder
+ * @brief Renders binary logs written by `EventLogger` as text.
+ *
+ * Reads a stream of `BinaryLog` records and writes one line per event, in the same
+ * format the logger uses in text mode. Component and format definitions are
+ * collected as they appear and forgotten at the start of each logger session.
+ */
+class LogDecoder {
+    public:
+        /**
+         * @brief Constructs a LogDecoder object.
+         * @param precision The sub-second precision of the rendered timestamps.
+         */
+        explicit LogDecoder(EventLogger::TimestampPrecision precision = EventLogger::TimestampPrecision::SECONDS);
+
+        /**
+         * @brief Decodes a binary log.
+         *
+         * Stops at the end of the input or at the first malformed record. Events decoded
+         * before an error are still written.
+         *
+         * @param in The binary log.
+         * @param out Receives the text lines.
+         * @return `true` if the whole input was decoded, `false` if it is not a binary log,
+         *         is truncated or contains a malformed record.
+         */
+        bool decode(std::istream& in, std::ostream& out);
+
+        /**
+         * @brief Gets the number of events decoded so far.
+         * @return The number of events.
+         */
+        [[nodiscard]] std::size_t getDecodedEvents() const;
+
+    private:
+        /**
+         * @brief Decodes a single record.
+         * @param kind The kind of the record.
+         * @param payload The payload of the record.
+         * @param out Receives the text line of an EVENT record.
+         * @return `true` if the record was well formed, `false` otherwise.
+         */
+        bool decodeRecord(BinaryLog::RecordKind kind, std::string_view payload, std::ostream& out);
+
+        /**
+         * @brief Decodes an EVENT record.
+         * @param payload The payload of the record.
+         * @param out Receives the text line.
+         * @return `true` if the record was well formed, `false` otherwise.
+         */
+        bool decodeEvent(std::string_view payload, std::ostream& out);
+
+        EventLogger::TimestampPrecision precision; /**< Precision of the rendered timestamps. */
+        std::unordered_map<std::uint16_t, std::string> components; /**< Component names of the current session. */
+        std::unordered_map<std::uint16_t, std::string> formats; /**< Format patterns of the current session. */
+        std::size_t decodedEvents; /**< Number of events decoded so far. */
+        bool inSession; /**< Whether a SESSION record has been seen. */
+};
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include "MessageTypes.hpp"
 #include "cjson/cJSON.h"
 
+/**
+ * @brief Immutable, already serialized message shared by every send of a fan-out.
+ */
+using SharedPayload = std::shared_ptr<const std::string>;
+
 /**
  * @class Message
  * @brief Represents a communication message exchanged between the server and a client.
@@ -66,6 +72,26 @@ class Message {
          */
         Message& operator=(const Message& other);
 
+        /**
+         * @brief Move constructor for the Message class.
+         *
+         * Takes ownership of the other message's content without duplicating it.
+         * The moved-from message is left without content.
+         *
+         * @param other The Message object to move from.
+         */
+        Message(Message&& other) noexcept;
+
+        /**
+         * @brief Move assignment operator for the Message class.
+         *
+         * Releases the current content and takes ownership of the other message's content.
+         *
+         * @param other The Message object to move from.
+         * @return A reference to the updated Message object.
+         */
+        Message& operator=(Message&& other) noexcept;
+
         /**
          * @brief Destructor for the Message class.
          *
@@ -156,6 +182,17 @@ class Message {
          */
         [[nodiscard]] std::string toJSONString() const;
 
+        /**
+         * @brief Serializes the message once into an immutable shared buffer.
+         *
+         * Used for fan-out: the same buffer is handed to every recipient instead of
+         * serializing one message per client. Broadcast messages are built without a
+         * client ID, so the payload carries -1 and needs no per-client patching.
+         *
+         * @return A shared buffer containing the JSON representation of the message.
+         */
+        [[nodiscard]] SharedPayload toSharedPayload() const;
+
         /**
          * @brief Deserializes a JSON string into a Message object.
          *
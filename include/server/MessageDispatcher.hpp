@@ -1,18 +1,146 @@
 #pragma once
 
-#include <queue>
+#include <cstddef>
+#include "AsyncTask.hpp"
+#include "Authentication.hpp"
+#include "EventLoop.hpp"
+#include "HeartbeatMonitor.hpp"
+#include "InventoryManager.hpp"
 #include "Message.hpp"
+#include "MessageQueue.hpp"
+#include "NetworkManager.hpp"
 #include "NotificationSystem.hpp"
 
+namespace DispatcherConstants {
+    constexpr std::size_t HISTORY_PAGE_SIZE = 64; /**< Transactions sent per transaction history reply. */
+}
+
 class MessageDispatcher {
     public:
-        MessageDispatcher(std::queue<Message> *queue);
+        MessageDispatcher(MessageQueue *queue);
 
 
         void ProcessReceivedMessage(Message* msg);
 
+        /**
+         * @brief Dispatches messages waiting in the pending queue.
+         *
+         * Pops up to `maxMessages` messages from the pending queue without blocking
+         * and processes each one. Alerts are dispatched before regular messages.
+         *
+         * @param maxMessages Maximum number of messages to dispatch in this call.
+         * @return The number of messages dispatched.
+         */
+        std::size_t dispatchPending(std::size_t maxMessages);
+
+        /**
+         * @brief Sets the event loop used by asynchronous handlers.
+         *
+         * Asynchronous handlers suspend on this loop instead of blocking the
+         * dispatching thread. Without a loop they run to completion inline.
+         *
+         * @param loop The server's event loop, or `nullptr` to run handlers inline.
+         */
+        void setEventLoop(EventLoop* loop);
+
+        /**
+         * @brief Sets the authentication module used to check senders.
+         *
+         * With a module set, LOGIN messages are verified by password or session token,
+         * and inventory and subscription messages are only processed for authorized
+         * senders. Without one, messages are processed unchecked.
+         *
+         * @param auth The server's authentication module, or `nullptr` to skip checks.
+         */
+        void setAuthentication(Authentication* auth);
+
+        /**
+         * @brief Sets the network manager used to answer LOGIN messages.
+         *
+         * A successful login is answered with the session token the client can attach,
+         * as a "token" field, to later messages instead of being re-checked.
+         *
+         * @param manager The server's network manager, or `nullptr` to send no replies.
+         */
+        void setNetworkManager(NetworkManager* manager);
+
+        /**
+         * @brief Sets the heartbeat monitor fed by HEARTBEAT messages.
+         *
+         * With a monitor set, every client that sends a message is registered for
+         * heartbeats and its PONG answers are timed. PING messages from clients are
+         * answered with a PONG whether or not a monitor is set.
+         *
+         * @param monitor The server's heartbeat monitor, or `nullptr` to time nothing.
+         */
+        void setHeartbeatMonitor(HeartbeatMonitor* monitor);
+
+        /**
+         * @brief Sets the inventory that history requests read.
+         *
+         * A history request is answered with the sender's transactions from
+         * `InventoryManager::getTransactionHistory`, `DispatcherConstants::HISTORY_PAGE_SIZE`
+         * per reply.
+         *
+         * @param inventory The server's inventory manager, or `nullptr` to ignore inventory messages.
+         */
+        void setInventoryManager(InventoryManager* inventory);
+
+        /**
+         * @brief Sets the notification system that relays alerts.
+         *
+         * An alert from an authorized sender is broadcast to every registered client with
+         * `NotificationSystem::broadcastAlert`. Without a notification system alerts are
+         * discarded.
+         *
+         * @param notifications The server's notification system, or `nullptr` to relay nothing.
+         */
+        void setNotificationSystem(NotificationSystem* notifications);
+
+        /**
+         * @brief Prepares the per-client state of a new connection.
+         *
+         * Publishes the connection's status with `Authentication::openConnection`.
+         *
+         * @param clientID The connection's client ID.
+         */
+        void registerClient(int clientID);
+
+        /**
+         * @brief Releases the per-client state of a closed connection.
+         *
+         * Logs the connection out with `Authentication::closeConnection`.
+         *
+         * @param clientID The connection's client ID.
+         */
+        void removeClient(int clientID);
+
     private:
-        std::queue<Message> *pendingMessages;
+        MessageQueue *pendingMessages;
+        EventLoop *eventLoop = nullptr;
+        Authentication *authentication = nullptr;
+        NetworkManager *networkManager = nullptr;
+        HeartbeatMonitor *heartbeatMonitor = nullptr;
+        InventoryManager *inventoryManager = nullptr;
+        NotificationSystem *notificationSystem = nullptr;
+
+        /**
+         * @brief Checks whether the sender of a message may use authenticated services.
+         *
+         * A valid "token" field is enough; otherwise the sender must be logged in.
+         *
+         * @param msg The received message.
+         * @return `true` if the sender is authorized or no authentication module is set.
+         */
+        bool isSenderAuthorized(Message* msg);
+
+        /**
+         * @brief Answers a LOGIN message.
+         * @param clientID The client to answer.
+         * @param token The session token, or an empty string if the login was denied.
+         */
+        void sendLoginReply(int clientID, const std::string& token);
+
         // Server *server;
         void processReceivedAlert(Message* msg);
 
@@ -23,6 +151,9 @@ class MessageDispatcher {
         void processLogout(Message* msg);
 
 
+        void processHeartbeat(Message* msg);
+
+
         void ProcessSubscriptions(Message* msg);
 
 
@@ -32,5 +163,15 @@ class MessageDispatcher {
         void ProcessInventoryInfoRequest(Message* msg);
 
 
-      void ProcessTransactionHistoryRequest(Message* msg);
+        /**
+         * @brief Answers a transaction history request.
+         *
+         * The handler continues on the event loop and yields to it between pages,
+         * so a long history does not hold up the messages of other clients. Each page
+         * is sent once the previous one has been written to the client, and the
+         * reply stops if the client is closed meanwhile.
+         *
+         * @param msg The received request.
+         */
+        AsyncTask ProcessTransactionHistoryRequest(Message* msg);
 };
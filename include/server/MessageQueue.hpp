@@ -0,0 +1,195 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include "Message.hpp"
+
+namespace MessageQueueConstants {
+    constexpr std::size_t DEFAULT_CAPACITY = 1024; /**< Default maximum number of pending messages. */
+    constexpr int BUSY_RETRY_AFTER_MS = 500; /**< Retry hint sent to clients in a busy reply. */
+}
+
+/**
+ * @class MessageQueue
+ * @brief Bounded, thread-safe queue of messages pending dispatch.
+ *
+ * The queue holds at most `capacity` messages. When it is full, the configured
+ * overflow policy decides what happens to a new message: the producer can be
+ * blocked until there is room, the oldest non-critical message can be shed, or
+ * the new message can be rejected so the caller replies with a "busy" message.
+ *
+ * Critical messages (alerts) are kept in their own lane, are dispatched before
+ * regular messages and are never shed to make room for other messages.
+ * Counters for accepted, dispatched, shed and rejected messages are kept so
+ * overload can be observed.
+ */
+class MessageQueue {
+    public:
+        /**
+         * @enum OverflowPolicy
+         * @brief Behaviour of `push` when the queue is full.
+         */
+        enum class OverflowPolicy {
+            BLOCK,       ///< Block the producer until there is room or the queue is closed.
+            DROP_OLDEST, ///< Shed the oldest non-critical message to make room.
+            REJECT_BUSY  ///< Reject the new message; the caller should reply with a busy message.
+        };
+
+        /**
+         * @enum PushResult
+         * @brief Outcome of a `push` operation.
+         */
+        enum class PushResult {
+            ACCEPTED,       ///< The message was queued.
+            DROPPED_OLDEST, ///< The message was queued after shedding an older one.
+            REJECTED,       ///< The message was not queued because the queue is full.
+            CLOSED          ///< The message was not queued because the queue is closed.
+        };
+
+        /**
+         * @struct Stats
+         * @brief Snapshot of the queue counters.
+         */
+        struct Stats {
+            std::uint64_t accepted; /**< Messages queued. */
+            std::uint64_t dispatched; /**< Messages removed by `pop`/`waitAndPop`. */
+            std::uint64_t shed; /**< Messages dropped to make room for newer ones. */
+            std::uint64_t rejected; /**< Messages refused because the queue was full. */
+            std::uint64_t blockedPushes; /**< Pushes that had to wait for room. */
+            std::size_t highWaterMark; /**< Largest number of messages held at once. */
+        };
+
+        /**
+         * @brief Constructs a bounded message queue.
+         *
+         * @param capacity Maximum number of messages held at once. Must be greater than 0.
+         * @param policy Behaviour when the queue is full.
+         * @throws std::invalid_argument If `capacity` is 0.
+         */
+        explicit MessageQueue(std::size_t capacity = MessageQueueConstants::DEFAULT_CAPACITY,
+                              OverflowPolicy policy = OverflowPolicy::DROP_OLDEST);
+
+        /**
+         * @brief Adds a message to the queue, applying the overflow policy if it is full.
+         *
+         * @param msg The message to queue. Ownership is transferred to the queue.
+         * @return The outcome of the operation.
+         */
+        PushResult push(Message msg);
+
+        /**
+         * @brief Removes the next message without waiting.
+         *
+         * Critical messages are returned before regular ones.
+         *
+         * @return The next message, or `std::nullopt` if the queue is empty.
+         */
+        std::optional<Message> pop();
+
+        /**
+         * @brief Removes the next message, waiting up to `timeout` for one to arrive.
+         *
+         * @param timeout Maximum time to wait.
+         * @return The next message, or `std::nullopt` on timeout or if the queue is closed and empty.
+         */
+        std::optional<Message> waitAndPop(std::chrono::milliseconds timeout);
+
+        /**
+         * @brief Closes the queue.
+         *
+         * Further pushes are refused and blocked producers and consumers are woken up.
+         * Messages already queued can still be popped.
+         */
+        void close();
+
+        /**
+         * @brief Checks if the queue has been closed.
+         * @return `true` if the queue is closed, `false` otherwise.
+         */
+        [[nodiscard]] bool isClosed() const;
+
+        /**
+         * @brief Gets the number of messages currently queued.
+         * @return The number of queued messages.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+        /**
+         * @brief Checks if the queue is empty.
+         * @return `true` if no messages are queued, `false` otherwise.
+         */
+        [[nodiscard]] bool empty() const;
+
+        /**
+         * @brief Gets the maximum number of messages the queue can hold.
+         * @return The queue capacity.
+         */
+        [[nodiscard]] std::size_t getCapacity() const;
+
+        /**
+         * @brief Gets the current overflow policy.
+         * @return The overflow policy.
+         */
+        [[nodiscard]] OverflowPolicy getPolicy() const;
+
+        /**
+         * @brief Changes the overflow policy.
+         *
+         * Producers blocked under the `BLOCK` policy are woken up so the new policy applies to them.
+         *
+         * @param newPolicy The new overflow policy.
+         */
+        void setPolicy(OverflowPolicy newPolicy);
+
+        /**
+         * @brief Gets a snapshot of the queue counters.
+         * @return The current counters.
+         */
+        [[nodiscard]] Stats getStats() const;
+
+        /**
+         * @brief Checks if a message is critical and must never be shed.
+         *
+         * @param msg The message to check.
+         * @return `true` if the message is an alert, `false` otherwise.
+         */
+        static bool isCritical(const Message& msg);
+
+        /**
+         * @brief Builds the reply sent to a client whose message was rejected.
+         *
+         * @param clientID The unique identifier of the client.
+         * @return A `STATUS`/`BUSY` message with a retry hint.
+         */
+        static Message makeBusyReply(int clientID);
+
+    private:
+        /**
+         * @brief Gets the total number of queued messages. The mutex must be held.
+         * @return The number of queued messages.
+         */
+        [[nodiscard]] std::size_t sizeLocked() const;
+
+        /**
+         * @brief Removes the next message. The mutex must be held and the queue must not be empty.
+         * @return The next message.
+         */
+        Message popLocked();
+
+        std::size_t capacity; /**< Maximum number of messages held at once. */
+        OverflowPolicy policy; /**< Behaviour when the queue is full. */
+        bool closed; /**< Whether the queue has been closed. */
+
+        std::deque<Message> criticalMessages; /**< Alerts, dispatched first and never shed. */
+        std::deque<Message> regularMessages; /**< All other messages, in arrival order. */
+        Stats stats; /**< Queue counters. */
+
+        mutable std::mutex mutex; /**< Protects all queue state. */
+        std::condition_variable notEmpty; /**< Signalled when a message is queued or the queue closes. */
+        std::condition_variable notFull; /**< Signalled when room is made or the policy changes. */
+};
@@ -5,6 +5,8 @@ enum class MessageType {
     NOTIFICATION,
     INVENTORY,
     CREDENTIALS,
+    STATUS,
+    HEARTBEAT,
 };
 
 enum class AlertSubType {
@@ -31,3 +33,12 @@ enum class CredentialSubType {
     LOGOUT,
     SUBSCRIPTION
 };
+
+enum class StatusSubType {
+    BUSY
+};
+
+enum class HeartbeatSubType {
+    PING,
+    PONG
+};
@@ -1,11 +1,32 @@
 #pragma once
 
-#include <map>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include "ClientConnection.hpp"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "ConnectionTable.hpp"
+#include "EventLoop.hpp"
+#include "IoUring.hpp"
 #include "Message.hpp"
+#include "ReliableChannel.hpp"
+#include "TimerWheel.hpp"
 #include <vector>
 
+namespace NetworkConstants {
+    constexpr std::size_t MAX_IOV_PER_WRITE = 64; /**< Queued messages gathered into one vectored TCP write. */
+    constexpr std::size_t UDP_BATCH_SIZE = 64; /**< Datagrams sent by one `sendmmsg` call. */
+    constexpr std::chrono::milliseconds DEFAULT_IDLE_TIMEOUT{5 * 60 * 1000}; /**< Silence after which a client is closed. */
+    constexpr std::chrono::milliseconds IDLE_TIMER_TICK{100}; /**< Resolution of the idle timers. */
+    constexpr int DEFAULT_LISTEN_BACKLOG = 4096; /**< Pending connections per TCP listener; capped by `net.core.somaxconn`. */
+}
+
 /**
  * @brief Handles network communication between the server and clients.
  *
@@ -14,6 +35,51 @@
  */
 class NetworkManager {
     public:
+        /**
+         * @brief How TCP connections are accepted, read and written.
+         */
+        enum class IoBackend {
+            EPOLL,   ///< Non-blocking system calls per operation, with readiness from the event loop.
+            IO_URING ///< Multishot accept and receive plus linked sends on an io_uring instance.
+        };
+
+        /**
+         * @brief What to do with a client whose outbound queue reaches its high-water mark.
+         */
+        enum class SlowClientPolicy {
+            REJECT,    ///< Refuse new messages for the client until its queue drains (backpressure).
+            DISCONNECT ///< Close the connection to the client.
+        };
+
+        /**
+         * @brief Counters describing outbound queue pressure.
+         */
+        struct OutboundStats {
+            std::size_t rejectedMessages; ///< Messages refused because a queue was over its high-water mark.
+            std::size_t slowClientDisconnects; ///< Connections closed because a queue was over its high-water mark.
+        };
+
+        /**
+         * @class DrainAwaiter
+         * @brief Awaitable that resumes the coroutine once a client's outbound queue is written.
+         *
+         * Must be awaited on the loop thread. The coroutine is resumed from the event loop
+         * when the last queued byte is handed to the kernel or the client is closed, and
+         * right away if nothing is queued or there is no event loop. `co_await` yields
+         * whether the client is still open.
+         */
+        class DrainAwaiter {
+            public:
+                DrainAwaiter(NetworkManager* manager, int clientID) : manager(manager), clientID(clientID) {}
+                [[nodiscard]] bool await_ready() const;
+                void await_suspend(std::coroutine_handle<> handle) const;
+                [[nodiscard]] bool await_resume() const;
+
+            private:
+                NetworkManager* manager; ///< Manager owning the client's queue.
+                int clientID; ///< Client whose output is awaited.
+        };
+
         /**
          * @brief Constructs a new NetworkManager object.
          *
@@ -21,24 +87,68 @@ class NetworkManager {
          */
         NetworkManager();
 
+        /**
+         * @brief Closes every socket still open, without calling the close handler.
+         */
+        ~NetworkManager();
+
+        NetworkManager(const NetworkManager&) = delete;
+        NetworkManager& operator=(const NetworkManager&) = delete;
+
         /**
          * @brief Initializes the server sockets for both IPv4 and IPv6, TCP and UDP.
          *
+         * With the `IO_URING` backend, multishot accepts are armed on both TCP sockets.
+         * If the kernel does not provide io_uring, the manager falls back to `EPOLL`.
+         *
          * @param port The port number to bind the sockets to.
+         * @param backend The I/O backend for TCP connections.
+         * @throws std::runtime_error If a socket cannot be created, bound or put in listening mode.
          */
-        void initialize(int port);
+        void initialize(int port, IoBackend backend = IoBackend::EPOLL);
+
+        /**
+         * @brief Gets the I/O backend in use.
+         * @return The backend chosen at `initialize`, or `EPOLL` after a fallback.
+         */
+        [[nodiscard]] IoBackend getIoBackend() const;
 
         /**
          * @brief Listens for incoming TCP connections.
          *
-         * Accepts new client connections on the TCP IPv4 socket and adds them to the active clients list.
+         * Waits until either TCP socket (IPv4 or IPv6) has pending connections, then accepts
+         * every connection queued on both and adds them to the active clients list. Accepted
+         * sockets are non-blocking. With the `IO_URING` backend, waits for the ring's accepts.
+         *
+         * @param timeoutMs Maximum time to wait, in milliseconds. -1 waits indefinitely; 0 only drains.
+         * @return The number of connections accepted.
+         */
+        std::size_t listenForConnections(int timeoutMs = -1);
+
+        /**
+         * @brief Processes io_uring completions (`IO_URING` backend only).
+         *
+         * Registers accepted connections and arms a multishot receive on each, stores
+         * received data for `receiveTCPMessage`, continues linked sends and closes
+         * connections the peer closed. After `startReceiving`, the event loop calls
+         * this whenever the ring has completions.
+         *
+         * @param timeoutMs Maximum time to wait for a completion, in milliseconds. -1 waits indefinitely.
+         * @return The clients with received data waiting; empty with the `EPOLL` backend.
          */
-        void listenForConnections();
+        std::vector<int> processCompletions(int timeoutMs);
 
         /**
          * @brief Receives incoming UDP messages.
          *
-         * Processes messages received on both IPv4 and IPv6 UDP sockets and sends acknowledgment responses.
+         * Drains up to `NetworkConstants::UDP_BATCH_SIZE` datagrams from each of the IPv4 and
+         * IPv6 UDP sockets. Plain datagrams are answered with an "Acknowledged" datagram each.
+         *
+         * A peer that sends sequenced datagrams (see `ReliableChannel`) is in reliable mode:
+         * duplicates are dropped before they are parsed or returned, one ACK per peer
+         * covers the whole batch, ACKs from the peer release retransmission state, and
+         * messages sent to the peer are sequenced and kept until acknowledged.
+         * Malformed datagrams are dropped.
          *
          * @return A vector of `Message` objects containing the received messages.
          */
@@ -48,16 +158,124 @@ class NetworkManager {
          * @brief Sends a message to a specific client.
          *
          * This function sends a message to the client identified by the `clientID` field in the `Message` object.
-         * It determines the appropriate protocol (TCP or UDP) and sends the message accordingly.
+         * The serialized message is appended to the client's outbound queue and written as far as the socket
+         * accepts without blocking; the rest is written when the socket becomes writable again.
          * If the client is not found in the active clients list, the function does nothing.
          *
          * @param msg The message to be sent, represented as a `Message` object. The `clientID` field must be set.
          */
         void sendMessage(const Message& msg);
 
+        /**
+         * @brief Sends an already serialized message to a specific client.
+         *
+         * The payload is queued on the client's outbound queue and flushed immediately as far as the
+         * socket accepts without blocking. When the queue would exceed the client's high-water mark,
+         * the slow client policy applies. When an event loop is set and the caller is not on it,
+         * the work is posted to the loop.
+         * If the client is not found in the active clients list, the function does nothing.
+         *
+         * @param clientID The unique identifier of the recipient.
+         * @param payload The serialized message.
+         * @return `true` if the payload was queued, or handed to the event loop for an open client;
+         *         `false` otherwise.
+         */
+        bool sendPayload(int clientID, const SharedPayload& payload);
+
+        /**
+         * @brief Sends one serialized message to many clients.
+         *
+         * The payload is serialized by the caller once and shared by every send.
+         * It is queued on each recipient's outbound queue and the queues are flushed
+         * with batched writes. When an event loop is set, both steps run on the loop
+         * and the caller only posts the work; otherwise they run inline.
+         * Clients that are not in the active clients list are skipped.
+         *
+         * @param clientIDs The unique identifiers of the recipients.
+         * @param payload The serialized message.
+         * @return The number of clients the payload was queued for, or the number of
+         *         recipients handed to the event loop.
+         */
+        std::size_t broadcastPayload(const std::vector<int>& clientIDs, const SharedPayload& payload);
+
+        /**
+         * @brief Queues a serialized message on the outbound queue of many clients.
+         *
+         * Nothing is written until `flushOutbound` runs.
+         *
+         * @param clientIDs The unique identifiers of the recipients.
+         * @param payload The serialized message.
+         * @return The number of clients the payload was queued for.
+         */
+        std::size_t queuePayload(const std::vector<int>& clientIDs, const SharedPayload& payload);
+
+        /**
+         * @brief Writes queued output for every client that has some.
+         *
+         * TCP clients are written with one vectored `sendmsg` per connection covering
+         * all their queued messages. UDP clients sharing a server socket are written
+         * together with `sendmmsg`, many datagrams per call. Output a socket does not
+         * accept right now stays queued for the next flush.
+         *
+         * @return The number of messages completely written.
+         */
+        std::size_t flushOutbound();
+
+        /**
+         * @brief Sets the event loop that performs fan-out writes.
+         *
+         * @param loop The server's I/O loop, or `nullptr` to write from the caller's thread.
+         */
+        void setEventLoop(EventLoop* loop);
+
+        /**
+         * @brief Sets what happens to clients whose outbound queue reaches its high-water mark.
+         * @param policy The slow client policy. Defaults to `DISCONNECT`.
+         */
+        void setSlowClientPolicy(SlowClientPolicy policy);
+
+        /**
+         * @brief Sets the limit of queued outbound bytes for a client.
+         *
+         * @param clientID The unique identifier of the client.
+         * @param bytes The new high-water mark, in bytes.
+         * @return `true` if the client exists, `false` otherwise.
+         */
+        bool setHighWaterMark(int clientID, std::size_t bytes);
+
+        /**
+         * @brief Checks if a client's outbound queue has unwritten data.
+         *
+         * Producers can use this to slow down before the high-water mark is reached.
+         *
+         * @param clientID The unique identifier of the client.
+         * @return `true` if the client has queued output, `false` otherwise.
+         */
+        [[nodiscard]] bool hasPendingOutput(int clientID) const;
+
+        /**
+         * @brief Returns an awaitable that resumes the coroutine when a client's output is written.
+         *
+         * Lets a coroutine producing a long reply send it in parts without letting the
+         * client's queue grow towards its high-water mark.
+         *
+         * @param clientID The unique identifier of the client.
+         * @return The awaitable.
+         */
+        DrainAwaiter drained(int clientID);
+
+        /**
+         * @brief Gets the outbound queue pressure counters.
+         * @return The current counters.
+         */
+        [[nodiscard]] OutboundStats getOutboundStats() const;
+
         /**
          * @brief Receives a message from a specific client.
          *
+         * With the `IO_URING` backend, returns the oldest data received for a TCP client,
+         * processing completions until some arrives or the connection closes.
+         *
          * @param clientID The unique identifier of the client to receive the message from.
          * @return An optional `Message` object containing the received message, or `std::nullopt` if no message was received.
          */
@@ -70,6 +288,128 @@ class NetworkManager {
          * @param clientID The unique identifier of the client whose connection should be closed.
          */
         void closeConnection(int clientID);
+
+        /**
+         * @brief Reads the server sockets and client connections on the event loop.
+         *
+         * New connections are accepted, and UDP datagrams and TCP data are read, as their
+         * sockets become readable; with the `IO_URING` backend the ring's completions are
+         * processed instead. Every received message is passed to `handler` on the loop
+         * thread with the sender's client ID set. A TCP client that hangs up is closed.
+         *
+         * @param handler Called with each received message.
+         * @return `true` if the sockets are being read, `false` if no event loop is set.
+         */
+        bool startReceiving(std::function<void(Message)> handler);
+
+        /**
+         * @brief Sets a function called after a connection is closed.
+         *
+         * Lets the owners of per-client state, such as subscriptions and inventory,
+         * release it whatever the reason for the close.
+         *
+         * @param handler Called with the client ID, or an empty function for none.
+         */
+        void setCloseHandler(std::function<void(int)> handler);
+
+        /**
+         * @brief Sets a function called when a connection is registered.
+         *
+         * Runs before any message of the connection is delivered, so per-client state
+         * can be set up for the new client ID.
+         *
+         * @param handler Called with the client ID, or an empty function for none.
+         */
+        void setOpenHandler(std::function<void(int)> handler);
+
+        /**
+         * @brief Sets how long a client may stay silent before it is closed.
+         *
+         * Open connections are rescheduled against the new timeout.
+         *
+         * @param timeout The idle timeout, or zero to keep idle clients open.
+         */
+        void setIdleTimeout(std::chrono::milliseconds timeout);
+
+        /**
+         * @brief Sets how many pending connections each TCP socket queues before refusing more.
+         *
+         * Applies to sockets created by later `initialize` calls and to the open ones.
+         *
+         * @param backlog The listen backlog; the kernel caps it at `net.core.somaxconn`.
+         * @throws std::invalid_argument If the backlog is not positive.
+         */
+        void setListenBacklog(int backlog);
+
+        /**
+         * @brief Closes the TCP listening sockets so no new connection is accepted.
+         *
+         * Open connections and the UDP sockets stay usable.
+         */
+        void stopAccepting();
+
+        /**
+         * @brief Writes queued output until every client's queue is empty or the deadline passes.
+         *
+         * @param deadline When to give up on clients that are not reading.
+         * @return `true` if all queued output was written.
+         */
+        bool drainOutbound(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * @brief Closes every connection, calling the close handler for each, then the server sockets.
+         */
+        void closeAll();
+
+        /**
+         * @brief Closes the clients that have been silent for the idle timeout.
+         *
+         * Each client has one timer on a hierarchical timer wheel, set for its last
+         * activity plus the timeout. Receiving from a client only records the time;
+         * when the timer fires, a client that was heard from in the meantime is
+         * rescheduled instead of closed. Each call therefore costs O(1) per elapsed
+         * tick plus the timers that fire. The server calls it about once per
+         * `NetworkConstants::IDLE_TIMER_TICK`.
+         *
+         * @param now The current time.
+         * @return The number of connections closed.
+         */
+        std::size_t reapIdleConnections(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+        /**
+         * @brief Resends the datagrams of reliable UDP peers whose retransmission timer expired.
+         *
+         * Peers that leave a datagram unacknowledged through
+         * `ReliableChannelConstants::MAX_TRANSMISSIONS` sends are closed. The server calls
+         * this about as often as `reapIdleConnections`.
+         *
+         * @param now The current time.
+         * @return The number of datagrams resent.
+         */
+        std::size_t retransmitReliable(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+        /**
+         * @brief Gets the number of datagrams a reliable UDP peer has not acknowledged.
+         * @param clientID The unique identifier of the client.
+         * @return The number of unacknowledged datagrams, or 0 if the client is not in reliable mode.
+         */
+        [[nodiscard]] std::size_t getUnacknowledged(int clientID) const;
+
+        /**
+         * @brief Gets the network address of a client, without the port.
+         *
+         * Used as the source key for login rate limits.
+         *
+         * @param clientID The unique identifier of the client.
+         * @return The numeric host address, or an empty string if the client is unknown.
+         */
+        [[nodiscard]] std::string getClientHost(int clientID) const;
+
+        /**
+         * @brief Gets the number of open client connections.
+         * @return The number of TCP and UDP clients in the active clients list.
+         */
+        [[nodiscard]] std::size_t getConnectionCount() const;
     private:
         /**
          * @brief Sets up a socket for communication.
@@ -80,16 +420,204 @@ class NetworkManager {
          * @param family The address family (e.g., AF_INET for IPv4, AF_INET6 for IPv6).
          * @param type The socket type (e.g., SOCK_STREAM for TCP, SOCK_DGRAM for UDP).
          * @param port The port number to bind the socket to.
+         * @throws std::runtime_error If a step fails; the socket is closed and `socketFd` is -1.
          */
         void setupSocket(int& socketFd, int family, int type, int port);
 
+        /**
+         * @brief Closes the four server sockets that are open.
+         */
+        void closeServerSockets();
+
+        /**
+         * @brief Removes the server sockets from the event loop before they are closed.
+         */
+        void unwatchServerSockets();
+
+        /**
+         * @brief Reads a TCP client on the event loop once `startReceiving` was called.
+         * @param client The connection.
+         */
+        void watchReadable(const ClientConnection& client);
+
+        /**
+         * @brief Reads what a TCP client sent and delivers it; closes the client on hang-up.
+         * @param clientID The client ID.
+         */
+        void readStream(int clientID);
+
+        /**
+         * @brief Parses received data and passes the message to the receive handler.
+         *
+         * @param clientID The sender.
+         * @param data The received bytes; data that is not a message is dropped.
+         */
+        void deliver(int clientID, const std::string& data);
+
+        /**
+         * @brief Accepts every connection queued on a listening socket.
+         * @param listenFd The listening socket.
+         * @return The number of connections accepted.
+         */
+        std::size_t acceptPending(int listenFd);
+
+        /**
+         * @brief Adds an accepted TCP connection; with the `IO_URING` backend, also arms its receive.
+         *
+         * @param clientSock The accepted socket.
+         * @param clientAddr The peer address.
+         * @param addrLen The length of the peer address.
+         * @return The client ID, or -1 if the connection table is full and the socket was closed.
+         */
+        int registerAccepted(int clientSock, const sockaddr_storage& clientAddr, socklen_t addrLen);
+
+        /**
+         * @brief Handles the completion of one linked send.
+         * @param clientID The unique identifier of the client.
+         * @param result The bytes written, or a negated `errno`.
+         */
+        void completeRingSend(int clientID, int result);
+
+        /**
+         * @brief Starts a chain of linked sends covering a TCP client's queued output.
+         *
+         * Does nothing while a previous chain of the client is in flight.
+         *
+         * @param client The connection to flush.
+         */
+        void flushStreamRing(ClientConnection& client);
+
+        /**
+         * @brief Queues a payload on a client, applying its high-water mark.
+         *
+         * @param clientID The unique identifier of the client.
+         * @param client The client connection.
+         * @param payload The serialized message.
+         * @return `true` if the payload was queued, `false` if it was refused.
+         */
+        bool enqueueOutbound(int clientID, ClientConnection& client, const SharedPayload& payload);
+
+        /**
+         * @brief Records a sequenced datagram from a reliable UDP peer.
+         *
+         * @param clientID The unique identifier of the peer.
+         * @param sequence The sequence number of the datagram.
+         * @param acksDue Peers owed an ACK at the end of the batch; the peer is added once.
+         * @return `true` if the datagram is new and must be delivered.
+         */
+        bool acceptSequenced(int clientID, std::uint64_t sequence, std::vector<int>& acksDue);
+
+        /**
+         * @brief Writes a single client's queued output and arms write readiness if some is left.
+         * @param clientID The unique identifier of the client.
+         */
+        void flushClient(int clientID);
+
+        /**
+         * @brief Resumes the coroutines awaiting `drained` for a client with nothing left to write.
+         *
+         * The coroutines are resumed from a posted callback, never from inside a flush.
+         *
+         * @param clientID The client whose queue was written or which was closed.
+         */
+        void resumeDrained(int clientID);
+
+        /**
+         * @brief Asks the event loop to flush again once `fd` becomes writable.
+         *
+         * Does nothing without an event loop or if the descriptor is already being watched.
+         *
+         * @param fd The client TCP socket or the server UDP socket with blocked output.
+         */
+        void watchWritable(int fd);
+
+        /**
+         * @brief Stops waiting for write readiness on a descriptor.
+         * @param fd The watched descriptor.
+         */
+        void unwatchWritable(int fd);
+
+        /**
+         * @brief Checks if a client ID is open; safe to call from any thread.
+         * @param clientID The client ID.
+         * @return `true` if the client is in the active clients list.
+         */
+        [[nodiscard]] bool isOpen(int clientID) const;
+
+        /**
+         * @brief Closes every connection in the list that is marked as disconnected.
+         * @param clientIDs The clients to check.
+         */
+        void closeDisconnected(const std::vector<int>& clientIDs);
+
+        /**
+         * @brief Writes as much queued output as a TCP connection accepts.
+         *
+         * @param client The connection to flush.
+         * @return The number of messages completely written.
+         */
+        static std::size_t flushStream(ClientConnection& client);
+
+        /**
+         * @brief Writes queued datagrams of the UDP clients sharing a server socket.
+         *
+         * @param socketFd The server UDP socket.
+         * @param clients The clients with queued output on that socket.
+         * @return The number of datagrams sent.
+         */
+        static std::size_t flushDatagrams(int socketFd, const std::vector<ClientConnection*>& clients);
+
+        /**
+         * @brief Posts a single `flushOutbound` to the event loop unless one is already pending.
+         */
+        void scheduleFlush();
+
+        /**
+         * @brief Arms the idle timer of a client.
+         * @param client The connection.
+         */
+        void scheduleIdleTimer(const ClientConnection& client);
+
         int serverSocketTCPv4; ///< File descriptor for the IPv4 TCP socket.
         int serverSocketUDPv4; ///< File descriptor for the IPv4 UDP socket.
         int serverSocketTCPv6; ///< File descriptor for the IPv6 TCP socket.
         int serverSocketUDPv6; ///< File descriptor for the IPv6 UDP socket.
 
-        std::map<int, ClientConnection> activeClients; ///< Map of active client connections.
-        int nextClientID; ///< Counter for assigning unique client IDs.
+        ConnectionTable activeClients; ///< Active client connections, by client ID.
+        mutable std::mutex openClientsMutex; ///< Protects `openClients`.
+        std::unordered_set<int> openClients; ///< IDs in `activeClients`, readable off the loop thread.
+        std::unordered_map<std::string, int> udpClientsByAddress; ///< UDP client IDs by raw peer address.
+        std::unordered_map<int, ReliableChannel> reliablePeers; ///< Sequencing state of UDP clients in reliable mode.
+
+        std::vector<int> pendingFlush; ///< Clients whose outbound queue has data to write.
+        EventLoop* eventLoop = nullptr; ///< Loop performing fan-out writes, if any.
+        bool flushScheduled = false; ///< Whether a flush is already posted to the event loop.
+        std::unordered_set<int> writeWatchedFds; ///< Descriptors waiting for `EPOLLOUT` to resume writing.
+        std::unordered_map<int, std::vector<std::coroutine_handle<>>> drainWaiters; ///< Coroutines awaiting `drained`, by client.
+        SlowClientPolicy slowClientPolicy = SlowClientPolicy::DISCONNECT; ///< Action when a high-water mark is reached.
+        OutboundStats outboundStats{}; ///< Outbound queue pressure counters.
+
+        /**
+         * @struct RingSendChain
+         * @brief Linked sends of a client that the kernel has not completed.
+         */
+        struct RingSendChain {
+            std::vector<SharedPayload> payloads; ///< Keeps the buffers alive until their sends complete.
+            std::size_t remaining; ///< Sends without a completion yet.
+        };
+
+        IoBackend ioBackend = IoBackend::EPOLL; ///< Backend for TCP connections.
+        std::unique_ptr<IoUring> ring; ///< The io_uring instance of the `IO_URING` backend.
+        std::size_t ringAccepted = 0; ///< Connections accepted through the ring.
+        std::unordered_map<int, std::deque<std::string>> ringInbound; ///< Data received through the ring, by client.
+        std::unordered_map<int, RingSendChain> ringSends; ///< Send chains in flight, by client.
+
+        int listenBacklog = NetworkConstants::DEFAULT_LISTEN_BACKLOG; ///< Pending connections per TCP socket.
+        std::chrono::milliseconds idleTimeout = NetworkConstants::DEFAULT_IDLE_TIMEOUT; ///< Silence before a client is closed; zero disables.
+        TimerWheel idleTimers{NetworkConstants::IDLE_TIMER_TICK}; ///< Idle timers by client ID.
+        std::function<void(int)> closeHandler; ///< Called after a connection is closed.
+        std::function<void(int)> openHandler; ///< Called when a connection is registered.
+        std::function<void(Message)> receiveHandler; ///< Called with each message read on the event loop.
 
 
 };
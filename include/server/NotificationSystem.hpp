@@ -1,15 +1,26 @@
 #pragma once
 
-#include <map>
-#include <set>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "server/NetworkManager.hpp"
 
+namespace NotificationConstants {
+    constexpr std::size_t NOTIFICATION_TYPE_COUNT = 4; /**< Number of values in `NotificationSubType`. */
+}
+
 /**
  * @brief Manages client subscriptions and sends notifications or alerts.
  *
  * The `NotificationSystem` class allows clients to subscribe to specific types of notifications
  * and provides methods to send targeted notifications or broadcast alerts to all clients.
+ *
+ * Subscriptions are kept as a per-client bitmask plus an inverted index holding, for each
+ * notification type, a dense array of the clients subscribed to it. Checking a subscription
+ * is a bit test and fanning out to a type is a contiguous iteration over its array.
  */
 class NotificationSystem {
     public:
@@ -63,11 +74,30 @@ class NotificationSystem {
          */
         void broadcastAlert(AlertSubType subType, const std::string& message);
 
+        /**
+         * @brief Sends a notification to every client subscribed to its type.
+         *
+         * @param type The notification type.
+         * @param message The notification message to be sent.
+         * @return The number of clients the notification was sent to.
+         */
+        std::size_t notifySubscribers(NotificationSubType type, const std::string& message);
+
+        /**
+         * @brief Gets the clients subscribed to a notification type.
+         *
+         * The order of the clients is unspecified and changes as clients unsubscribe.
+         *
+         * @param type The notification type.
+         * @return The identifiers of the subscribed clients; none for an unknown type.
+         */
+        [[nodiscard]] const std::vector<int>& getSubscribers(NotificationSubType type) const;
+
         /**
          * @brief Subscribes a client to a specific notification type.
          *
          * Adds the specified notification type to the client's subscription list.
-         * If the client is already subscribed, no changes are made.
+         * If the client is already subscribed, or the type is unknown, no changes are made.
          *
          * @param clientID Unique identifier of the client.
          * @param type The notification type to subscribe to.
@@ -96,7 +126,72 @@ class NotificationSystem {
          * @return `true` if the notification was successfully sent, `false` otherwise.
          */
         bool notify(const Message* msg);
+
+        /**
+         * @brief Sends a notification message to a specific client if they are subscribed.
+         *
+         * Builds the notification from the given type and text and sends it when the
+         * client is subscribed to that type.
+         *
+         * @param clientID Unique identifier of the client.
+         * @param type The notification type.
+         * @param message The notification message to be sent.
+         * @return `true` if the notification was successfully sent, `false` otherwise.
+         */
+        bool notify(int clientID, NotificationSubType type, const std::string& message);
     private:
-        std::map<int, std::set<NotificationSubType>> subscriptions; ///< Maps client IDs to their subscribed notification types.
+        using SubscriptionMask = std::uint8_t; ///< Bit `i` is set when subscribed to notification type `i`.
+
+        /**
+         * @brief Subscription state of a registered client.
+         */
+        struct ClientSubscriptions {
+            SubscriptionMask mask; ///< Notification types the client is subscribed to.
+            std::size_t clientSlot; ///< Position of the client in `clients`.
+            std::array<std::size_t, NotificationConstants::NOTIFICATION_TYPE_COUNT> typeSlots; ///< Position in each `subscribersByType` array, valid when the type bit is set.
+        };
+
+        /**
+         * @brief Checks if a value names a notification type.
+         * @param type The notification type, possibly cast from received data.
+         * @return `true` if it is below `NotificationConstants::NOTIFICATION_TYPE_COUNT`.
+         */
+        static bool isValidType(NotificationSubType type);
+
+        /**
+         * @brief Gets the mask bit of a notification type.
+         * @param type The notification type.
+         * @return The bit representing the type, or 0 for an unknown type.
+         */
+        static SubscriptionMask maskOf(NotificationSubType type);
+
+        /**
+         * @brief Registers a client with no subscriptions if it is not registered yet.
+         * @param clientID Unique identifier of the client.
+         * @return The subscription state of the client.
+         */
+        ClientSubscriptions& ensureRegistered(int clientID);
+
+        /**
+         * @brief Adds a client to the subscriber array of a type and sets its mask bit.
+         * @param clientID Unique identifier of the client.
+         * @param state The subscription state of the client.
+         * @param type The notification type.
+         */
+        void addToIndex(int clientID, ClientSubscriptions& state, NotificationSubType type);
+
+        /**
+         * @brief Removes a client from the subscriber array of a type and clears its mask bit.
+         *
+         * The last subscriber is moved into the freed position so the array stays dense.
+         *
+         * @param state The subscription state of the client.
+         * @param type The notification type.
+         */
+        void removeFromIndex(ClientSubscriptions& state, NotificationSubType type);
+
+        std::unordered_map<int, ClientSubscriptions> subscriptions; ///< Maps client IDs to their subscription state.
+        std::vector<int> clients; ///< Dense array of registered clients.
+        std::array<std::vector<int>, NotificationConstants::NOTIFICATION_TYPE_COUNT> subscribersByType; ///< Dense array of subscribers for each notification type.
         NetworkManager* networkManager; ///< Pointer to the `NetworkManager` for sending messages.
 };
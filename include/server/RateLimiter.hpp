@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace RateLimiterConstants {
+    constexpr std::size_t DEFAULT_MAX_KEYS = 65536; /**< Default number of keys a limiter tracks at once. */
+    constexpr std::size_t SHARDS = 64; /**< Independently locked parts of a limiter; a power of two. */
+    constexpr std::uint64_t MILLI = 1000; /**< Fixed-point scale of bucket levels; one token is 1000 units. */
+    constexpr int LEVEL_BITS = 24; /**< Bits of a bucket word holding the level; the rest hold the time. */
+    constexpr std::size_t EVICTION_PROBES = 8; /**< Oldest buckets a full shard checks for one that has refilled. */
+}
+
+/**
+ * @class RateLimiter
+ * @brief Token buckets keyed by an integer.
+ *
+ * Each key has its own bucket, a single word holding how far it is below full, in
+ * thousandths of a token, and the time of its last update in milliseconds. Refills
+ * are computed lazily from the elapsed time when a bucket is next used, so there is
+ * no timer or background thread.
+ *
+ * Keys are spread over `SHARDS` maps with a mutex each, so concurrent callers rarely
+ * wait for each other. The buckets are not lock-free atomics: adding and dropping keys
+ * changes the map, and a short per-shard lock keeps that and the bucket update together.
+ *
+ * A bucket that has refilled is the same as no bucket. When a shard reaches its share of
+ * `maxKeys`, it checks its `EVICTION_PROBES` oldest keys in insertion order, CLOCK-style:
+ * the first that has refilled is dropped, and the others move to the back of the order.
+ * If none has, the oldest remaining key is dropped, which can let it burst early. Making
+ * room therefore costs a bounded number of steps, whatever the number of keys.
+ */
+class RateLimiter {
+    public:
+        /**
+         * @struct Options
+         * @brief Bucket settings.
+         */
+        struct Options {
+            double tokensPerSecond = 1.0; /**< Refill rate of each bucket. */
+            double burst = 5.0; /**< Capacity of each bucket, and the tokens it starts with. */
+            std::size_t maxKeys = RateLimiterConstants::DEFAULT_MAX_KEYS; /**< Keys tracked before buckets are dropped. */
+        };
+
+        /**
+         * @brief Constructs a limiter with full buckets.
+         * @param options The bucket settings.
+         * @throws std::invalid_argument If the rate or burst is not positive, or the burst is too large.
+         */
+        explicit RateLimiter(const Options& options);
+
+        /**
+         * @brief Takes one token from the bucket of a key.
+         * @param key The key, e.g. a client ID or a hash of a source address.
+         * @return `true` if a token was available, `false` if the key is over its rate.
+         */
+        bool tryAcquire(std::uint64_t key);
+
+        /**
+         * @brief Takes one token from the bucket of a key at a given time.
+         * @param key The key.
+         * @param now The current time. Times before the last update of the bucket count as no elapsed time.
+         * @return `true` if a token was available, `false` if the key is over its rate.
+         */
+        bool tryAcquire(std::uint64_t key, std::chrono::steady_clock::time_point now);
+
+        /**
+         * @brief Gets the number of keys with a bucket.
+         * @return The tracked keys.
+         */
+        [[nodiscard]] std::size_t getTrackedKeys() const;
+
+    private:
+        /**
+         * @struct Shard
+         * @brief Buckets of the keys that map to one shard.
+         */
+        struct Shard {
+            mutable std::mutex mutex; /**< Protects `buckets`. */
+            std::unordered_map<std::uint64_t, std::uint64_t> buckets; /**< Deficit and last-update time by key. */
+            std::deque<std::uint64_t> order; /**< Keys of `buckets`, oldest first, for eviction. */
+        };
+
+        /**
+         * @brief Gets how far a bucket is below full after refilling it.
+         * @param word The bucket word.
+         * @param nowMs The current time in milliseconds since `origin`.
+         * @return The deficit in thousandths of a token.
+         */
+        [[nodiscard]] std::uint64_t deficitAt(std::uint64_t word, std::uint64_t nowMs) const;
+
+        /**
+         * @brief Makes room for a new key in a full shard by dropping one bucket.
+         *
+         * Must be called with the shard's mutex held.
+         *
+         * @param shard The shard.
+         * @param nowMs The current time in milliseconds since `origin`.
+         */
+        void evict(Shard& shard, std::uint64_t nowMs) const;
+
+        Options options; /**< Bucket settings. */
+        std::uint64_t capacity; /**< Bucket capacity in thousandths of a token. */
+        std::size_t keysPerShard; /**< Keys a shard tracks before it evicts. */
+        std::chrono::steady_clock::time_point origin; /**< Time zero of the bucket timestamps. */
+        std::array<Shard, RateLimiterConstants::SHARDS> shards; /**< Buckets, by shard. */
+};
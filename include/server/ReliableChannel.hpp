@@ -0,0 +1,193 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Message.hpp"
+
+namespace ReliableChannelConstants {
+    constexpr std::chrono::milliseconds INITIAL_RTO{1000}; /**< Retransmission timeout before the first RTT sample. */
+    constexpr std::chrono::milliseconds MIN_RTO{200}; /**< Lower bound of the retransmission timeout. */
+    constexpr std::chrono::milliseconds MAX_RTO{60000}; /**< Upper bound of the retransmission timeout. */
+    constexpr std::chrono::milliseconds CLOCK_GRANULARITY{1}; /**< Clock granularity G of RFC 6298. */
+    constexpr std::uint32_t MAX_TRANSMISSIONS = 8; /**< Sends of one datagram before the peer is given up. */
+    constexpr std::uint64_t RECEIVE_WINDOW = 1024; /**< Sequence numbers accepted ahead of the cumulative ACK. */
+    constexpr std::size_t MAX_SACK_RANGES = 8; /**< Selective ACK ranges reported in one ACK. */
+}
+
+/**
+ * @class ReliableChannel
+ * @brief Sequencing, acknowledgement and retransmission state of one datagram peer.
+ *
+ * A reliable datagram is a JSON message whose first member is its sequence number,
+ * `{"seq":N,...}`; sequence numbers start at 1 in each direction. The receiver answers
+ * with an ACK datagram `{"ack":C,"sack":[[a,b],...]}` where every number up to `C` has
+ * been received, as have the ranges `a..b` above it. One ACK covers every datagram
+ * received from the peer since the previous one.
+ *
+ * On the receiving side, `receive` reports duplicates so they are dropped before
+ * dispatching; datagrams are delivered in arrival order. A channel whose first datagram
+ * is already beyond the receive window belongs to a peer resuming its stream, e.g.
+ * after its previous channel was dropped by the idle reaper, and starts its window there. On the sending side, `send`
+ * numbers a payload and keeps it until it is acknowledged. Retransmission follows
+ * RFC 6298: a single timer per peer, the timeout derived from smoothed RTT samples,
+ * exponential backoff on expiry, and Karn's rule of not sampling retransmitted datagrams.
+ */
+class ReliableChannel {
+    public:
+        using Clock = std::chrono::steady_clock; ///< Clock of send times and timers.
+        using Range = std::pair<std::uint64_t, std::uint64_t>; ///< Inclusive range of sequence numbers.
+
+        /**
+         * @brief What to do with a received datagram.
+         */
+        enum class Delivery {
+            DELIVER,      ///< First copy; pass it on.
+            DUPLICATE,    ///< Already received; drop it.
+            OUT_OF_WINDOW ///< Too far ahead of the cumulative ACK; drop it so the peer resends it later.
+        };
+
+        /**
+         * @struct Ack
+         * @brief A parsed ACK datagram.
+         */
+        struct Ack {
+            std::uint64_t cumulative; ///< Every sequence number up to this one was received.
+            std::vector<Range> selective; ///< Ranges received above the cumulative ACK.
+        };
+
+        /**
+         * @brief Reads the sequence number of a reliable datagram.
+         * @param datagram The received datagram.
+         * @return The sequence number, or `std::nullopt` if the datagram is not sequenced.
+         */
+        static std::optional<std::uint64_t> parseSequence(const std::string& datagram);
+
+        /**
+         * @brief Parses an ACK datagram.
+         * @param datagram The received datagram.
+         * @return The ACK, or `std::nullopt` if the datagram is not an ACK.
+         */
+        static std::optional<Ack> parseAck(const std::string& datagram);
+
+        /**
+         * @brief Records a received sequence number.
+         *
+         * Every accepted sequence number, duplicates included, leaves an ACK pending so a
+         * peer whose ACK was lost learns that it can stop resending. Sequence 0 and numbers
+         * beyond the receive window are refused without an ACK. The first sequence number
+         * of the channel moves the window up to it if it lies beyond the window, and the
+         * numbers below it count as received.
+         *
+         * @param sequence The sequence number of the datagram.
+         * @return Whether to deliver the datagram.
+         */
+        Delivery receive(std::uint64_t sequence);
+
+        /**
+         * @brief Checks, without recording anything, if a sequence number was already received.
+         * @param sequence The sequence number of the datagram.
+         * @return `true` if `receive` would report the datagram as a duplicate.
+         */
+        [[nodiscard]] bool isDuplicate(std::uint64_t sequence) const;
+
+        /**
+         * @brief Checks if received datagrams have not been acknowledged yet.
+         * @return `true` if an ACK should be sent.
+         */
+        [[nodiscard]] bool hasPendingAck() const;
+
+        /**
+         * @brief Builds the ACK for everything received so far and clears the pending flag.
+         * @return The ACK datagram.
+         */
+        std::string takeAck();
+
+        /**
+         * @brief Numbers a payload and keeps it for retransmission.
+         *
+         * Starts the retransmission timer if it is not running.
+         *
+         * @param payload A serialized JSON message.
+         * @param now The time the payload is sent.
+         * @return The sequenced payload to put on the wire.
+         */
+        SharedPayload send(const SharedPayload& payload, Clock::time_point now);
+
+        /**
+         * @brief Applies an ACK from the peer.
+         *
+         * Acknowledged datagrams are released and the newest one sent only once is
+         * used as an RTT sample. The timer restarts if datagrams are still outstanding.
+         *
+         * @param ack The ACK.
+         * @param now The time the ACK arrived.
+         * @return The number of datagrams newly acknowledged.
+         */
+        std::size_t acknowledge(const Ack& ack, Clock::time_point now);
+
+        /**
+         * @brief Collects the datagram to resend if the retransmission timer expired.
+         *
+         * The oldest unacknowledged datagram is returned, the timeout is doubled and the
+         * timer restarted.
+         *
+         * @param now The current time.
+         * @return The payloads to resend; empty if the timer has not expired.
+         */
+        std::vector<SharedPayload> collectRetransmissions(Clock::time_point now);
+
+        /**
+         * @brief Checks if a datagram reached the transmission limit without being acknowledged.
+         * @return `true` if the peer should be given up.
+         */
+        [[nodiscard]] bool isExhausted() const;
+
+        /**
+         * @brief Gets the current retransmission timeout.
+         * @return The timeout.
+         */
+        [[nodiscard]] std::chrono::milliseconds getRto() const;
+
+        /**
+         * @brief Gets the number of datagrams waiting for an ACK.
+         * @return The number of unacknowledged datagrams.
+         */
+        [[nodiscard]] std::size_t getUnacknowledged() const;
+
+    private:
+        /**
+         * @struct Outstanding
+         * @brief A sent datagram waiting for its ACK.
+         */
+        struct Outstanding {
+            SharedPayload payload; ///< The sequenced payload.
+            Clock::time_point sentAt; ///< When it was first sent.
+            std::uint32_t transmissions; ///< Times it was sent.
+        };
+
+        /**
+         * @brief Updates the RTT estimate with a sample, as in RFC 6298 section 2.
+         * @param sample The measured round-trip time.
+         */
+        void sampleRtt(Clock::duration sample);
+
+        std::uint64_t receivedThrough = 0; ///< Every sequence number up to this one was received.
+        std::set<std::uint64_t> receivedAhead; ///< Sequence numbers received above `receivedThrough`.
+        bool ackPending = false; ///< Whether received datagrams await an ACK.
+        bool receiving = false; ///< Whether a datagram was accepted, fixing where the window starts.
+
+        std::uint64_t nextSequence = 1; ///< Sequence number of the next sent datagram.
+        std::map<std::uint64_t, Outstanding> unacknowledged; ///< Sent datagrams by sequence number.
+        std::optional<Clock::duration> smoothedRtt; ///< SRTT, once sampled.
+        Clock::duration rttVariance{}; ///< RTTVAR.
+        std::chrono::milliseconds rto = ReliableChannelConstants::INITIAL_RTO; ///< Current retransmission timeout.
+        std::optional<Clock::time_point> timerDeadline; ///< When the retransmission timer expires, if running.
+        bool exhausted = false; ///< Whether a datagram hit the transmission limit.
+};
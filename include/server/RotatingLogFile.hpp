@@ -0,0 +1,175 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace RotatingLogFileConstants {
+    constexpr std::size_t DEFAULT_SEGMENT_BYTES = 64 * 1024 * 1024; /**< Default size of a log segment. */
+    constexpr std::size_t MIN_SEGMENT_BYTES = 128 * 1024; /**< Smallest segment, so a writer batch always fits. */
+    constexpr std::size_t DEFAULT_KEEP_SEGMENTS = 5; /**< Default number of rotated segments kept. */
+}
+
+/**
+ * @class RotatingLogFile
+ * @brief Log file written through pre-allocated, memory-mapped segments.
+ *
+ * The blocks of the active segment are reserved up front with `fallocate` and
+ * `FALLOC_FL_KEEP_SIZE`, and the whole segment is mapped, so writing a record is a
+ * `memcpy` into the mapping. The file size only grows to cover each write, so the
+ * file at `<path>` never holds more than the written data and can be read while it
+ * is active. When the segment is full or older than the rotation interval, it is
+ * renamed to `<path>.1`, older segments shift to `<path>.2` and so on, and segments
+ * beyond the retention count are deleted. A non-empty file left at `<path>` by a
+ * previous run is rotated away when the file is opened.
+ *
+ * A segment whose blocks cannot be reserved, e.g. on a full disk, or that cannot be
+ * mapped is written with `pwrite` instead, and one that cannot be opened is retried
+ * on the next write. Bytes that could not be written are reported on `stderr` and
+ * counted by `getDroppedBytes`.
+ *
+ * The class is not thread-safe; `EventLogger` only uses it from its writer thread.
+ */
+class RotatingLogFile {
+    public:
+        /**
+         * @struct Options
+         * @brief Rotation and retention settings.
+         */
+        struct Options {
+            std::size_t segmentBytes = RotatingLogFileConstants::DEFAULT_SEGMENT_BYTES; /**< Size at which a segment is rotated. */
+            std::chrono::milliseconds interval{0}; /**< Age at which a segment is rotated; zero disables time-based rotation. */
+            std::size_t keepSegments = RotatingLogFileConstants::DEFAULT_KEEP_SEGMENTS; /**< Rotated segments kept on disk. */
+        };
+
+        /**
+         * @brief Opens the active segment.
+         *
+         * @param path The path of the active segment.
+         * @param options The rotation settings.
+         * @throws std::runtime_error If the segment cannot be created, allocated or mapped.
+         */
+        RotatingLogFile(const std::string& path, const Options& options);
+
+        /**
+         * @brief Releases the active segment's unused blocks and closes it.
+         */
+        ~RotatingLogFile();
+
+        RotatingLogFile(const RotatingLogFile&) = delete;
+        RotatingLogFile& operator=(const RotatingLogFile&) = delete;
+
+        /**
+         * @brief Appends bytes to the active segment.
+         *
+         * Rotates first if the data does not fit in the space left. Data larger than a
+         * whole segment is split across segments.
+         *
+         * @param data The bytes to write.
+         * @param length The number of bytes to write.
+         * @return `true` if every byte was written, `false` if some were dropped.
+         */
+        bool write(const char* data, std::size_t length);
+
+        /**
+         * @brief Rotates the active segment if it is older than the rotation interval.
+         *
+         * Segments that hold nothing beyond the preamble are not rotated.
+         *
+         * @return `true` if the segment was rotated.
+         */
+        bool rotateIfDue();
+
+        /**
+         * @brief Closes the active segment, shifts the rotated ones and opens a new one.
+         */
+        void rotate();
+
+        /**
+         * @brief Adds bytes written at the start of every new segment.
+         *
+         * Used to repeat the definitions a segment needs to be read on its own.
+         *
+         * @param bytes The bytes to add.
+         */
+        void appendPreamble(std::string_view bytes);
+
+        /**
+         * @brief Forgets the preamble.
+         */
+        void clearPreamble();
+
+        /**
+         * @brief Gets the path of a segment.
+         * @param index 0 for the active segment, 1 for the most recently rotated one, and so on.
+         * @return The path of the segment.
+         */
+        [[nodiscard]] std::string segmentPath(std::size_t index) const;
+
+        /**
+         * @brief Gets the number of bytes written to the active segment.
+         * @return The number of bytes.
+         */
+        [[nodiscard]] std::size_t getWrittenBytes() const;
+
+        /**
+         * @brief Gets the number of bytes that could not be written.
+         * @return The bytes dropped since the file was opened.
+         */
+        [[nodiscard]] std::size_t getDroppedBytes() const;
+
+    private:
+        /**
+         * @brief Creates, reserves and maps a new active segment and writes the preamble.
+         *
+         * A segment that cannot be reserved or mapped stays open unmapped.
+         *
+         * @return `true` if the segment was opened, `false` otherwise.
+         */
+        bool openSegment();
+
+        /**
+         * @brief Grows the active segment's file so it covers the mapped bytes up to `end`.
+         *
+         * @param end The offset just past the bytes about to be copied into the mapping.
+         * @return `true` if the file is at least `end` bytes long.
+         */
+        bool extendTo(std::size_t end);
+
+        /**
+         * @brief Writes bytes at the current offset with `pwrite`.
+         *
+         * @param data The bytes to write.
+         * @param length The number of bytes to write.
+         * @return `true` if every byte was written.
+         */
+        bool writeThrough(const char* data, std::size_t length);
+
+        /**
+         * @brief Counts and reports bytes that could not be written.
+         * @param length The number of bytes dropped.
+         */
+        void drop(std::size_t length);
+
+        /**
+         * @brief Releases the blocks past the bytes written, unmaps and closes the active segment.
+         */
+        void closeSegment();
+
+        /**
+         * @brief Renames `<path>` to `<path>.1` after shifting and pruning older segments.
+         */
+        void shiftSegments() const;
+
+        std::string path; /**< Path of the active segment. */
+        Options options; /**< Rotation settings. */
+        int fd; /**< Descriptor of the active segment, or -1. */
+        char* mapped; /**< Mapping of the active segment, or `nullptr`. */
+        std::size_t offset; /**< Bytes written to the active segment. */
+        std::size_t fileBytes; /**< Size of the active segment's file. */
+        std::size_t preambleEnd; /**< Offset just past the preamble in the active segment. */
+        std::string preamble; /**< Bytes written at the start of each new segment. */
+        std::chrono::steady_clock::time_point openedAt; /**< When the active segment was opened. */
+        std::size_t droppedBytes; /**< Bytes that could not be written. */
+};
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include "EventLoop.hpp"
+#include "HeartbeatMonitor.hpp"
+#include "InventoryManager.hpp"
+#include "MessageDispatcher.hpp"
+#include "MessageQueue.hpp"
+#include "NetworkManager.hpp"
+#include "NotificationSystem.hpp"
+#include "ShutdownCoordinator.hpp"
+
+namespace ServerConstants {
+    constexpr std::size_t DISPATCH_BATCH = 64; /**< Messages dispatched per turn of the event loop. */
+    constexpr std::chrono::milliseconds MAINTENANCE_INTERVAL{50}; /**< Period of the idle reaper, retransmissions and heartbeats. */
+}
+
+/**
+ * @class Server
+ * @brief Runs the server's components on one event loop.
+ *
+ * The network manager reads the sockets on the loop and every received message is
+ * pushed into the bounded pending queue; a message the queue rejects is answered
+ * with a STATUS/BUSY reply. The dispatcher drains the queue on the loop thread,
+ * `ServerConstants::DISPATCH_BATCH` messages per turn.
+ *
+ * The loop thread is also the queue's only consumer, so under the `BLOCK` policy a
+ * full queue is dispatched from before the push instead of blocking the loop.
+ *
+ * A timer on the loop fires every `ServerConstants::MAINTENANCE_INTERVAL` to close
+ * idle connections, resend unacknowledged reliable datagrams and send the heartbeats
+ * that are due. Whatever closes a connection, the client's subscriptions, inventory
+ * and heartbeat state are removed with it.
+ *
+ * Alerts from authorized clients are broadcast through the notification system.
+ *
+ * The maintenance timer also polls `ShutdownCoordinator::isShutdownRequested`; once a
+ * shutdown is requested, e.g. by a signal, `run` leaves the loop and takes the server
+ * down through a `ShutdownCoordinator`, which drains the pending and outbound queues
+ * and saves the inventory snapshot before closing the sockets.
+ */
+class Server {
+    public:
+        /**
+         * @struct Options
+         * @brief Server settings.
+         */
+        struct Options {
+            std::size_t queueCapacity = MessageQueueConstants::DEFAULT_CAPACITY; /**< Pending messages held at once. */
+            MessageQueue::OverflowPolicy overflowPolicy = MessageQueue::OverflowPolicy::REJECT_BUSY; /**< Behaviour of a full queue. */
+            NetworkManager::IoBackend ioBackend = NetworkManager::IoBackend::EPOLL; /**< Backend for TCP connections. */
+            std::chrono::milliseconds idleTimeout = NetworkConstants::DEFAULT_IDLE_TIMEOUT; /**< Silence before a client is closed; zero disables. */
+            HeartbeatMonitor::Options heartbeat{}; /**< Heartbeat settings. */
+            std::string snapshotPath; /**< File the inventory snapshot is saved to at shutdown; empty skips it. */
+            std::chrono::milliseconds shutdownDeadline = ShutdownConstants::DEFAULT_DEADLINE; /**< Time allowed for draining at shutdown. */
+            bool handleSignals = false; /**< Whether `start` makes SIGTERM and SIGINT request a shutdown. */
+        };
+
+        /**
+         * @brief Constructs a server with the default settings.
+         */
+        Server();
+
+        /**
+         * @brief Constructs a server.
+         *
+         * @param options The server settings.
+         * @throws std::invalid_argument If the queue capacity is 0 or the heartbeat settings are invalid.
+         */
+        explicit Server(const Options& options);
+
+        /**
+         * @brief Stops the maintenance timer; the network manager closes the sockets.
+         */
+        ~Server();
+
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        /**
+         * @brief Opens the server sockets and starts reading them on the event loop.
+         *
+         * Also arms the maintenance timer and, if `Options::handleSignals` is set, installs
+         * the shutdown signal handlers.
+         *
+         * @param port The port to listen on.
+         * @throws std::runtime_error If the sockets or the timer cannot be set up.
+         */
+        void start(int port);
+
+        /**
+         * @brief Runs the event loop until `stop` is called or a shutdown is requested.
+         *
+         * A requested shutdown is carried out with `shutdown` before returning.
+         */
+        void run();
+
+        /**
+         * @brief Takes the server down without losing accepted work.
+         *
+         * Stops accepting connections, dispatches the pending queue, writes the outbound
+         * queues, saves the inventory snapshot and closes every socket. Must be called on
+         * the loop thread, or after the loop stopped.
+         *
+         * @return What the shutdown completed.
+         */
+        ShutdownCoordinator::Report shutdown();
+
+        /**
+         * @brief Asks `run` to return; safe to call from any thread.
+         */
+        void stop();
+
+        /**
+         * @brief Runs one iteration of the event loop.
+         *
+         * @param timeoutMs Maximum time to wait, in milliseconds. -1 waits indefinitely.
+         * @return The number of handlers and callbacks that were run.
+         */
+        std::size_t runOnce(int timeoutMs);
+
+        /**
+         * @brief Gets the event loop.
+         * @return The loop the server runs on.
+         */
+        EventLoop& getEventLoop();
+
+        /**
+         * @brief Gets the pending queue.
+         * @return The queue between the network manager and the dispatcher.
+         */
+        MessageQueue& getMessageQueue();
+
+        /**
+         * @brief Gets the network manager.
+         * @return The server's network manager.
+         */
+        NetworkManager& getNetworkManager();
+
+        /**
+         * @brief Gets the dispatcher, e.g. to attach an authentication module.
+         * @return The server's dispatcher.
+         */
+        MessageDispatcher& getDispatcher();
+
+        /**
+         * @brief Gets the notification system.
+         * @return The server's notification system.
+         */
+        NotificationSystem& getNotificationSystem();
+
+        /**
+         * @brief Gets the inventory manager.
+         * @return The server's inventory manager.
+         */
+        InventoryManager& getInventoryManager();
+
+        /**
+         * @brief Gets the heartbeat monitor.
+         * @return The server's heartbeat monitor.
+         */
+        HeartbeatMonitor& getHeartbeatMonitor();
+
+    private:
+        /**
+         * @brief Queues a received message, or answers BUSY if the queue rejects it.
+         * @param msg The received message.
+         */
+        void receive(Message msg);
+
+        /**
+         * @brief Posts a dispatch of the pending queue unless one is already posted.
+         */
+        void scheduleDispatch();
+
+        /**
+         * @brief Releases the state other components keep for a closed client.
+         * @param clientID The closed client.
+         */
+        void releaseClient(int clientID);
+
+        /**
+         * @brief Runs the periodic work: idle reaping, retransmissions and heartbeats.
+         */
+        void runMaintenance();
+
+        EventLoop eventLoop; ///< Loop running the network manager and the dispatcher.
+        MessageQueue pendingMessages; ///< Received messages waiting to be dispatched.
+        NetworkManager networkManager; ///< Server sockets and client connections.
+        MessageDispatcher dispatcher; ///< Handler of the pending messages.
+        NotificationSystem notificationSystem; ///< Subscriptions of the clients.
+        InventoryManager inventoryManager; ///< Global and per-client inventories.
+        HeartbeatMonitor heartbeatMonitor; ///< Pings of the clients.
+        NetworkManager::IoBackend ioBackend; ///< Backend requested for TCP connections.
+        std::string snapshotPath; ///< File of the inventory snapshot saved at shutdown.
+        std::chrono::milliseconds shutdownDeadline; ///< Time allowed for draining at shutdown.
+        bool handleSignals; ///< Whether `start` installs the shutdown signal handlers.
+        bool shuttingDown = false; ///< Whether `shutdown` has started.
+        int maintenanceTimer = -1; ///< timerfd driving `runMaintenance`.
+        bool dispatchScheduled = false; ///< Whether a dispatch is already posted to the loop.
+};
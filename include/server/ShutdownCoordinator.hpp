@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include "EventLogger.hpp"
+#include "EventLoop.hpp"
+#include "InventoryManager.hpp"
+#include "MessageDispatcher.hpp"
+#include "MessageQueue.hpp"
+#include "NetworkManager.hpp"
+
+namespace ShutdownConstants {
+    constexpr std::chrono::milliseconds DEFAULT_DEADLINE{10000}; /**< Time allowed for a graceful shutdown. */
+    constexpr std::size_t DISPATCH_BATCH = 64; /**< Messages dispatched between outbound flushes while draining. */
+}
+
+/**
+ * @class ShutdownCoordinator
+ * @brief Stops the server in an order that loses no accepted work.
+ *
+ * `run` takes the server down in steps:
+ * 1. stops accepting TCP connections;
+ * 2. closes the pending queue and dispatches what it holds;
+ * 3. writes the outbound queues to the clients;
+ * 4. flushes the event logger;
+ * 5. saves an inventory snapshot;
+ * 6. closes every connection and server socket.
+ *
+ * Steps 2 and 3 stop at the deadline, so a client that stops reading cannot hold up
+ * a restart; the remaining steps always run. Components that are not set are skipped.
+ *
+ * `installSignalHandlers` turns SIGTERM and SIGINT into a request the main loop polls
+ * with `isShutdownRequested` before calling `run` on its own thread.
+ */
+class ShutdownCoordinator {
+    public:
+        /**
+         * @struct Report
+         * @brief What a shutdown completed.
+         */
+        struct Report {
+            std::size_t dispatched; /**< Pending messages dispatched while draining. */
+            std::size_t abandoned; /**< Pending messages left undispatched at the deadline. */
+            bool outboundFlushed; /**< Whether every outbound queue was written. */
+            bool snapshotSaved; /**< Whether the inventory snapshot was written. */
+            bool deadlineMet; /**< Whether draining finished before the deadline. */
+        };
+
+        /**
+         * @brief Sets the network manager to stop, drain and close.
+         * @param manager The server's network manager, or `nullptr`.
+         */
+        void setNetworkManager(NetworkManager* manager);
+
+        /**
+         * @brief Sets the pending queue and the dispatcher that drains it.
+         *
+         * @param queue The queue given to the dispatcher, or `nullptr`.
+         * @param dispatcher The server's dispatcher, or `nullptr`.
+         */
+        void setDispatcher(MessageQueue* queue, MessageDispatcher* dispatcher);
+
+        /**
+         * @brief Sets the event loop that runs asynchronous handlers while draining.
+         * @param loop The server's event loop, or `nullptr`.
+         */
+        void setEventLoop(EventLoop* loop);
+
+        /**
+         * @brief Sets the logger that records the shutdown and is flushed.
+         * @param logger The server's event logger, or `nullptr`.
+         */
+        void setEventLogger(EventLogger* logger);
+
+        /**
+         * @brief Sets the inventory to snapshot.
+         *
+         * @param inventory The server's inventory manager, or `nullptr`.
+         * @param snapshotPath The file the snapshot is written to.
+         */
+        void setInventory(InventoryManager* inventory, std::string snapshotPath);
+
+        /**
+         * @brief Shuts the server down.
+         *
+         * @param deadline Time allowed for draining the pending and outbound queues.
+         * @return What the shutdown completed.
+         */
+        Report run(std::chrono::milliseconds deadline = ShutdownConstants::DEFAULT_DEADLINE);
+
+        /**
+         * @brief Makes SIGTERM and SIGINT request a shutdown instead of ending the process.
+         */
+        static void installSignalHandlers();
+
+        /**
+         * @brief Requests a shutdown; safe to call from a signal handler.
+         */
+        static void requestShutdown();
+
+        /**
+         * @brief Checks if a shutdown was requested.
+         * @return `true` after `requestShutdown` or a handled signal.
+         */
+        [[nodiscard]] static bool isShutdownRequested();
+
+    private:
+        /**
+         * @brief Dispatches pending messages until the queue is empty or the deadline passes.
+         *
+         * @param deadline When to stop.
+         * @param report Receives the dispatched and abandoned counts.
+         */
+        void drainPending(std::chrono::steady_clock::time_point deadline, Report& report);
+
+        /**
+         * @brief Handles SIGTERM and SIGINT.
+         * @param signal The received signal.
+         */
+        static void handleSignal(int signal);
+
+        NetworkManager* networkManager = nullptr; ///< Manager stopped, drained and closed.
+        MessageQueue* pendingMessages = nullptr; ///< Queue closed and drained.
+        MessageDispatcher* dispatcher = nullptr; ///< Dispatcher that drains the queue.
+        EventLoop* eventLoop = nullptr; ///< Loop run while draining.
+        EventLogger* eventLogger = nullptr; ///< Logger flushed after draining.
+        InventoryManager* inventoryManager = nullptr; ///< Inventory snapshotted before closing.
+        std::string snapshotPath; ///< File of the inventory snapshot.
+
+        static std::atomic<bool> shutdownRequested; ///< Set by `requestShutdown`.
+};
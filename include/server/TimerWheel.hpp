@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TimerWheelConstants {
+    constexpr int SLOT_BITS = 6; /**< log2 of the slots per level. */
+    constexpr std::size_t SLOTS = std::size_t{1} << SLOT_BITS; /**< Slots per level. */
+    constexpr std::size_t LEVELS = 4; /**< Levels; the wheel spans SLOTS^LEVELS ticks. */
+}
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel of integer keys.
+ *
+ * Level 0 has one slot per tick; each higher level has slots covering a whole turn of
+ * the level below. A timer is filed in the lowest level whose span reaches its deadline
+ * and moves down a level each time the level below wraps, so scheduling is O(1) and
+ * each timer is touched at most once per level before it fires.
+ *
+ * Timers cannot be cancelled. Owners that need to cancel or postpone one check, when
+ * its key fires, whether it is still wanted and schedule it again if needed; this keeps
+ * frequent events such as "the client sent something" off the wheel entirely.
+ *
+ * Deadlines beyond the span of the wheel fire at the end of the span. The class is not
+ * thread-safe.
+ */
+class TimerWheel {
+    public:
+        using Clock = std::chrono::steady_clock; ///< Clock of the deadlines.
+
+        /**
+         * @brief Constructs an empty wheel.
+         *
+         * @param tick The resolution of the wheel; deadlines are rounded up to a whole tick.
+         * @param start The time of tick 0.
+         * @throws std::invalid_argument If the tick is not positive.
+         */
+        explicit TimerWheel(std::chrono::milliseconds tick, Clock::time_point start = Clock::now());
+
+        /**
+         * @brief Schedules a key to fire at a deadline.
+         *
+         * @param key The key returned by `advance` when the timer fires.
+         * @param deadline When the timer fires. Past deadlines fire on the next tick.
+         */
+        void schedule(std::uint64_t key, Clock::time_point deadline);
+
+        /**
+         * @brief Advances the wheel to a time and collects the timers that fired.
+         *
+         * @param now The current time. Earlier times than the last call do nothing.
+         * @return The keys whose deadline has passed, in deadline order by tick.
+         */
+        std::vector<std::uint64_t> advance(Clock::time_point now);
+
+        /**
+         * @brief Gets the number of scheduled timers.
+         * @return The number of timers that have not fired.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        /**
+         * @struct Timer
+         * @brief A scheduled key.
+         */
+        struct Timer {
+            std::uint64_t key; ///< The key to report.
+            std::uint64_t expiry; ///< The tick at which the timer fires.
+        };
+
+        /**
+         * @brief Files a timer in the level and slot covering its expiry.
+         * @param timer The timer.
+         */
+        void insert(const Timer& timer);
+
+        /**
+         * @brief Refiles the timers of a slot into lower levels.
+         * @param level The level of the slot.
+         * @param slot The slot.
+         */
+        void cascade(std::size_t level, std::size_t slot);
+
+        std::chrono::milliseconds tick; ///< Duration of a tick.
+        Clock::time_point start; ///< Time of tick 0.
+        std::uint64_t currentTick = 0; ///< Last tick processed.
+        std::size_t count = 0; ///< Number of scheduled timers.
+        std::array<std::array<std::vector<Timer>, TimerWheelConstants::SLOTS>, TimerWheelConstants::LEVELS> levels; ///< Timer slots by level.
+};
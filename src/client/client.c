@@ -1,4 +1,6 @@
 #include "client/client.h"
+#include "client/logger.h"
+#include "cjson/cJSON.h"
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
@@ -7,17 +9,22 @@
 bool initializeClient(Client* client, const char* ip, int port, int protocol) {
     client->protocol = protocol;
     client->socket_fd = socket(AF_INET, protocol == 0 ? SOCK_STREAM : SOCK_DGRAM, 0);
-    if (client->socket_fd < 0) return false;
+    if (client->socket_fd < 0) {
+        logEvent("Client", "Could not create the socket");
+        return false;
+    }
 
     client->server_addr.sin_family = AF_INET;
     client->server_addr.sin_port = htons(port);
     client->server_addr.sin_addr.s_addr = inet_addr(ip);
 
     if (protocol == 0 && connect(client->socket_fd, (struct sockaddr*)&client->server_addr, sizeof(client->server_addr)) < 0) {
+        logEvent("Client", "Could not connect to the server");
         return false;
     }
 
     client->is_connected = true;
+    logEvent("Client", protocol == 0 ? "Connected over TCP" : "Ready to send over UDP");
     return true;
 }
 
@@ -41,9 +48,28 @@ bool receiveMessage(Client* client, char* buffer, int buffer_size) {
     return true;
 }
 
+bool answerHeartbeat(Client* client, const char* message) {
+    cJSON* root = cJSON_Parse(message);
+    if (root == NULL) return false;
+
+    cJSON* type = cJSON_GetObjectItemCaseSensitive(root, "type");
+    cJSON* subType = cJSON_GetObjectItemCaseSensitive(root, "subType");
+    bool answered = false;
+    if (cJSON_IsNumber(type) && type->valueint == MESSAGE_TYPE_HEARTBEAT &&
+        cJSON_IsNumber(subType) && subType->valueint == HEARTBEAT_PING) {
+        cJSON_SetNumberValue(subType, HEARTBEAT_PONG);
+        char* pong = cJSON_PrintUnformatted(root);
+        answered = pong != NULL && sendMessage(client, pong);
+        cJSON_free(pong);
+    }
+    cJSON_Delete(root);
+    return answered;
+}
+
 void closeClient(Client* client) {
     if (client->is_connected) {
         close(client->socket_fd);
         client->is_connected = false;
+        logEvent("Client", "Disconnected");
     }
 }
@@ -1,28 +1,27 @@
 #include "logger.h"
-#include <stdio.h>
-#include <string.h>
-#include <time.h>
+#include "logcore.h"
+#include <stddef.h>
 
-static FILE* logFile = NULL;
+static LogCoreSink* logSink = NULL;
 
 bool initLogger(const char* filename) {
-    logFile = fopen(filename, "a");
-    return logFile != NULL;
+    LogCoreOptions options = logCoreDefaultOptions();
+    options.async = true; // Keeps file writes off the client's send/receive path.
+    logSink = logCoreOpen(filename, &options);
+    return logSink != NULL;
 }
 
 void logEvent(const char* component, const char* message) {
-    if (logFile) {
-        time_t now = time(NULL);
-        char* timestamp = ctime(&now);
-        timestamp[strcspn(timestamp, "\n")] = '\0'; // Remove newline
-        fprintf(logFile, "[%s] [%s] %s\n", timestamp, component, message);
-        fflush(logFile); // Ensure immediate write
-    }
+    logCoreLog(logSink, LOG_CORE_INFO, component, message);
+}
+
+void flushLogger() {
+    logCoreFlush(logSink);
 }
 
 void closeLogger() {
-    if (logFile) {
-        fclose(logFile);
-        logFile = NULL;
+    if (logSink) {
+        logCoreClose(logSink);
+        logSink = NULL;
     }
 }
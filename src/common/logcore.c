@@ -0,0 +1,288 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "logcore.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+struct LogCoreSink {
+    int fd; ///< Descriptor of the log file, opened in append mode.
+    LogCoreOptions options; ///< Sink settings.
+    char* active; ///< Buffer records are appended to.
+    size_t activeLength; ///< Bytes in the active buffer.
+    char* spare; ///< Buffer the writer thread is writing, when async.
+    bool writing; ///< Whether the writer thread is writing the spare buffer.
+    bool stopping; ///< Whether the writer thread should exit.
+    pthread_mutex_t mutex; ///< Protects the buffers and flags.
+    pthread_cond_t wake; ///< Wakes the writer thread.
+    pthread_cond_t drained; ///< Signalled after the writer thread writes a buffer.
+    pthread_t writer; ///< The writer thread, when async.
+};
+
+typedef struct {
+    time_t second;
+    char text[LOG_CORE_TIMESTAMP_SECONDS_LENGTH + 1];
+} SecondCache;
+
+static _Thread_local SecondCache secondCache = { (time_t)-1, {0} };
+
+static void writeDigits(char* out, unsigned long value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+static void writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+}
+
+const char* logCoreLevelName(int level) {
+    switch (level) {
+        case LOG_CORE_DEBUG: return "DEBUG";
+        case LOG_CORE_INFO: return "INFO";
+        case LOG_CORE_WARNING: return "WARNING";
+        case LOG_CORE_ERROR: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+size_t logCoreFormatTimestamp(char* out, const struct timespec* time, int fractionDigits) {
+    if (time->tv_sec != secondCache.second) {
+        struct tm tm;
+        localtime_r(&time->tv_sec, &tm);
+        strftime(secondCache.text, sizeof(secondCache.text), "%Y-%m-%d %H:%M:%S", &tm);
+        secondCache.second = time->tv_sec;
+    }
+
+    memcpy(out, secondCache.text, LOG_CORE_TIMESTAMP_SECONDS_LENGTH);
+    size_t length = LOG_CORE_TIMESTAMP_SECONDS_LENGTH;
+    if (fractionDigits == 3) {
+        out[length++] = '.';
+        writeDigits(out + length, (unsigned long)time->tv_nsec / 1000000, 3);
+        length += 3;
+    } else if (fractionDigits == 6) {
+        out[length++] = '.';
+        writeDigits(out + length, (unsigned long)time->tv_nsec / 1000, 6);
+        length += 6;
+    }
+    return length;
+}
+
+size_t logCoreRecordCapacity(size_t componentLength, size_t messageLength) {
+    return LOG_CORE_TIMESTAMP_MAX_LENGTH + LOG_CORE_LEVEL_MAX_LENGTH + componentLength + messageLength + 10;
+}
+
+size_t logCoreFormatRecord(char* out, const struct timespec* time, int fractionDigits,
+                           const char* component, size_t componentLength, int level,
+                           const char* message, size_t messageLength) {
+    const char* levelName = logCoreLevelName(level);
+    const size_t levelLength = strlen(levelName);
+
+    char* cursor = out;
+    *cursor++ = '[';
+    cursor += logCoreFormatTimestamp(cursor, time, fractionDigits);
+    memcpy(cursor, "] [", 3);
+    cursor += 3;
+    memcpy(cursor, component, componentLength);
+    cursor += componentLength;
+    memcpy(cursor, "] [", 3);
+    cursor += 3;
+    memcpy(cursor, levelName, levelLength);
+    cursor += levelLength;
+    memcpy(cursor, "] ", 2);
+    cursor += 2;
+    memcpy(cursor, message, messageLength);
+    cursor += messageLength;
+    *cursor++ = '\n';
+    return (size_t)(cursor - out);
+}
+
+LogCoreOptions logCoreDefaultOptions(void) {
+    LogCoreOptions options;
+    options.bufferBytes = LOG_CORE_DEFAULT_BUFFER_BYTES;
+    options.async = false;
+    options.flushIntervalMs = LOG_CORE_DEFAULT_FLUSH_INTERVAL_MS;
+    options.timestampDigits = 0;
+    return options;
+}
+
+/**
+ * @brief Body of the writer thread of an asynchronous sink.
+ *
+ * Swaps the active buffer with the spare one and writes it without holding the lock,
+ * when the buffer is half full, when a flush is requested or when the interval expires.
+ */
+static void* writerLoop(void* argument) {
+    LogCoreSink* sink = argument;
+
+    pthread_mutex_lock(&sink->mutex);
+    for (;;) {
+        if (sink->activeLength == 0) {
+            if (sink->stopping) break;
+            pthread_cond_broadcast(&sink->drained);
+
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += (long)(sink->options.flushIntervalMs % 1000) * 1000000;
+            deadline.tv_sec += sink->options.flushIntervalMs / 1000 + deadline.tv_nsec / 1000000000;
+            deadline.tv_nsec %= 1000000000;
+            pthread_cond_timedwait(&sink->wake, &sink->mutex, &deadline);
+            continue;
+        }
+
+        char* batch = sink->active;
+        const size_t length = sink->activeLength;
+        sink->active = sink->spare;
+        sink->activeLength = 0;
+        sink->spare = batch;
+        sink->writing = true;
+        pthread_mutex_unlock(&sink->mutex);
+
+        writeAll(sink->fd, batch, length);
+
+        pthread_mutex_lock(&sink->mutex);
+        sink->writing = false;
+        pthread_cond_broadcast(&sink->drained);
+    }
+    pthread_mutex_unlock(&sink->mutex);
+    return NULL;
+}
+
+LogCoreSink* logCoreOpen(const char* path, const LogCoreOptions* options) {
+    LogCoreSink* sink = calloc(1, sizeof(LogCoreSink));
+    if (sink == NULL) return NULL;
+
+    sink->options = options != NULL ? *options : logCoreDefaultOptions();
+    if (sink->options.bufferBytes == 0) sink->options.bufferBytes = LOG_CORE_DEFAULT_BUFFER_BYTES;
+
+    sink->fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    sink->active = malloc(sink->options.bufferBytes);
+    sink->spare = sink->options.async ? malloc(sink->options.bufferBytes) : NULL;
+    if (sink->fd < 0 || sink->active == NULL || (sink->options.async && sink->spare == NULL)) {
+        if (sink->fd >= 0) close(sink->fd);
+        free(sink->active);
+        free(sink->spare);
+        free(sink);
+        return NULL;
+    }
+
+    pthread_mutex_init(&sink->mutex, NULL);
+    pthread_cond_init(&sink->wake, NULL);
+    pthread_cond_init(&sink->drained, NULL);
+    if (sink->options.async && pthread_create(&sink->writer, NULL, writerLoop, sink) != 0) {
+        sink->options.async = false;
+    }
+    return sink;
+}
+
+bool logCoreWrite(LogCoreSink* sink, const char* record, size_t length) {
+    if (sink == NULL) return false;
+
+    pthread_mutex_lock(&sink->mutex);
+    if (!sink->options.async) {
+        if (sink->activeLength + length > sink->options.bufferBytes) {
+            writeAll(sink->fd, sink->active, sink->activeLength);
+            sink->activeLength = 0;
+        }
+        if (length > sink->options.bufferBytes) {
+            writeAll(sink->fd, record, length);
+        } else {
+            memcpy(sink->active + sink->activeLength, record, length);
+            sink->activeLength += length;
+        }
+        pthread_mutex_unlock(&sink->mutex);
+        return true;
+    }
+
+    // Wait for the writer when the buffer is full; records are never dropped.
+    while (sink->activeLength > 0 && sink->activeLength + length > sink->options.bufferBytes) {
+        pthread_cond_signal(&sink->wake);
+        pthread_cond_wait(&sink->drained, &sink->mutex);
+    }
+    if (length > sink->options.bufferBytes) {
+        while (sink->writing) {
+            pthread_cond_wait(&sink->drained, &sink->mutex);
+        }
+        writeAll(sink->fd, record, length);
+    } else {
+        memcpy(sink->active + sink->activeLength, record, length);
+        sink->activeLength += length;
+        if (sink->activeLength >= sink->options.bufferBytes / 2) {
+            pthread_cond_signal(&sink->wake);
+        }
+    }
+    pthread_mutex_unlock(&sink->mutex);
+    return true;
+}
+
+bool logCoreLog(LogCoreSink* sink, int level, const char* component, const char* message) {
+    if (sink == NULL) return false;
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    const size_t componentLength = strlen(component);
+    const size_t messageLength = strlen(message);
+    const size_t capacity = logCoreRecordCapacity(componentLength, messageLength);
+
+    char stackRecord[512];
+    char* record = capacity <= sizeof(stackRecord) ? stackRecord : malloc(capacity);
+    if (record == NULL) return false;
+
+    const size_t length = logCoreFormatRecord(record, &now, sink->options.timestampDigits,
+                                              component, componentLength, level, message, messageLength);
+    const bool accepted = logCoreWrite(sink, record, length);
+    if (record != stackRecord) free(record);
+    return accepted;
+}
+
+void logCoreFlush(LogCoreSink* sink) {
+    if (sink == NULL) return;
+
+    pthread_mutex_lock(&sink->mutex);
+    if (!sink->options.async) {
+        writeAll(sink->fd, sink->active, sink->activeLength);
+        sink->activeLength = 0;
+    } else {
+        pthread_cond_signal(&sink->wake);
+        while (sink->activeLength > 0 || sink->writing) {
+            pthread_cond_wait(&sink->drained, &sink->mutex);
+        }
+    }
+    pthread_mutex_unlock(&sink->mutex);
+}
+
+void logCoreClose(LogCoreSink* sink) {
+    if (sink == NULL) return;
+
+    if (sink->options.async) {
+        pthread_mutex_lock(&sink->mutex);
+        sink->stopping = true;
+        pthread_cond_signal(&sink->wake);
+        pthread_mutex_unlock(&sink->mutex);
+        pthread_join(sink->writer, NULL);
+    }
+    logCoreFlush(sink);
+
+    close(sink->fd);
+    pthread_cond_destroy(&sink->drained);
+    pthread_cond_destroy(&sink->wake);
+    pthread_mutex_destroy(&sink->mutex);
+    free(sink->active);
+    free(sink->spare);
+    free(sink);
+}
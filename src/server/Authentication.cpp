@@ -1,17 +1,75 @@
 #include "server/Authentication.hpp"
+#include <algorithm>
+#include <charconv>
+#include <optional>
 #include <stdexcept>
 
-bool Authentication::authenticate(const int client_id, const std::string& password) {
+namespace {
+    constexpr std::string_view HASH_SCHEME = "pbkdf2-sha256";
+
+    // Layout of a published status entry: authorized flag, group, high bits of the client ID, unlock epoch.
+    constexpr std::uint64_t STATUS_AUTHORIZED = 1;
+    constexpr int STATUS_GROUP_SHIFT = 1;
+    constexpr int STATUS_TAG_SHIFT = 9;
+    constexpr std::uint64_t STATUS_TAG_MASK = 0xFFFF;
+    constexpr int STATUS_EPOCH_SHIFT = 25;
+
+    std::uint64_t statusTag(const std::uint64_t status) {
+        return (status >> STATUS_TAG_SHIFT) & STATUS_TAG_MASK;
+    }
+}
+
+Authentication::Authentication() : Authentication(Config{}) {}
+
+Authentication::Authentication(const Config& config)
+    : config(config), verificationKey(Crypto::randomBytes(Crypto::SHA256_DIGEST_BYTES)), kdfEvaluations(0),
+      clientLoginLimiter(config.clientLoginLimit), sourceLoginLimiter(config.sourceLoginLimit) {}
+
+bool Authentication::authenticate(const int client_id, const std::string& password, const std::string& source) {
+    std::string hashedPassword;
+    Crypto::Sha256Digest tag;
+    {
+        std::lock_guard lock(writeMutex);
+        const auto it = findCredentials(client_id);
+        if (it == credentials.end()) return false;
+
+        AuthData& auth = it->second;
+
+        if (auth.isBlocked || auth.emergencyBlocked || isLockedDown(auth.group, auth.unlockedEpoch)) return false;
+
+        tag = verificationTag(client_id, auth.hashedPassword, password);
+        if (hasVerifiedLogin(client_id, tag)) {
+            auth.failedAttempts = 0;
+            auth.isLogged = true;
+            publishStatus(client_id);
+            return true;
+        }
+        hashedPassword = auth.hashedPassword;
+    }
+
+    if (!clientLoginLimiter.tryAcquire(static_cast<std::uint64_t>(static_cast<unsigned int>(client_id))) ||
+        (!source.empty() && !sourceLoginLimiter.tryAcquire(std::hash<std::string>{}(source)))) {
+        throttledLogins++;
+        return false;
+    }
+
+    // The KDF is the slow part of a login; other threads may change credentials meanwhile.
+    const bool verified = verifyPassword(password, hashedPassword);
+
+    std::lock_guard lock(writeMutex);
     const auto it = credentials.find(client_id);
-    if (it == credentials.end()) return false;
+    if (it == credentials.end() || it->second.hashedPassword != hashedPassword) return false;
 
     AuthData& auth = it->second;
+    if (auth.isBlocked || auth.emergencyBlocked || isLockedDown(auth.group, auth.unlockedEpoch)) return false;
 
-    if (auth.isBlocked || auth.emergencyBlocked) return false;
-
-    if (auth.hashedPassword == hashPassword(password)) {
+    if (verified) {
+        if (config.verifiedLoginTtl.count() > 0) {
+            verifiedLogins[client_id] = {tag, std::chrono::steady_clock::now() + config.verifiedLoginTtl, lockdownEpoch.load()};
+        }
         auth.failedAttempts = 0;
         auth.isLogged = true;
+        publishStatus(client_id);
         //TODO : Log successful login
         return true;
     }
@@ -20,41 +78,121 @@ bool Authentication::authenticate(const int client_id, const std::string& passwo
     //TODO : Log failed login
     if (auth.failedAttempts >= AuthenticationConstants::MAX_FAILED_ATTEMPTS) {
         auth.isBlocked = true;
+        verifiedLogins.erase(client_id);
+        revokeSessionTokenLocked(client_id);
+        publishStatus(client_id);
         //TODO : Log blocked
     }
     return false;
 }
 
 bool Authentication::isAuthorized(const int client_id) const {
+    const auto id = static_cast<std::uint32_t>(client_id);
+    const std::size_t slot = id & (AuthenticationConstants::STATUS_SLOTS - 1);
+    const StatusChunk* entries = statusChunks[slot >> AuthenticationConstants::STATUS_CHUNK_BITS].load(std::memory_order_acquire);
+    if (entries == nullptr) return false;
+
+    const std::uint64_t status = (*entries)[slot & (AuthenticationConstants::STATUS_CHUNK_SIZE - 1)].load(std::memory_order_acquire);
+    if (statusTag(status) == id >> AuthenticationConstants::STATUS_SLOT_BITS) {
+        return (status & STATUS_AUTHORIZED) != 0 &&
+               !isLockedDown(static_cast<GroupId>(status >> STATUS_GROUP_SHIFT), status >> STATUS_EPOCH_SHIFT);
+    }
+
+    // Another client ID of the slot holds the entry.
+    std::lock_guard lock(writeMutex);
     const auto it = credentials.find(client_id);
-    return it != credentials.end() && it->second.isLogged && !it->second.isBlocked;
+    return it != credentials.end() && it->second.isLogged && !it->second.isBlocked && !it->second.emergencyBlocked &&
+           !isLockedDown(it->second.group, it->second.unlockedEpoch);
 }
 
 void Authentication::setLoggedOut(const int client_id) {
+    std::lock_guard lock(writeMutex);
+    if (const auto it = credentials.find(client_id); it != credentials.end()) {
+        it->second.isLogged = false;
+        publishStatus(client_id);
+    }
+    revokeSessionTokenLocked(client_id);
+}
+
+void Authentication::openConnection(const int client_id) {
+    std::lock_guard lock(writeMutex);
+    publishStatus(client_id, true);
+}
+
+void Authentication::closeConnection(const int client_id) {
+    std::lock_guard lock(writeMutex);
     if (const auto it = credentials.find(client_id); it != credentials.end()) {
         it->second.isLogged = false;
     }
+    publishStatus(client_id);
 }
 
 void Authentication::addCredentials(const int client_id, const std::string& newPassword) {
-    if (credentials.contains(client_id)) return;
+    {
+        std::lock_guard lock(writeMutex);
+        if (credentials.contains(client_id)) return;
+    }
 
-    credentials[client_id] = {
-        hashPassword(newPassword),
+    std::string hashedPassword = hashPassword(newPassword);
+    std::lock_guard lock(writeMutex);
+    removedClients.erase(client_id);
+    credentials.try_emplace(client_id, AuthData{
+        std::move(hashedPassword),
         false,
         0,
         false,
         false
-    };
+    });
     //TODO : Loggear nuevo cliente
 }
 
+void Authentication::loadDatabase(const std::string& path) {
+    auto next = std::make_shared<const CredentialDatabase>(path);
+    std::uint64_t generation;
+    {
+        std::lock_guard lock(writeMutex);
+        database.store(std::move(next));
+        generation = ++databaseGeneration;
+    }
+
+    // Clients that are looked up reconcile themselves; this reaches the idle ones,
+    // taking the lock once per client so logins are not held up by the walk.
+    std::optional<int> previous;
+    for (;;) {
+        std::lock_guard lock(writeMutex);
+        // A newer reload walks the clients itself.
+        if (databaseGeneration != generation) return;
+
+        const auto it = previous ? credentials.upper_bound(*previous) : credentials.begin();
+        if (it == credentials.end()) return;
+        previous = it->first;
+        reconcile(it);
+    }
+}
+
+std::size_t Authentication::getDatabaseSize() const {
+    const std::shared_ptr<const CredentialDatabase> current = database.load();
+    return current != nullptr ? current->size() : 0;
+}
+
 void Authentication::removeCredentials(const int client_id) {
-    credentials.erase(client_id);
+    std::lock_guard lock(writeMutex);
+    int account = client_id;
+    if (const auto it = credentials.find(client_id); it != credentials.end()) {
+        if (it->second.fromDatabase) account = it->second.accountID;
+        credentials.erase(it);
+    }
+    // Without a tombstone the next lookup would bring the client back from the database.
+    const std::shared_ptr<const CredentialDatabase> current = database.load();
+    if (current != nullptr && current->find(account)) removedClients.insert(account);
+    verifiedLogins.erase(client_id);
+    revokeSessionTokenLocked(client_id);
+    publishStatus(client_id);
     //TODO : Loggear borrado de cliente
 }
 
 bool Authentication::unblockWithFingerprint(const int client_id) {
+    std::lock_guard lock(writeMutex);
     const auto it = credentials.find(client_id);
     if (it == credentials.end()) return false;
 
@@ -64,33 +202,303 @@ bool Authentication::unblockWithFingerprint(const int client_id) {
     auth.isBlocked = false;
     auth.failedAttempts = 0;
     auth.isLogged = true;
+    publishStatus(client_id);
     //TODO : Log successful unblock with fingerprint
     return true;
 }
 
 void Authentication::blockDueToEmergency(const int client_id) {
-    if (const auto it = credentials.find(client_id); it != credentials.end()) {
+    std::lock_guard lock(writeMutex);
+    if (const auto it = findCredentials(client_id); it != credentials.end()) {
         it->second.emergencyBlocked = true;
+        verifiedLogins.erase(client_id);
+        revokeSessionTokenLocked(client_id);
+        publishStatus(client_id);
         //TODO : Log emergency block
         //TODO : Called by the server when an emergency alert is triggered
     }
 }
 
 bool Authentication::unlockWithSecretPhrase(const int client_id, const std::string& secretPhrase) {
-    const auto it = credentials.find(client_id);
+    // The database phrase is a PBKDF2 hash, so it is checked before taking the lock.
+    const std::shared_ptr<const CredentialDatabase> current = database.load();
+    // With no phrase configured there is nothing to match, so nobody can unlock.
+    const bool phraseMatches = current != nullptr && current->hasSecretPhrase() && current->verifySecretPhrase(secretPhrase);
+
+    std::lock_guard lock(writeMutex);
+    const auto it = findCredentials(client_id);
     if (it == credentials.end()) return false;
 
     if (AuthData& auth = it->second;
-        auth.emergencyBlocked && secretPhrase == "emergencyUnlock") {
+        (auth.emergencyBlocked || isLockedDown(auth.group, auth.unlockedEpoch)) && phraseMatches) {
         auth.emergencyBlocked = false;
-        return true;
+        auth.unlockedEpoch = lockdownEpoch.load();
+        publishStatus(client_id);
         //TODO : Log successful unlock with secret phrase
-        //TODO : fix secretPhrase location
+        return true;
     }
     return false;
 }
 
+void Authentication::setGroup(const int client_id, const GroupId group) {
+    std::lock_guard lock(writeMutex);
+    if (const auto it = findCredentials(client_id); it != credentials.end()) {
+        it->second.group = group;
+        publishStatus(client_id);
+    }
+}
+
+void Authentication::beginLockdown() {
+    const std::uint64_t epoch = lockdownEpoch.fetch_add(1) + 1;
+    globalLockdown.latest.store(epoch);
+    globalLockdown.active.store(epoch);
+}
+
+void Authentication::beginLockdown(const GroupId group) {
+    const std::uint64_t epoch = lockdownEpoch.fetch_add(1) + 1;
+    groupLockdowns[group].latest.store(epoch);
+    groupLockdowns[group].active.store(epoch);
+}
+
+void Authentication::endLockdown() {
+    globalLockdown.active.store(0);
+}
+
+void Authentication::endLockdown(const GroupId group) {
+    groupLockdowns[group].active.store(0);
+}
+
+bool Authentication::isLockedDown(const int client_id) const {
+    std::lock_guard lock(writeMutex);
+    if (const auto it = credentials.find(client_id); it != credentials.end()) {
+        return isLockedDown(it->second.group, it->second.unlockedEpoch);
+    }
+    const std::shared_ptr<const CredentialDatabase> current = database.load();
+    const std::optional<CredentialDatabase::Entry> entry = current != nullptr ? current->find(client_id) : std::nullopt;
+    return entry && isLockedDown(entry->group, 0);
+}
+
+std::string Authentication::issueSessionToken(const int client_id) {
+    std::lock_guard lock(writeMutex);
+    const auto it = credentials.find(client_id);
+    if (it == credentials.end() || !it->second.isLogged || it->second.isBlocked || it->second.emergencyBlocked ||
+        isLockedDown(it->second.group, it->second.unlockedEpoch)) {
+        return {};
+    }
+
+    revokeSessionTokenLocked(client_id);
+    std::string token = Crypto::toHex(Crypto::randomBytes(AuthenticationConstants::SESSION_TOKEN_BYTES));
+    sessions[token] = {client_id, std::chrono::steady_clock::now() + config.sessionTokenTtl, lockdownEpoch.load()};
+    sessionByClient[client_id] = token;
+    return token;
+}
+
+bool Authentication::validateSessionToken(const int client_id, const std::string& token) {
+    std::lock_guard lock(writeMutex);
+    const auto session = sessions.find(token);
+    if (session == sessions.end()) return false;
+
+    // The token names the client it was issued to, which may have been a previous connection.
+    const int holder = session->second.clientID;
+    if (std::chrono::steady_clock::now() >= session->second.expiresAt) {
+        sessionByClient.erase(holder);
+        sessions.erase(session);
+        return false;
+    }
+
+    auto it = credentials.find(holder);
+    if (it == credentials.end() || it->second.isBlocked || it->second.emergencyBlocked ||
+        isLockedDown(it->second.group, it->second.unlockedEpoch)) {
+        return false;
+    }
+    // A lockdown since the token was issued invalidates it, even once lifted.
+    if (!survivesLockdowns(it->second.group, session->second.epoch)) {
+        sessionByClient.erase(holder);
+        sessions.erase(session);
+        return false;
+    }
+
+    if (holder != client_id) {
+        // A hub that reconnected has a new connection ID; its session and authorization move to it.
+        if (credentials.contains(client_id)) return false;
+
+        auto moved = credentials.extract(it);
+        moved.key() = client_id;
+        it = credentials.insert(std::move(moved)).position;
+        verifiedLogins.erase(holder);
+        sessionByClient.erase(holder);
+        sessionByClient[client_id] = token;
+        session->second.clientID = client_id;
+        publishStatus(holder);
+    }
+
+    it->second.isLogged = true;
+    publishStatus(client_id);
+    return true;
+}
+
+void Authentication::revokeSessionToken(const int client_id) {
+    std::lock_guard lock(writeMutex);
+    revokeSessionTokenLocked(client_id);
+}
+
+std::chrono::milliseconds Authentication::getSessionTokenTtl() const {
+    return config.sessionTokenTtl;
+}
+
+std::size_t Authentication::getKdfEvaluations() const {
+    return kdfEvaluations.load();
+}
+
+std::size_t Authentication::getThrottledLogins() const {
+    return throttledLogins.load();
+}
+
 std::string Authentication::hashPassword(const std::string& password) const {
-    std::hash<std::string> hasher;
-    return std::to_string(hasher(password));
+    const std::string salt = Crypto::randomBytes(AuthenticationConstants::SALT_BYTES);
+    const std::string hash = Crypto::pbkdf2Sha256(password, salt, config.kdfIterations, AuthenticationConstants::HASH_BYTES);
+    return std::string(HASH_SCHEME) + "$" + std::to_string(config.kdfIterations) + "$" +
+           Crypto::toHex(salt) + "$" + Crypto::toHex(hash);
+}
+
+std::string Authentication::encodeHash(const CredentialDatabase::Entry& entry) {
+    const std::string_view salt(reinterpret_cast<const char*>(entry.salt.data()), entry.salt.size());
+    const std::string_view hash(reinterpret_cast<const char*>(entry.hash.data()), entry.hash.size());
+    return std::string(HASH_SCHEME) + "$" + std::to_string(entry.iterations) + "$" +
+           Crypto::toHex(salt) + "$" + Crypto::toHex(hash);
+}
+
+std::map<int, Authentication::AuthData>::iterator Authentication::findCredentials(const int client_id) {
+    if (const auto it = credentials.find(client_id); it != credentials.end()) return reconcile(it);
+    if (removedClients.contains(client_id)) return credentials.end();
+
+    const std::shared_ptr<const CredentialDatabase> current = database.load();
+    const std::optional<CredentialDatabase::Entry> entry = current != nullptr ? current->find(client_id) : std::nullopt;
+    if (!entry) return credentials.end();
+
+    AuthData auth{encodeHash(*entry), false, 0, false, false};
+    auth.group = entry->group;
+    auth.fromDatabase = true;
+    auth.accountID = client_id;
+    auth.generation = databaseGeneration;
+    return credentials.emplace(client_id, std::move(auth)).first;
+}
+
+std::map<int, Authentication::AuthData>::iterator Authentication::reconcile(const std::map<int, AuthData>::iterator it) {
+    AuthData& auth = it->second;
+    if (!auth.fromDatabase || auth.generation == databaseGeneration) return it;
+
+    const int client_id = it->first;
+    const std::shared_ptr<const CredentialDatabase> current = database.load();
+    const std::optional<CredentialDatabase::Entry> entry = current != nullptr ? current->find(auth.accountID) : std::nullopt;
+    verifiedLogins.erase(client_id);
+    if (!entry) {
+        revokeSessionTokenLocked(client_id);
+        credentials.erase(it);
+        publishStatus(client_id);
+        return credentials.end();
+    }
+
+    if (std::string hashedPassword = encodeHash(*entry); hashedPassword != auth.hashedPassword) {
+        auth.hashedPassword = std::move(hashedPassword);
+        auth.isLogged = false;
+        revokeSessionTokenLocked(client_id);
+    }
+    auth.group = entry->group;
+    auth.generation = databaseGeneration;
+    publishStatus(client_id);
+    return it;
+}
+
+bool Authentication::verifyPassword(const std::string& password, const std::string& hashedPassword) {
+    std::string_view rest(hashedPassword);
+    auto nextField = [&rest]() {
+        const std::size_t separator = rest.find('$');
+        const std::string_view field = rest.substr(0, separator);
+        rest = separator == std::string_view::npos ? std::string_view() : rest.substr(separator + 1);
+        return field;
+    };
+
+    const std::string_view scheme = nextField();
+    const std::string_view iterationsField = nextField();
+    const std::string_view saltField = nextField();
+    const std::string_view hashField = nextField();
+
+    std::uint32_t iterations = 0;
+    const auto parsed = std::from_chars(iterationsField.data(), iterationsField.data() + iterationsField.size(), iterations);
+    std::string salt, expected;
+    if (scheme != HASH_SCHEME || parsed.ec != std::errc() || iterations == 0 ||
+        !Crypto::fromHex(saltField, salt) || !Crypto::fromHex(hashField, expected) || expected.empty()) {
+        return false;
+    }
+
+    kdfEvaluations++;
+    const std::string actual = Crypto::pbkdf2Sha256(password, salt, iterations, expected.size());
+    return Crypto::constantTimeEquals(actual, expected);
+}
+
+Crypto::Sha256Digest Authentication::verificationTag(const int client_id, const std::string& hashedPassword,
+                                                     const std::string& password) const {
+    std::string message = std::to_string(client_id);
+    message.push_back('\0');
+    message += hashedPassword;
+    message.push_back('\0');
+    message += password;
+    return verificationKey.compute(message);
+}
+
+bool Authentication::hasVerifiedLogin(const int client_id, const Crypto::Sha256Digest& tag) const {
+    const auto it = verifiedLogins.find(client_id);
+    if (it == verifiedLogins.end() || std::chrono::steady_clock::now() >= it->second.expiresAt) {
+        return false;
+    }
+    if (const auto auth = credentials.find(client_id);
+        auth == credentials.end() || !survivesLockdowns(auth->second.group, it->second.epoch)) {
+        return false;
+    }
+    const std::string_view cached(reinterpret_cast<const char*>(it->second.tag.data()), it->second.tag.size());
+    const std::string_view presented(reinterpret_cast<const char*>(tag.data()), tag.size());
+    return Crypto::constantTimeEquals(cached, presented);
+}
+
+void Authentication::publishStatus(const int client_id, const bool claimSlot) {
+    const auto id = static_cast<std::uint32_t>(client_id);
+    const std::size_t slot = id & (AuthenticationConstants::STATUS_SLOTS - 1);
+    const std::size_t chunk = slot >> AuthenticationConstants::STATUS_CHUNK_BITS;
+
+    std::uint64_t status = static_cast<std::uint64_t>(id >> AuthenticationConstants::STATUS_SLOT_BITS) << STATUS_TAG_SHIFT;
+    if (const auto it = credentials.find(client_id); it != credentials.end()) {
+        const AuthData& auth = it->second;
+        if (auth.isLogged && !auth.isBlocked && !auth.emergencyBlocked) status |= STATUS_AUTHORIZED;
+        status |= static_cast<std::uint64_t>(auth.group) << STATUS_GROUP_SHIFT;
+        status |= auth.unlockedEpoch << STATUS_EPOCH_SHIFT;
+    }
+    if (ownedChunks[chunk] == nullptr) {
+        if ((status & STATUS_AUTHORIZED) == 0) return;
+        ownedChunks[chunk] = std::make_unique<StatusChunk>();
+        statusChunks[chunk].store(ownedChunks[chunk].get(), std::memory_order_release);
+    }
+
+    std::atomic<std::uint64_t>& entry = (*ownedChunks[chunk])[slot & (AuthenticationConstants::STATUS_CHUNK_SIZE - 1)];
+    const std::uint64_t current = entry.load(std::memory_order_relaxed);
+    if (!claimSlot && (status & STATUS_AUTHORIZED) == 0 && (current & STATUS_AUTHORIZED) != 0 &&
+        statusTag(current) != statusTag(status)) {
+        return;
+    }
+    entry.store(status, std::memory_order_release);
+}
+
+bool Authentication::isLockedDown(const GroupId group, const std::uint64_t unlockedEpoch) const {
+    return std::max(globalLockdown.active.load(), groupLockdowns[group].active.load()) > unlockedEpoch;
+}
+
+bool Authentication::survivesLockdowns(const GroupId group, const std::uint64_t epoch) const {
+    return std::max(globalLockdown.latest.load(), groupLockdowns[group].latest.load()) <= epoch;
+}
+
+void Authentication::revokeSessionTokenLocked(const int client_id) {
+    if (const auto it = sessionByClient.find(client_id); it != sessionByClient.end()) {
+        sessions.erase(it->second);
+        sessionByClient.erase(it);
+    }
 }
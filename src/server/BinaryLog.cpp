@@ -0,0 +1,54 @@
+#include "server/BinaryLog.hpp"
+#include <charconv>
+
+namespace {
+    /**
+     * @brief Decodes one argument and appends its text form.
+     * @return `true` if the argument was well formed, `false` otherwise.
+     */
+    bool renderArg(std::string_view& args, std::string& out) {
+        BinaryLog::ArgType type;
+        if (!BinaryLog::readRaw(args, type)) return false;
+
+        char buffer[32];
+        switch (type) {
+            case BinaryLog::ArgType::INT64: {
+                std::int64_t value;
+                if (!BinaryLog::readRaw(args, value)) return false;
+                const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                out.append(buffer, result.ptr);
+                return true;
+            }
+            case BinaryLog::ArgType::DOUBLE: {
+                double value;
+                if (!BinaryLog::readRaw(args, value)) return false;
+                const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                out.append(buffer, result.ptr);
+                return true;
+            }
+            case BinaryLog::ArgType::STRING: {
+                std::uint32_t length;
+                if (!BinaryLog::readRaw(args, length) || args.size() < length) return false;
+                out.append(args.substr(0, length));
+                args.remove_prefix(length);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool BinaryLog::renderMessage(std::string_view pattern, std::string_view args, std::size_t argc, std::string& out) {
+    std::size_t rendered = 0;
+    for (;;) {
+        const std::size_t placeholder = pattern.find("{}");
+        if (placeholder == std::string_view::npos || rendered == argc) {
+            out.append(pattern);
+            return true;
+        }
+        out.append(pattern.substr(0, placeholder));
+        if (!renderArg(args, out)) return false;
+        rendered++;
+        pattern.remove_prefix(placeholder + 2);
+    }
+}
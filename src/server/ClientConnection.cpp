@@ -2,7 +2,8 @@
 #include <unistd.h> // Para close()
 
 ClientConnection::ClientConnection(const int id, const int sock, const sockaddr_storage& addr, socklen_t len, Protocol proto)
-    : clientID(id), socket(sock), clientAddress(addr), addressLength(len), protocol(proto), connected(true) {}
+    : clientID(id), socket(sock), clientAddress(addr), addressLength(len), protocol(proto), connected(true),
+      lastActivity(std::chrono::steady_clock::now()) {}
 
 int ClientConnection::getClientID() const {
     return clientID;
@@ -12,7 +13,7 @@ int ClientConnection::getSocket() const {
     return socket;
 }
 
-sockaddr_storage ClientConnection::getAddress() const {
+const sockaddr_storage& ClientConnection::getAddress() const {
     return clientAddress;
 }
 
@@ -31,3 +32,82 @@ bool ClientConnection::isConnected() const {
 void ClientConnection::disconnect() {
     connected = false;
 }
+
+void ClientConnection::touch(const std::chrono::steady_clock::time_point now) {
+    lastActivity = now;
+}
+
+std::chrono::steady_clock::time_point ClientConnection::getLastActivity() const {
+    return lastActivity;
+}
+
+void ClientConnection::queueOutbound(SharedPayload payload) {
+    if (payload && !payload->empty()) {
+        outboundBytes += payload->size();
+        outbound.push_back(std::move(payload));
+    }
+}
+
+bool ClientConnection::hasPendingOutput() const {
+    return !outbound.empty();
+}
+
+std::size_t ClientConnection::getPendingOutputCount() const {
+    return outbound.size();
+}
+
+std::size_t ClientConnection::getPendingOutputBytes() const {
+    return outboundBytes;
+}
+
+std::size_t ClientConnection::getHighWaterMark() const {
+    return highWaterMark;
+}
+
+void ClientConnection::setHighWaterMark(const std::size_t bytes) {
+    highWaterMark = bytes;
+}
+
+bool ClientConnection::wouldExceedHighWaterMark(const std::size_t additionalBytes) const {
+    return outboundBytes + additionalBytes > highWaterMark;
+}
+
+std::size_t ClientConnection::fillOutboundIov(iovec* iov, const std::size_t maxEntries) const {
+    std::size_t count = 0;
+    for (const SharedPayload& payload : outbound) {
+        if (count == maxEntries) break;
+        const std::size_t skip = count == 0 ? outboundOffset : 0;
+        iov[count].iov_base = const_cast<char*>(payload->data() + skip);
+        iov[count].iov_len = payload->size() - skip;
+        count++;
+    }
+    return count;
+}
+
+SharedPayload ClientConnection::getOutboundAt(const std::size_t index) const {
+    return outbound[index];
+}
+
+void ClientConnection::consumeOutboundBytes(std::size_t bytes) {
+    while (bytes > 0 && !outbound.empty()) {
+        const std::size_t remaining = outbound.front()->size() - outboundOffset;
+        if (bytes < remaining) {
+            outboundOffset += bytes;
+            outboundBytes -= bytes;
+            return;
+        }
+        bytes -= remaining;
+        outboundBytes -= remaining;
+        outbound.pop_front();
+        outboundOffset = 0;
+    }
+}
+
+void ClientConnection::consumeOutboundMessages(std::size_t count) {
+    while (count > 0 && !outbound.empty()) {
+        outboundBytes -= outbound.front()->size() - outboundOffset;
+        outboundOffset = 0;
+        outbound.pop_front();
+        count--;
+    }
+}
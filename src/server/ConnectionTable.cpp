@@ -0,0 +1,61 @@
+#include "server/ConnectionTable.hpp"
+
+int ConnectionTable::emplace(int sock, const sockaddr_storage& addr, socklen_t len, ClientConnection::Protocol proto) {
+    std::size_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        if (slots.size() >= ConnectionTableConstants::MAX_CONNECTIONS) return -1;
+        index = slots.size();
+        slots.emplace_back();
+    }
+
+    Slot& slot = slots[index];
+    const int clientID = static_cast<int>(slot.generation << ConnectionTableConstants::INDEX_BITS | (index + 1));
+    slot.connection.emplace(clientID, sock, addr, len, proto);
+    count++;
+    return clientID;
+}
+
+ClientConnection* ConnectionTable::find(int clientID) {
+    const std::optional<std::size_t> index = slotOf(clientID);
+    return index ? &*slots[*index].connection : nullptr;
+}
+
+const ClientConnection* ConnectionTable::find(int clientID) const {
+    const std::optional<std::size_t> index = slotOf(clientID);
+    return index ? &*slots[*index].connection : nullptr;
+}
+
+bool ConnectionTable::contains(int clientID) const {
+    return slotOf(clientID).has_value();
+}
+
+bool ConnectionTable::erase(int clientID) {
+    const std::optional<std::size_t> index = slotOf(clientID);
+    if (!index) return false;
+
+    Slot& slot = slots[*index];
+    slot.connection.reset();
+    slot.generation = slot.generation == ConnectionTableConstants::MAX_GENERATION ? 0 : slot.generation + 1;
+    freeSlots.push_back(*index);
+    count--;
+    return true;
+}
+
+std::size_t ConnectionTable::size() const {
+    return count;
+}
+
+std::optional<std::size_t> ConnectionTable::slotOf(int clientID) const {
+    if (clientID <= 0) return std::nullopt;
+
+    const auto id = static_cast<std::uint32_t>(clientID);
+    const std::size_t slotNumber = id & ConnectionTableConstants::MAX_CONNECTIONS;
+    if (slotNumber == 0 || slotNumber > slots.size()) return std::nullopt;
+
+    const Slot& slot = slots[slotNumber - 1];
+    if (!slot.connection || slot.generation != id >> ConnectionTableConstants::INDEX_BITS) return std::nullopt;
+    return slotNumber - 1;
+}
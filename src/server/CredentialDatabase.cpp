@@ -0,0 +1,193 @@
+#include "server/CredentialDatabase.hpp"
+#include "server/Crypto.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    struct FileHeader {
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t reserved;
+        std::uint32_t entryCount;
+        std::uint32_t phraseIterations; // Zero when no phrase is stored.
+        std::uint8_t phraseSalt[CredentialDatabaseConstants::SALT_BYTES];
+        std::uint8_t phraseHash[CredentialDatabaseConstants::HASH_BYTES];
+    };
+
+    struct FileEntry {
+        std::int32_t clientID;
+        std::uint32_t iterations;
+        std::uint8_t salt[CredentialDatabaseConstants::SALT_BYTES];
+        std::uint8_t hash[CredentialDatabaseConstants::HASH_BYTES];
+        std::uint8_t group;
+        std::uint8_t reserved[7];
+    };
+
+    static_assert(sizeof(FileHeader) == 64 && sizeof(FileEntry) == 64, "Credential database records must stay 64 bytes");
+
+    bool writeAll(int fd, const void* data, std::size_t length) {
+        auto bytes = static_cast<const char*>(data);
+        while (length > 0) {
+            const ssize_t written = ::write(fd, bytes, length);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            bytes += written;
+            length -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+}
+
+CredentialDatabase::CredentialDatabase(const std::string& path) : mapped(nullptr), mappedBytes(0), entryCount(0) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open credential database " + path);
+    }
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        throw std::runtime_error("Credential database " + path + " is too short");
+    }
+    mappedBytes = static_cast<std::size_t>(info.st_size);
+
+    void* region = mmap(nullptr, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region == MAP_FAILED) {
+        throw std::runtime_error("Failed to map credential database " + path);
+    }
+    mapped = static_cast<const unsigned char*>(region);
+
+    FileHeader header{};
+    std::memcpy(&header, mapped, sizeof(header));
+    if (std::memcmp(header.magic, CredentialDatabaseConstants::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CredentialDatabaseConstants::VERSION ||
+        mappedBytes != sizeof(FileHeader) + static_cast<std::size_t>(header.entryCount) * sizeof(FileEntry)) {
+        munmap(const_cast<unsigned char*>(mapped), mappedBytes);
+        throw std::runtime_error("Credential database " + path + " is malformed");
+    }
+    entryCount = header.entryCount;
+}
+
+CredentialDatabase::~CredentialDatabase() {
+    munmap(const_cast<unsigned char*>(mapped), mappedBytes);
+}
+
+std::optional<CredentialDatabase::Entry> CredentialDatabase::find(const int clientID) const {
+    std::size_t low = 0;
+    std::size_t high = entryCount;
+    while (low < high) {
+        const std::size_t middle = low + (high - low) / 2;
+        std::int32_t id;
+        std::memcpy(&id, mapped + sizeof(FileHeader) + middle * sizeof(FileEntry) + offsetof(FileEntry, clientID), sizeof(id));
+        if (id == clientID) return entryAt(middle);
+        if (id < clientID) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return std::nullopt;
+}
+
+std::size_t CredentialDatabase::size() const {
+    return entryCount;
+}
+
+bool CredentialDatabase::hasSecretPhrase() const {
+    FileHeader header{};
+    std::memcpy(&header, mapped, sizeof(header));
+    return header.phraseIterations != 0;
+}
+
+bool CredentialDatabase::verifySecretPhrase(const std::string& phrase) const {
+    FileHeader header{};
+    std::memcpy(&header, mapped, sizeof(header));
+    if (header.phraseIterations == 0) return false;
+
+    const std::string salt(reinterpret_cast<const char*>(header.phraseSalt), sizeof(header.phraseSalt));
+    const std::string expected(reinterpret_cast<const char*>(header.phraseHash), sizeof(header.phraseHash));
+    const std::string actual = Crypto::pbkdf2Sha256(phrase, salt, header.phraseIterations, expected.size());
+    return Crypto::constantTimeEquals(actual, expected);
+}
+
+CredentialDatabase::Entry CredentialDatabase::makeEntry(const int clientID, const std::string& password,
+                                                        const std::uint32_t iterations, const std::uint8_t group) {
+    Entry entry{};
+    entry.clientID = clientID;
+    entry.iterations = iterations;
+    entry.group = group;
+
+    const std::string salt = Crypto::randomBytes(entry.salt.size());
+    const std::string hash = Crypto::pbkdf2Sha256(password, salt, iterations, entry.hash.size());
+    std::memcpy(entry.salt.data(), salt.data(), entry.salt.size());
+    std::memcpy(entry.hash.data(), hash.data(), entry.hash.size());
+    return entry;
+}
+
+void CredentialDatabase::write(const std::string& path, std::vector<Entry> entries, const std::string& secretPhrase,
+                               const std::uint32_t iterations) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.clientID < b.clientID; });
+    const auto duplicate = std::adjacent_find(entries.begin(), entries.end(),
+                                              [](const Entry& a, const Entry& b) { return a.clientID == b.clientID; });
+    if (duplicate != entries.end()) {
+        throw std::invalid_argument("Duplicate client ID " + std::to_string(duplicate->clientID) + " in credential database");
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, CredentialDatabaseConstants::MAGIC, sizeof(header.magic));
+    header.version = CredentialDatabaseConstants::VERSION;
+    header.entryCount = static_cast<std::uint32_t>(entries.size());
+    if (!secretPhrase.empty()) {
+        const std::string salt = Crypto::randomBytes(sizeof(header.phraseSalt));
+        const std::string hash = Crypto::pbkdf2Sha256(secretPhrase, salt, iterations, sizeof(header.phraseHash));
+        header.phraseIterations = iterations;
+        std::memcpy(header.phraseSalt, salt.data(), sizeof(header.phraseSalt));
+        std::memcpy(header.phraseHash, hash.data(), sizeof(header.phraseHash));
+    }
+
+    std::vector<FileEntry> records(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        records[i].clientID = entries[i].clientID;
+        records[i].iterations = entries[i].iterations;
+        std::memcpy(records[i].salt, entries[i].salt.data(), sizeof(records[i].salt));
+        std::memcpy(records[i].hash, entries[i].hash.data(), sizeof(records[i].hash));
+        records[i].group = entries[i].group;
+    }
+
+    const std::string temporary = path + ".tmp";
+    const int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create credential database " + temporary);
+    }
+    const bool written = writeAll(fd, &header, sizeof(header)) &&
+                         writeAll(fd, records.data(), records.size() * sizeof(FileEntry)) && fsync(fd) == 0;
+    close(fd);
+    if (!written || rename(temporary.c_str(), path.c_str()) != 0) {
+        unlink(temporary.c_str());
+        throw std::runtime_error("Failed to write credential database " + path);
+    }
+}
+
+CredentialDatabase::Entry CredentialDatabase::entryAt(const std::size_t index) const {
+    FileEntry record;
+    std::memcpy(&record, mapped + sizeof(FileHeader) + index * sizeof(FileEntry), sizeof(record));
+
+    Entry entry{};
+    entry.clientID = record.clientID;
+    entry.iterations = record.iterations;
+    std::memcpy(entry.salt.data(), record.salt, entry.salt.size());
+    std::memcpy(entry.hash.data(), record.hash, entry.hash.size());
+    entry.group = record.group;
+    return entry;
+}
@@ -0,0 +1,261 @@
+#include "server/Crypto.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/random.h>
+
+namespace {
+    constexpr std::array<std::uint32_t, 64> ROUND_CONSTANTS = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    constexpr std::uint32_t rotr(std::uint32_t value, int bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+}
+
+Crypto::Sha256::Sha256()
+    : state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19},
+      buffer{}, buffered(0), totalBytes(0) {}
+
+void Crypto::Sha256::update(const void* data, std::size_t length) {
+    auto bytes = static_cast<const std::uint8_t*>(data);
+    totalBytes += length;
+
+    if (buffered > 0) {
+        const std::size_t take = std::min(length, SHA256_BLOCK_BYTES - buffered);
+        std::memcpy(buffer.data() + buffered, bytes, take);
+        buffered += take;
+        bytes += take;
+        length -= take;
+        if (buffered < SHA256_BLOCK_BYTES) return;
+        compress(buffer.data());
+        buffered = 0;
+    }
+    while (length >= SHA256_BLOCK_BYTES) {
+        compress(bytes);
+        bytes += SHA256_BLOCK_BYTES;
+        length -= SHA256_BLOCK_BYTES;
+    }
+    std::memcpy(buffer.data(), bytes, length);
+    buffered = length;
+}
+
+void Crypto::Sha256::update(std::string_view data) {
+    update(data.data(), data.size());
+}
+
+Crypto::Sha256Digest Crypto::Sha256::finish() {
+    const std::uint64_t bitLength = totalBytes * 8;
+    constexpr std::uint8_t padding[SHA256_BLOCK_BYTES] = {0x80};
+    const std::size_t padBytes = buffered < 56 ? 56 - buffered : 120 - buffered;
+    update(padding, padBytes);
+
+    std::uint8_t lengthBytes[8];
+    for (int i = 0; i < 8; ++i) {
+        lengthBytes[i] = static_cast<std::uint8_t>(bitLength >> (56 - 8 * i));
+    }
+    update(lengthBytes, sizeof(lengthBytes));
+
+    Sha256Digest digest;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        digest[4 * i] = static_cast<std::uint8_t>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<std::uint8_t>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<std::uint8_t>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<std::uint8_t>(state[i]);
+    }
+    return digest;
+}
+
+Crypto::Sha256Digest Crypto::Sha256::finishWith(const Sha256Digest& data) const {
+    std::uint8_t block[SHA256_BLOCK_BYTES] = {};
+    std::memcpy(block, data.data(), data.size());
+    block[data.size()] = 0x80;
+    const std::uint64_t bitLength = (totalBytes + data.size()) * 8;
+    for (int i = 0; i < 8; ++i) {
+        block[56 + i] = static_cast<std::uint8_t>(bitLength >> (56 - 8 * i));
+    }
+
+    Sha256 hasher = *this;
+    hasher.compress(block);
+
+    Sha256Digest digest;
+    for (std::size_t i = 0; i < hasher.state.size(); ++i) {
+        digest[4 * i] = static_cast<std::uint8_t>(hasher.state[i] >> 24);
+        digest[4 * i + 1] = static_cast<std::uint8_t>(hasher.state[i] >> 16);
+        digest[4 * i + 2] = static_cast<std::uint8_t>(hasher.state[i] >> 8);
+        digest[4 * i + 3] = static_cast<std::uint8_t>(hasher.state[i]);
+    }
+    return digest;
+}
+
+void Crypto::Sha256::compress(const std::uint8_t* block) {
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = static_cast<std::uint32_t>(block[4 * i]) << 24 | static_cast<std::uint32_t>(block[4 * i + 1]) << 16 |
+               static_cast<std::uint32_t>(block[4 * i + 2]) << 8 | static_cast<std::uint32_t>(block[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; ++i) {
+        const std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        const std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        const std::uint32_t choice = (e & f) ^ (~e & g);
+        const std::uint32_t temp1 = h + s1 + choice + ROUND_CONSTANTS[i] + w[i];
+        const std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        const std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        const std::uint32_t temp2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+Crypto::HmacSha256::HmacSha256(std::string_view key) {
+    std::uint8_t block[SHA256_BLOCK_BYTES] = {};
+    if (key.size() > SHA256_BLOCK_BYTES) {
+        const Sha256Digest hashed = sha256(key);
+        std::memcpy(block, hashed.data(), hashed.size());
+    } else {
+        std::memcpy(block, key.data(), key.size());
+    }
+
+    std::uint8_t pad[SHA256_BLOCK_BYTES];
+    for (std::size_t i = 0; i < SHA256_BLOCK_BYTES; ++i) pad[i] = block[i] ^ 0x36;
+    inner.update(pad, sizeof(pad));
+    for (std::size_t i = 0; i < SHA256_BLOCK_BYTES; ++i) pad[i] = block[i] ^ 0x5c;
+    outer.update(pad, sizeof(pad));
+}
+
+Crypto::Sha256Digest Crypto::HmacSha256::compute(const void* data, std::size_t length) const {
+    Sha256 innerHash = inner;
+    innerHash.update(data, length);
+    const Sha256Digest innerDigest = innerHash.finish();
+
+    Sha256 outerHash = outer;
+    outerHash.update(innerDigest.data(), innerDigest.size());
+    return outerHash.finish();
+}
+
+Crypto::Sha256Digest Crypto::HmacSha256::compute(std::string_view data) const {
+    return compute(data.data(), data.size());
+}
+
+Crypto::Sha256Digest Crypto::HmacSha256::compute(const Sha256Digest& data) const {
+    return outer.finishWith(inner.finishWith(data));
+}
+
+Crypto::Sha256Digest Crypto::sha256(std::string_view data) {
+    Sha256 hasher;
+    hasher.update(data);
+    return hasher.finish();
+}
+
+std::string Crypto::pbkdf2Sha256(std::string_view password, std::string_view salt, std::uint32_t iterations, std::size_t length) {
+    const HmacSha256 prf(password);
+    std::string derived;
+    derived.reserve(length);
+
+    for (std::uint32_t blockIndex = 1; derived.size() < length; ++blockIndex) {
+        std::string first(salt);
+        first.push_back(static_cast<char>(blockIndex >> 24));
+        first.push_back(static_cast<char>(blockIndex >> 16));
+        first.push_back(static_cast<char>(blockIndex >> 8));
+        first.push_back(static_cast<char>(blockIndex));
+
+        Sha256Digest u = prf.compute(first);
+        Sha256Digest t = u;
+        for (std::uint32_t i = 1; i < iterations; ++i) {
+            u = prf.compute(u);
+            for (std::size_t j = 0; j < t.size(); ++j) t[j] ^= u[j];
+        }
+
+        const std::size_t take = std::min(t.size(), length - derived.size());
+        derived.append(reinterpret_cast<const char*>(t.data()), take);
+    }
+    return derived;
+}
+
+std::string Crypto::randomBytes(std::size_t count) {
+    std::string bytes(count, '\0');
+    std::size_t filled = 0;
+    while (filled < count) {
+        const ssize_t got = getrandom(bytes.data() + filled, count - filled, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to read random bytes");
+        }
+        filled += static_cast<std::size_t>(got);
+    }
+    return bytes;
+}
+
+std::string Crypto::toHex(std::string_view data) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(data.size() * 2);
+    for (const char c : data) {
+        const auto byte = static_cast<std::uint8_t>(c);
+        hex.push_back(DIGITS[byte >> 4]);
+        hex.push_back(DIGITS[byte & 0x0f]);
+    }
+    return hex;
+}
+
+bool Crypto::fromHex(std::string_view hex, std::string& out) {
+    if (hex.size() % 2 != 0) return false;
+
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+
+    out.clear();
+    out.reserve(hex.size() / 2);
+    for (std::size_t i = 0; i < hex.size(); i += 2) {
+        const int high = nibble(hex[i]);
+        const int low = nibble(hex[i + 1]);
+        if (high < 0 || low < 0) return false;
+        out.push_back(static_cast<char>(high << 4 | low));
+    }
+    return true;
+}
+
+bool Crypto::constantTimeEquals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+
+    unsigned char difference = 0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        difference |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return difference == 0;
+}
@@ -1,43 +1,405 @@
 #include "server/EventLogger.hpp"
-#include <ctime>
-#include <iomanip>
-#include <sstream>
+#include "common/logcore.h"
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
 
-EventLogger::EventLogger(const std::string& logFilePath) {
-    logFile.open(logFilePath, std::ios::app);
-    if (!logFile.is_open()) {
-        throw std::runtime_error("No se pudo abrir el archivo de log: " + logFilePath);
+std::atomic<EventLogger*> EventLogger::signalTarget{nullptr};
+std::atomic<std::uint64_t> EventLogger::nextInstance{1};
+
+EventLogger::RecordRing::RecordRing(std::size_t capacity) : enqueuePos(0), dequeuePos(0) {
+    std::size_t rounded = 2;
+    while (rounded < capacity) rounded <<= 1;
+
+    cells = std::make_unique<Cell[]>(rounded);
+    mask = rounded - 1;
+    for (std::size_t i = 0; i < rounded; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
     }
 }
 
+bool EventLogger::RecordRing::tryPush(std::string& record) {
+    std::uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        const std::uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq - pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record = std::move(record);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventLogger::RecordRing::tryPop(std::string& record) {
+    const std::uint64_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell& cell = cells[pos & mask];
+    const std::uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<std::int64_t>(seq - (pos + 1)) < 0) return false;
+
+    record = std::move(cell.record);
+    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+    dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+std::uint64_t EventLogger::RecordRing::pushedCount() const {
+    return enqueuePos.load(std::memory_order_acquire);
+}
+
+std::size_t EventLogger::RecordRing::approximateSize() const {
+    const std::uint64_t head = enqueuePos.load(std::memory_order_relaxed);
+    const std::uint64_t tail = dequeuePos.load(std::memory_order_relaxed);
+    return head > tail ? static_cast<std::size_t>(head - tail) : 0;
+}
+
+std::size_t EventLogger::RecordRing::capacity() const {
+    return mask + 1;
+}
+
+EventLogger::EventLogger(const std::string& logFilePath) : EventLogger(logFilePath, Config{}) {}
+
+EventLogger::EventLogger(const std::string& logFilePath, const Config& config)
+    : config(config), ring(config.ringCapacity), instance(nextInstance.fetch_add(1)), minLevel(config.level),
+      componentLevels(std::make_unique<std::atomic<std::uint8_t>[]>(EventLoggerConstants::MAX_COMPONENTS)),
+      componentOverrides(0), writtenCount(0), flushWaiters(0), stopping(false) {
+    for (std::size_t i = 0; i < EventLoggerConstants::MAX_COMPONENTS; ++i) {
+        componentLevels[i].store(EventLoggerConstants::INHERIT_LEVEL, std::memory_order_relaxed);
+    }
+
+    if (isRotating()) {
+        RotatingLogFile::Options options;
+        if (config.rotateBytes > 0) options.segmentBytes = config.rotateBytes;
+        options.interval = config.rotateInterval;
+        options.keepSegments = config.keepSegments;
+        rotatingFile = std::make_unique<RotatingLogFile>(logFilePath, options);
+        logFd = -1;
+    } else {
+        logFd = open(logFilePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (logFd < 0) {
+            throw std::runtime_error("No se pudo abrir el archivo de log: " + logFilePath);
+        }
+    }
+    writer = std::thread(&EventLogger::writerLoop, this);
+
+    if (config.format == Format::BINARY) {
+        std::string session;
+        BinaryLog::appendRecordHeader(session, BinaryLog::RecordKind::SESSION, sizeof(BinaryLog::MAGIC) + sizeof(BinaryLog::VERSION));
+        session.append(BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC));
+        BinaryLog::appendRaw(session, BinaryLog::VERSION);
+        pushRecord(session);
+    }
+    registerFormat("{}");
+}
+
 EventLogger::~EventLogger() {
-    if (logFile.is_open()) {
-        logFile.close();
+    EventLogger* self = this;
+    signalTarget.compare_exchange_strong(self, nullptr);
+    {
+        std::lock_guard lock(writerMutex);
+        stopping = true;
     }
+    writerWake.notify_one();
+    writer.join();
+    rotatingFile.reset();
+    if (logFd >= 0) close(logFd);
 }
 
 void EventLogger::logEvent(const std::string& component, LogLevel level, const std::string& message) {
-    std::string timestamp = getCurrentTimestamp();
-    std::string levelStr = logLevelToString(level);
-    logFile << "[" << timestamp << "] "
-            << "[" << component << "] "
-            << "[" << levelStr << "] "
-            << message << std::endl;
+    if (config.format == Format::BINARY) {
+        const ComponentId id = resolveComponent(component);
+        if (!isEnabled(id, level)) return;
+
+        timespec now{};
+        clock_gettime(CLOCK_REALTIME, &now);
+        std::string args;
+        BinaryLog::appendArg(args, message);
+        pushBinaryEvent(id, level, BinaryLog::MESSAGE_FORMAT_ID, 1, args, now);
+        return;
+    }
+    if (!isEnabled(component, level)) return;
+
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    std::string record;
+    formatTextRecord(record, now, config.precision, component, level, message);
+    pushRecord(record);
+}
+
+bool EventLogger::isEnabled(const std::string& component, LogLevel level) {
+    if (componentOverrides.load(std::memory_order_relaxed) == 0) {
+        return isEnabled(level);
+    }
+    return isEnabled(resolveComponent(component), level);
+}
+
+void EventLogger::setLevel(LogLevel level) {
+    minLevel.store(level, std::memory_order_relaxed);
+}
+
+EventLogger::LogLevel EventLogger::getLevel() const {
+    return minLevel.load(std::memory_order_relaxed);
+}
+
+void EventLogger::setComponentLevel(const std::string& component, LogLevel level) {
+    const ComponentId id = registerComponent(component);
+    const std::uint8_t previous = componentLevels[id].exchange(static_cast<std::uint8_t>(level));
+    if (previous == EventLoggerConstants::INHERIT_LEVEL) {
+        componentOverrides.fetch_add(1);
+    }
+}
+
+void EventLogger::clearComponentLevel(const std::string& component) {
+    std::lock_guard lock(registryMutex);
+    const auto it = componentIds.find(component);
+    if (it == componentIds.end()) return;
+
+    const std::uint8_t previous = componentLevels[it->second].exchange(EventLoggerConstants::INHERIT_LEVEL);
+    if (previous != EventLoggerConstants::INHERIT_LEVEL) {
+        componentOverrides.fetch_sub(1);
+    }
+}
+
+void EventLogger::enableSignalControl(EventLogger* logger) {
+    static_assert(std::atomic<LogLevel>::is_always_lock_free, "levels must be settable from a signal handler");
+    signalTarget.store(logger);
+
+    struct sigaction action{};
+    action.sa_handler = logger != nullptr ? &EventLogger::handleLevelSignal : SIG_DFL;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, nullptr);
+    sigaction(SIGUSR2, &action, nullptr);
+}
+
+void EventLogger::handleLevelSignal(int signal) {
+    EventLogger* logger = signalTarget.load();
+    if (logger == nullptr) return;
+    logger->minLevel.store(signal == SIGUSR1 ? DEBUG : logger->config.level, std::memory_order_relaxed);
+}
+
+EventLogger::ComponentId EventLogger::registerComponent(const std::string& name) {
+    std::lock_guard lock(registryMutex);
+    return registerName(componentIds, componentNames, BinaryLog::RecordKind::COMPONENT, name);
+}
+
+EventLogger::ComponentId EventLogger::resolveComponent(const std::string& name) {
+    // Component IDs are never reassigned, so a cached ID stays valid for the logger's lifetime.
+    thread_local std::uint64_t cachedInstance = 0;
+    thread_local std::unordered_map<std::string, ComponentId> cachedIds;
+    if (cachedInstance != instance) {
+        cachedIds.clear();
+        cachedInstance = instance;
+    }
+
+    if (const auto it = cachedIds.find(name); it != cachedIds.end()) {
+        return it->second;
+    }
+    const ComponentId id = registerComponent(name);
+    cachedIds.emplace(name, id);
+    return id;
 }
 
-std::string EventLogger::getCurrentTimestamp() const {
-    std::time_t now = std::time(nullptr);
-    std::tm* tm = std::localtime(&now);
-    std::ostringstream oss;
-    oss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+EventLogger::FormatId EventLogger::registerFormat(const std::string& pattern) {
+    std::lock_guard lock(registryMutex);
+    return registerName(formatIds, formatPatterns, BinaryLog::RecordKind::FORMAT, pattern);
 }
 
-std::string EventLogger::logLevelToString(LogLevel level) const {
-    switch (level) {
-        case INFO: return "INFO";
-        case WARNING: return "WARNING";
-        case ERROR: return "ERROR";
-        default: return "UNKNOWN";
+void EventLogger::flush() {
+    const std::uint64_t target = ring.pushedCount();
+
+    std::unique_lock lock(writerMutex);
+    flushWaiters++;
+    writerWake.notify_one();
+    flushDone.wait(lock, [&] { return writtenCount.load() >= target; });
+    flushWaiters--;
+}
+
+void EventLogger::formatTextRecord(std::string& out, const timespec& time, TimestampPrecision precision,
+                                   std::string_view component, LogLevel level, std::string_view message) {
+    const std::size_t start = out.size();
+    out.resize(start + logCoreRecordCapacity(component.size(), message.size()));
+    const std::size_t length = logCoreFormatRecord(out.data() + start, &time, fractionDigits(precision),
+                                                   component.data(), component.size(), level,
+                                                   message.data(), message.size());
+    out.resize(start + length);
+}
+
+void EventLogger::writerLoop() {
+    std::string batch;
+    batch.reserve(EventLoggerConstants::WRITE_BATCH_BYTES * 2);
+    std::string record;
+
+    for (;;) {
+        std::uint64_t batched = 0;
+        while (ring.tryPop(record)) {
+            trackPreamble(record);
+            batch += record;
+            batched++;
+            if (batch.size() >= EventLoggerConstants::WRITE_BATCH_BYTES) {
+                writeAll(batch.data(), batch.size());
+                writtenCount.fetch_add(batched);
+                batch.clear();
+                batched = 0;
+            }
+        }
+        if (!batch.empty()) {
+            writeAll(batch.data(), batch.size());
+            writtenCount.fetch_add(batched);
+            batch.clear();
+        }
+        if (rotatingFile) {
+            rotatingFile->rotateIfDue();
+        }
+
+        std::unique_lock lock(writerMutex);
+        flushDone.notify_all();
+        const bool drained = writtenCount.load() >= ring.pushedCount();
+        if (stopping && drained) break;
+
+        if (drained || flushWaiters == 0) {
+            writerWake.wait_for(lock, config.flushInterval, [&] {
+                return stopping || flushWaiters > 0 || ring.approximateSize() >= ring.capacity() / 2;
+            });
+        } else {
+            // A producer has claimed a cell but not filled it yet; give it a moment.
+            lock.unlock();
+            std::this_thread::yield();
+        }
     }
 }
+
+bool EventLogger::isRotating() const {
+    return config.rotateBytes > 0 || config.rotateInterval.count() > 0;
+}
+
+void EventLogger::trackPreamble(const std::string& record) {
+    if (!rotatingFile || config.format != Format::BINARY || record.empty()) return;
+
+    const auto kind = static_cast<BinaryLog::RecordKind>(record[0]);
+    if (kind == BinaryLog::RecordKind::SESSION) {
+        rotatingFile->clearPreamble();
+    }
+    if (kind != BinaryLog::RecordKind::EVENT) {
+        rotatingFile->appendPreamble(record);
+    }
+}
+
+void EventLogger::writeAll(const char* data, std::size_t length) const {
+    if (rotatingFile) {
+        rotatingFile->write(data, length);
+        return;
+    }
+    while (length > 0) {
+        const ssize_t written = write(logFd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += written;
+        length -= static_cast<std::size_t>(written);
+    }
+}
+
+void EventLogger::wakeWriter() {
+    writerWake.notify_one();
+}
+
+void EventLogger::pushRecord(std::string& record) {
+    // A full ring means the writer is behind; wait for room instead of losing the record.
+    while (!ring.tryPush(record)) {
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    if (ring.approximateSize() >= ring.capacity() / 2) {
+        wakeWriter();
+    }
+}
+
+void EventLogger::logEncoded(ComponentId component, LogLevel level, FormatId format, std::size_t argc, const std::string& args) {
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    if (config.format == Format::BINARY) {
+        pushBinaryEvent(component, level, format, argc, args, now);
+        return;
+    }
+
+    std::string message;
+    std::string record;
+    {
+        std::lock_guard lock(registryMutex);
+        if (format < formatPatterns.size()) {
+            BinaryLog::renderMessage(formatPatterns[format], args, argc, message);
+        }
+        const std::string_view name = component < componentNames.size() ? std::string_view(componentNames[component]) : "UNKNOWN";
+        formatTextRecord(record, now, config.precision, name, level, message);
+    }
+    pushRecord(record);
+}
+
+void EventLogger::pushBinaryEvent(ComponentId component, LogLevel level, FormatId format, std::size_t argc,
+                                  std::string_view args, const timespec& time) {
+    std::string record;
+    record.reserve(BinaryLog::RECORD_HEADER_SIZE + BinaryLog::EVENT_FIXED_SIZE + args.size());
+    BinaryLog::appendRecordHeader(record, BinaryLog::RecordKind::EVENT, BinaryLog::EVENT_FIXED_SIZE + args.size());
+    BinaryLog::appendRaw(record, component);
+    BinaryLog::appendRaw(record, static_cast<std::uint8_t>(level));
+    BinaryLog::appendRaw(record, static_cast<std::int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec);
+    BinaryLog::appendRaw(record, format);
+    BinaryLog::appendRaw(record, static_cast<std::uint8_t>(argc));
+    record.append(args);
+    pushRecord(record);
+}
+
+void EventLogger::pushDefinition(BinaryLog::RecordKind kind, std::uint16_t id, std::string_view text) {
+    std::string record;
+    BinaryLog::appendRecordHeader(record, kind, sizeof(id) + text.size());
+    BinaryLog::appendRaw(record, id);
+    record.append(text);
+    pushRecord(record);
+}
+
+std::uint16_t EventLogger::registerName(std::unordered_map<std::string, std::uint16_t>& ids,
+                                        std::vector<std::string>& names, BinaryLog::RecordKind kind,
+                                        const std::string& name) {
+    if (const auto it = ids.find(name); it != ids.end()) {
+        return it->second;
+    }
+    if (names.size() > std::numeric_limits<std::uint16_t>::max()) {
+        throw std::runtime_error("Too many log registrations: " + name);
+    }
+
+    const auto id = static_cast<std::uint16_t>(names.size());
+    names.push_back(name);
+    ids.emplace(name, id);
+    // Written while the registry is locked, so the definition precedes every event using the ID.
+    if (config.format == Format::BINARY) {
+        pushDefinition(kind, id, name);
+    }
+    return id;
+}
+
+int EventLogger::fractionDigits(TimestampPrecision precision) {
+    switch (precision) {
+        case TimestampPrecision::MILLISECONDS: return 3;
+        case TimestampPrecision::MICROSECONDS: return 6;
+        case TimestampPrecision::SECONDS: break;
+    }
+    return 0;
+}
+
+std::string_view EventLogger::logLevelToString(LogLevel level) {
+    return logCoreLevelName(level);
+}
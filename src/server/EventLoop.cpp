@@ -0,0 +1,188 @@
+#include "server/EventLoop.hpp"
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+void EventLoop::ScheduleAwaiter::await_suspend(std::coroutine_handle<> handle) const {
+    loop->post([handle] { handle.resume(); });
+}
+
+void EventLoop::IoAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // Registration happens on the loop thread, where the registrations live.
+    loop->post([this, handle] {
+        const bool registered = loop->watch(fd, events, [this, handle](const std::uint32_t ready) {
+            revents = ready;
+            loop->unwatch(fd, events);
+            handle.resume();
+        });
+        if (!registered) {
+            revents = EPOLLERR;
+            handle.resume();
+        }
+    });
+}
+
+EventLoop::EventLoop() : stopRequested(false), loopThread(std::thread::id()) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        close(epollFd);
+        throw std::runtime_error("Failed to create eventfd");
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev) < 0) {
+        close(wakeFd);
+        close(epollFd);
+        throw std::runtime_error("Failed to register eventfd");
+    }
+}
+
+EventLoop::~EventLoop() {
+    close(wakeFd);
+    close(epollFd);
+}
+
+void EventLoop::post(Callback callback) {
+    {
+        std::lock_guard lock(postedMutex);
+        posted.push_back(std::move(callback));
+    }
+    wakeUp();
+}
+
+bool EventLoop::watch(const int fd, const std::uint32_t events, IoHandler handler) {
+    std::vector<Registration>& watched = registrations[fd];
+    const std::uint32_t current = interestOf(watched);
+    if ((current & events) != 0) {
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = current | events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd, watched.empty() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev) < 0) {
+        if (watched.empty()) registrations.erase(fd);
+        return false;
+    }
+    watched.push_back({events, std::make_shared<IoHandler>(std::move(handler))});
+    return true;
+}
+
+void EventLoop::unwatch(const int fd, const std::uint32_t events) {
+    const auto it = registrations.find(fd);
+    if (it == registrations.end()) return;
+
+    std::erase_if(it->second, [events](const Registration& registration) {
+        return (registration.events & events) != 0;
+    });
+    if (it->second.empty()) {
+        registrations.erase(it);
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    epoll_event ev{};
+    ev.events = interestOf(it->second);
+    ev.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+std::size_t EventLoop::runOnce(const int timeoutMs) {
+    loopThread.store(std::this_thread::get_id());
+
+    epoll_event events[EventLoopConstants::MAX_EVENTS_PER_WAIT];
+    const int ready = epoll_wait(epollFd, events, EventLoopConstants::MAX_EVENTS_PER_WAIT, timeoutMs);
+
+    std::size_t ran = 0;
+    for (int i = 0; i < ready; ++i) {
+        const int fd = events[i].data.fd;
+        if (fd == wakeFd) {
+            std::uint64_t counter;
+            while (read(wakeFd, &counter, sizeof(counter)) > 0) {}
+            continue;
+        }
+
+        const auto it = registrations.find(fd);
+        if (it == registrations.end()) continue;
+
+        // Errors and hang-ups concern every handler. The matching handlers are copied
+        // first so they stay alive, and are all run, even if one unwatches the descriptor.
+        const std::uint32_t reported = events[i].events;
+        const std::uint32_t wanted = (reported & (EPOLLERR | EPOLLHUP)) != 0 ? ~0u : reported;
+        std::vector<std::shared_ptr<IoHandler>> matching;
+        for (const Registration& registration : it->second) {
+            if (registration.events & wanted) matching.push_back(registration.handler);
+        }
+        for (const std::shared_ptr<IoHandler>& handler : matching) {
+            (*handler)(reported);
+            ran++;
+        }
+    }
+
+    ran += runPosted();
+    return ran;
+}
+
+void EventLoop::run() {
+    // Consuming the request that ends the loop keeps a `stop` issued before `run`,
+    // and leaves one issued after the loop ended for the next `run`.
+    while (!stopRequested.exchange(false)) {
+        runOnce(-1);
+    }
+    loopThread.store(std::thread::id());
+}
+
+void EventLoop::stop() {
+    stopRequested.store(true);
+    wakeUp();
+}
+
+bool EventLoop::isInLoopThread() const {
+    return loopThread.load() == std::this_thread::get_id();
+}
+
+EventLoop::ScheduleAwaiter EventLoop::schedule() {
+    return ScheduleAwaiter(this);
+}
+
+EventLoop::IoAwaiter EventLoop::readable(const int fd) {
+    return {this, fd, EPOLLIN};
+}
+
+EventLoop::IoAwaiter EventLoop::writable(const int fd) {
+    return {this, fd, EPOLLOUT};
+}
+
+std::uint32_t EventLoop::interestOf(const std::vector<Registration>& watched) {
+    std::uint32_t events = 0;
+    for (const Registration& registration : watched) {
+        events |= registration.events;
+    }
+    return events;
+}
+
+void EventLoop::wakeUp() const {
+    constexpr std::uint64_t one = 1;
+    // A full counter already guarantees a pending wake-up, so EAGAIN is harmless.
+    [[maybe_unused]] ssize_t written = write(wakeFd, &one, sizeof(one));
+}
+
+std::size_t EventLoop::runPosted() {
+    std::vector<Callback> batch;
+    {
+        std::lock_guard lock(postedMutex);
+        batch.swap(posted);
+    }
+    for (Callback& callback : batch) {
+        callback();
+    }
+    return batch.size();
+}
@@ -0,0 +1,101 @@
+#include "server/HeartbeatMonitor.hpp"
+#include <iostream>
+#include <stdexcept>
+
+HeartbeatMonitor::HeartbeatMonitor(NetworkManager* networkManager) : HeartbeatMonitor(networkManager, Options{}) {}
+
+HeartbeatMonitor::HeartbeatMonitor(NetworkManager* networkManager, const Options options,
+                                   const TimerWheel::Clock::time_point start)
+    : network(networkManager), options(options), timers(HeartbeatConstants::TIMER_TICK, start) {
+    if (options.interval.count() <= 0 || options.missedLimit == 0) {
+        throw std::invalid_argument("Heartbeat interval and missed limit must be positive");
+    }
+}
+
+void HeartbeatMonitor::registerClient(const int clientID, const TimerWheel::Clock::time_point now) {
+    if (clientID < 0 || !peers.try_emplace(clientID).second) return;
+
+    timers.schedule(static_cast<std::uint64_t>(clientID), now + options.interval);
+}
+
+void HeartbeatMonitor::removeClient(const int clientID) {
+    // The client's pending timer finds no peer when it fires and is dropped.
+    peers.erase(clientID);
+}
+
+std::size_t HeartbeatMonitor::tick(const TimerWheel::Clock::time_point now) {
+    std::size_t sent = 0;
+    for (const std::uint64_t key : timers.advance(now)) {
+        const int clientID = static_cast<int>(key);
+        const auto found = peers.find(clientID);
+        if (found == peers.end()) continue;
+
+        Peer& peer = found->second;
+        if (peer.awaitingPong && ++peer.missed >= options.missedLimit) {
+            std::cout << "Client " << clientID << " missed " << peer.missed << " heartbeats" << std::endl;
+            peers.erase(found);
+            deadClients++;
+            if (network != nullptr) network->closeConnection(clientID);
+            continue;
+        }
+
+        peer.lastSequence++;
+        peer.awaitingPong = true;
+        peer.sentAt = now;
+        cJSON* content = cJSON_CreateObject();
+        cJSON_AddNumberToObject(content, "seq", static_cast<double>(peer.lastSequence));
+        const Message ping(clientID, MessageType::HEARTBEAT, HeartbeatSubType::PING, content);
+        if (network != nullptr) network->sendMessage(ping);
+        sent++;
+
+        timers.schedule(key, now + options.interval);
+    }
+    return sent;
+}
+
+bool HeartbeatMonitor::handlePong(const int clientID, const Message& pong, const TimerWheel::Clock::time_point now) {
+    const auto found = peers.find(clientID);
+    if (found == peers.end() || !found->second.awaitingPong) return false;
+
+    cJSON* content = pong.getContentRO();
+    cJSON* sequence = content != nullptr ? cJSON_GetObjectItem(content, "seq") : nullptr;
+    Peer& peer = found->second;
+    if (sequence == nullptr || !cJSON_IsNumber(sequence) ||
+        static_cast<std::uint64_t>(sequence->valuedouble) != peer.lastSequence) {
+        return false;
+    }
+
+    peer.rtt.record(std::chrono::duration_cast<std::chrono::microseconds>(now - peer.sentAt));
+    peer.awaitingPong = false;
+    peer.missed = 0;
+    return true;
+}
+
+Message HeartbeatMonitor::makePong(const Message& ping) {
+    cJSON* content = ping.getContentRO() != nullptr ? cJSON_Duplicate(ping.getContentRO(), 1) : cJSON_CreateObject();
+    return {ping.getClientID(), MessageType::HEARTBEAT, HeartbeatSubType::PONG, content};
+}
+
+const LatencyHistogram* HeartbeatMonitor::getRttHistogram(const int clientID) const {
+    const auto found = peers.find(clientID);
+    return found != peers.end() ? &found->second.rtt : nullptr;
+}
+
+std::size_t HeartbeatMonitor::getDeadClients() const {
+    return deadClients;
+}
+
+std::string HeartbeatMonitor::exportRttHistograms() const {
+    cJSON* root = cJSON_CreateObject();
+    for (const auto& [clientID, peer] : peers) {
+        cJSON* entry = peer.rtt.toJSON();
+        cJSON_AddNumberToObject(entry, "missed", peer.missed);
+        cJSON_AddItemToObject(root, std::to_string(clientID).c_str(), entry);
+    }
+
+    char* printed = cJSON_PrintUnformatted(root);
+    std::string result = printed != nullptr ? printed : "{}";
+    cJSON_free(printed);
+    cJSON_Delete(root);
+    return result;
+}
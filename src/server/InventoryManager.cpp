@@ -1,5 +1,7 @@
 #include "server/InventoryManager.hpp"
 #include <cstdio>
+#include <cstring>
+#include <unistd.h>
 
 InventoryManager::InventoryManager() {
     globalInventory = cJSON_CreateObject();
@@ -97,7 +99,20 @@ int InventoryManager::getStockLevel(int itemID) const {
 }
 
 void InventoryManager::logTransaction(int itemID, int quantity, const std::string& clientID) {
-    //TODO: implementar usando el EventLogger y agregar tests
+    if (transactions.size() == InventoryConstants::MAX_TRANSACTIONS) {
+        transactions.pop_front();
+    }
+    transactions.push_back({itemID, quantity, clientID, std::chrono::system_clock::now()});
+}
+
+std::vector<InventoryManager::Transaction> InventoryManager::getTransactionHistory(const std::string& clientID) const {
+    std::vector<Transaction> history;
+    for (const Transaction& transaction : transactions) {
+        if (transaction.clientID == clientID) {
+            history.push_back(transaction);
+        }
+    }
+    return history;
 }
 
 void InventoryManager::updateClientInventory(int clientID, cJSON* clientInventory) {
@@ -113,3 +128,31 @@ cJSON* InventoryManager::detectInventoryAnomalies(int clientID) const {
     // TODO: Implementar la detección de anomalías y agregar tests
     return nullptr;
 }
+
+bool InventoryManager::saveSnapshot(const std::string& path) const {
+    cJSON* snapshot = cJSON_CreateObject();
+    cJSON_AddItemToObject(snapshot, "global", globalInventory ? cJSON_Duplicate(globalInventory, true) : cJSON_CreateObject());
+    cJSON* clients = cJSON_AddObjectToObject(snapshot, "clients");
+    for (const auto& [clientID, inventory] : clientInventories) {
+        if (inventory) cJSON_AddItemToObject(clients, std::to_string(clientID).c_str(), cJSON_Duplicate(inventory, true));
+    }
+    char* json = cJSON_PrintUnformatted(snapshot);
+    cJSON_Delete(snapshot);
+    if (!json) return false;
+
+    const std::string temporary = path + ".tmp";
+    FILE* file = std::fopen(temporary.c_str(), "w");
+    bool written = file != nullptr;
+    if (file) {
+        const std::size_t length = std::strlen(json);
+        written = std::fwrite(json, 1, length, file) == length && std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+        written = std::fclose(file) == 0 && written;
+    }
+    cJSON_free(json);
+
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
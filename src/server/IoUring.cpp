@@ -0,0 +1,254 @@
+#include "server/IoUring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    constexpr std::uint64_t PROVIDE_BUFFERS_TAG = ~std::uint64_t{0}; // Reserved user data of buffer returns.
+
+    int ioUringSetup(const unsigned entries, io_uring_params* params) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int ioUringEnter(const int fd, const unsigned toSubmit, const unsigned minComplete, const unsigned flags,
+                     const void* arg, const std::size_t argSize) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+    }
+
+    unsigned* at(void* ring, const std::uint32_t offset) {
+        return reinterpret_cast<unsigned*>(static_cast<char*>(ring) + offset);
+    }
+
+    unsigned loadAcquire(unsigned* value) {
+        return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+    }
+
+    void storeRelease(unsigned* value, const unsigned newValue) {
+        std::atomic_ref<unsigned>(*value).store(newValue, std::memory_order_release);
+    }
+}
+
+bool IoUring::Completion::hasMore() const {
+    return (flags & IORING_CQE_F_MORE) != 0;
+}
+
+std::optional<std::uint16_t> IoUring::Completion::bufferId() const {
+    if ((flags & IORING_CQE_F_BUFFER) == 0) return std::nullopt;
+    return static_cast<std::uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+}
+
+IoUring::IoUring(const unsigned entries) {
+    io_uring_params params{};
+    ringFd = ioUringSetup(entries, &params);
+    if (ringFd < 0) {
+        throw std::runtime_error(std::string("io_uring_setup failed: ") + std::strerror(errno));
+    }
+    features = params.features;
+
+    sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMapping = (features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping) {
+        sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+    }
+
+    sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        sqRing = nullptr;
+        close(ringFd);
+        throw std::runtime_error("Failed to map the io_uring submission ring");
+    }
+    cqRing = singleMapping ? sqRing
+                           : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+    void* entriesMapping = cqRing == MAP_FAILED ? MAP_FAILED
+                           : mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (entriesMapping == MAP_FAILED) {
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingBytes);
+        munmap(sqRing, sqRingBytes);
+        close(ringFd);
+        throw std::runtime_error("Failed to map the io_uring queues");
+    }
+    sqes = static_cast<io_uring_sqe*>(entriesMapping);
+
+    sqHead = at(sqRing, params.sq_off.head);
+    sqTail = at(sqRing, params.sq_off.tail);
+    sqArray = at(sqRing, params.sq_off.array);
+    sqMask = *at(sqRing, params.sq_off.ring_mask);
+    sqEntries = *at(sqRing, params.sq_off.ring_entries);
+    sqLocalTail = sqPublished = *sqTail;
+
+    cqHead = at(cqRing, params.cq_off.head);
+    cqTail = at(cqRing, params.cq_off.tail);
+    cqMask = *at(cqRing, params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cqRing) + params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+    if (buffers != nullptr) munmap(buffers, buffersBytes);
+    munmap(sqes, sqesBytes);
+    if (cqRing != sqRing) munmap(cqRing, cqRingBytes);
+    munmap(sqRing, sqRingBytes);
+    close(ringFd);
+}
+
+void IoUring::provideBuffers(const unsigned count, const std::size_t size, const std::uint16_t group) {
+    if (count == 0 || count > 65536 || size == 0 || buffers != nullptr) {
+        throw std::runtime_error("Invalid provided buffers");
+    }
+
+    buffersBytes = count * size;
+    void* memory = mmap(nullptr, buffersBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::runtime_error("Failed to allocate provided buffers");
+    }
+    buffers = static_cast<char*>(memory);
+    bufferSize = size;
+    bufferGroup = group;
+
+    // The first hand-over is waited for so an unsupported kernel is reported here.
+    prepareProvideBuffers(0, count, false);
+    const int submitted = submitAndWait(1, -1);
+    const unsigned head = *cqHead;
+    const int result = submitted < 0 ? submitted : head != loadAcquire(cqTail) ? cqes[head & cqMask].res : -EIO;
+    if (submitted >= 0) storeRelease(cqHead, head + 1);
+    if (result < 0) {
+        throw std::runtime_error(std::string("Failed to provide buffers: ") + std::strerror(-result));
+    }
+}
+
+std::string_view IoUring::buffer(const std::uint16_t id, const std::size_t length) const {
+    return {buffers + static_cast<std::size_t>(id) * bufferSize, std::min(length, bufferSize)};
+}
+
+void IoUring::recycleBuffer(const std::uint16_t id) {
+    prepareProvideBuffers(id, 1, true);
+}
+
+bool IoUring::prepareMultishotAccept(const int listenFd, const std::uint64_t userData) {
+    io_uring_sqe* sqe = nextSqe();
+    if (sqe == nullptr) return false;
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listenFd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoUring::prepareMultishotRecv(const int fd, const std::uint64_t userData) {
+    io_uring_sqe* sqe = nextSqe();
+    if (sqe == nullptr) return false;
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = bufferGroup;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoUring::prepareSend(const int fd, const void* data, const std::size_t length, const std::uint64_t userData,
+                          const bool linkNext) {
+    io_uring_sqe* sqe = nextSqe();
+    if (sqe == nullptr) return false;
+
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(data);
+    sqe->len = static_cast<std::uint32_t>(length);
+    // MSG_WAITALL makes a short send retry instead of completing, so links never reorder the stream.
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    sqe->flags = linkNext ? IOSQE_IO_LINK : 0;
+    sqe->user_data = userData;
+    return true;
+}
+
+int IoUring::getFd() const {
+    return ringFd;
+}
+
+unsigned IoUring::getFreeEntries() const {
+    return sqEntries - (sqLocalTail - loadAcquire(sqHead));
+}
+
+int IoUring::submitAndWait(const unsigned minComplete, const int timeoutMs) {
+    storeRelease(sqTail, sqLocalTail);
+    const unsigned toSubmit = sqLocalTail - sqPublished;
+    sqPublished = sqLocalTail;
+
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    __kernel_timespec timeout{};
+    io_uring_getevents_arg arg{};
+    const void* argument = nullptr;
+    std::size_t argumentSize = 0;
+    if (minComplete > 0 && timeoutMs >= 0 && (features & IORING_FEAT_EXT_ARG) != 0) {
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+        arg.ts = reinterpret_cast<std::uint64_t>(&timeout);
+        flags |= IORING_ENTER_EXT_ARG;
+        argument = &arg;
+        argumentSize = sizeof(arg);
+    }
+
+    const int result = ioUringEnter(ringFd, toSubmit, minComplete, flags, argument, argumentSize);
+    if (result < 0) {
+        return errno == ETIME || errno == EINTR ? 0 : -errno;
+    }
+    return result;
+}
+
+std::size_t IoUring::drainCompletions(std::vector<Completion>& completions) {
+    unsigned head = *cqHead;
+    const unsigned tail = loadAcquire(cqTail);
+    std::size_t count = 0;
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes[head & cqMask];
+        // A failed buffer return only shrinks the group; receives then report ENOBUFS.
+        if (cqe.user_data == PROVIDE_BUFFERS_TAG) continue;
+        completions.push_back({cqe.user_data, cqe.res, cqe.flags});
+        count++;
+    }
+    storeRelease(cqHead, head);
+    return count;
+}
+
+bool IoUring::prepareProvideBuffers(const std::uint16_t first, const unsigned count, const bool skipSuccess) {
+    io_uring_sqe* sqe = nextSqe();
+    if (sqe == nullptr) return false;
+
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = static_cast<std::int32_t>(count);
+    sqe->addr = reinterpret_cast<std::uint64_t>(buffers + static_cast<std::size_t>(first) * bufferSize);
+    sqe->len = static_cast<std::uint32_t>(bufferSize);
+    sqe->off = first;
+    sqe->buf_group = bufferGroup;
+    sqe->flags = skipSuccess ? IOSQE_CQE_SKIP_SUCCESS : 0;
+    sqe->user_data = PROVIDE_BUFFERS_TAG;
+    return true;
+}
+
+io_uring_sqe* IoUring::nextSqe() {
+    if (sqLocalTail - loadAcquire(sqHead) >= sqEntries) {
+        submitAndWait(0, 0);
+        if (sqLocalTail - loadAcquire(sqHead) >= sqEntries) return nullptr;
+    }
+
+    const unsigned index = sqLocalTail & sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    sqLocalTail++;
+    return sqe;
+}
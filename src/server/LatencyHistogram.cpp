@@ -0,0 +1,70 @@
+#include "server/LatencyHistogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+void LatencyHistogram::record(const std::chrono::microseconds sample) {
+    const auto us = static_cast<std::uint64_t>(std::max<std::int64_t>(sample.count(), 0));
+    const auto bucket = std::min<std::size_t>(std::bit_width(us), LatencyHistogramConstants::BUCKETS - 1);
+    buckets[bucket]++;
+
+    minUs = count == 0 ? us : std::min(minUs, us);
+    maxUs = std::max(maxUs, us);
+    totalUs += us;
+    count++;
+}
+
+std::uint64_t LatencyHistogram::getCount() const {
+    return count;
+}
+
+std::chrono::microseconds LatencyHistogram::getMin() const {
+    return std::chrono::microseconds(minUs);
+}
+
+std::chrono::microseconds LatencyHistogram::getMax() const {
+    return std::chrono::microseconds(maxUs);
+}
+
+std::chrono::microseconds LatencyHistogram::getMean() const {
+    return std::chrono::microseconds(count == 0 ? 0 : totalUs / count);
+}
+
+std::chrono::microseconds LatencyHistogram::getPercentile(const double fraction) const {
+    if (count == 0) return std::chrono::microseconds(0);
+
+    const double clamped = std::clamp(fraction, 0.0, 1.0);
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            const std::uint64_t upper = bucket == 0 ? 0 : (std::uint64_t{1} << bucket) - 1;
+            return std::chrono::microseconds(std::clamp(upper, minUs, maxUs));
+        }
+    }
+    return std::chrono::microseconds(maxUs);
+}
+
+const std::array<std::uint64_t, LatencyHistogramConstants::BUCKETS>& LatencyHistogram::getBuckets() const {
+    return buckets;
+}
+
+cJSON* LatencyHistogram::toJSON() const {
+    cJSON* json = cJSON_CreateObject();
+    cJSON_AddNumberToObject(json, "count", static_cast<double>(count));
+    cJSON_AddNumberToObject(json, "minUs", static_cast<double>(minUs));
+    cJSON_AddNumberToObject(json, "maxUs", static_cast<double>(maxUs));
+    cJSON_AddNumberToObject(json, "meanUs", static_cast<double>(getMean().count()));
+    cJSON_AddNumberToObject(json, "p50Us", static_cast<double>(getPercentile(0.5).count()));
+    cJSON_AddNumberToObject(json, "p90Us", static_cast<double>(getPercentile(0.9).count()));
+    cJSON_AddNumberToObject(json, "p99Us", static_cast<double>(getPercentile(0.99).count()));
+
+    std::size_t used = buckets.size();
+    while (used > 0 && buckets[used - 1] == 0) used--;
+    cJSON* counts = cJSON_AddArrayToObject(json, "buckets");
+    for (std::size_t bucket = 0; bucket < used; ++bucket) {
+        cJSON_AddItemToArray(counts, cJSON_CreateNumber(static_cast<double>(buckets[bucket])));
+    }
+    return json;
+}
@@ -0,0 +1,108 @@
+#include "server/LogDecoder.hpp"
+#include <algorithm>
+#include <cstring>
+
+LogDecoder::LogDecoder(EventLogger::TimestampPrecision precision)
+    : precision(precision), decodedEvents(0), inSession(false) {}
+
+bool LogDecoder::decode(std::istream& in, std::ostream& out) {
+    std::string payload;
+    for (;;) {
+        char header[BinaryLog::RECORD_HEADER_SIZE];
+        in.read(header, sizeof(header));
+        if (in.gcount() == 0) return true;
+        if (in.gcount() != static_cast<std::streamsize>(sizeof(header))) return false;
+
+        std::string_view headerView(header, sizeof(header));
+        BinaryLog::RecordKind kind;
+        std::uint32_t length;
+        BinaryLog::readRaw(headerView, kind);
+        BinaryLog::readRaw(headerView, length);
+        // Reject foreign data before trusting its length field.
+        if (kind < BinaryLog::RecordKind::SESSION || kind > BinaryLog::RecordKind::EVENT ||
+            (!inSession && kind != BinaryLog::RecordKind::SESSION)) {
+            return false;
+        }
+
+        // A corrupt length must not allocate more than the input holds, so the
+        // payload only grows by what was actually read.
+        payload.clear();
+        while (payload.size() < length) {
+            const std::size_t offset = payload.size();
+            const std::size_t chunk = std::min<std::size_t>(length - offset, LogDecoderConstants::READ_CHUNK);
+            payload.resize(offset + chunk);
+            in.read(payload.data() + offset, static_cast<std::streamsize>(chunk));
+            if (in.gcount() != static_cast<std::streamsize>(chunk)) return false;
+        }
+
+        if (!decodeRecord(kind, payload, out)) return false;
+    }
+}
+
+std::size_t LogDecoder::getDecodedEvents() const {
+    return decodedEvents;
+}
+
+bool LogDecoder::decodeRecord(BinaryLog::RecordKind kind, std::string_view payload, std::ostream& out) {
+    if (kind == BinaryLog::RecordKind::SESSION) {
+        std::uint16_t version;
+        if (payload.size() < sizeof(BinaryLog::MAGIC) ||
+            std::memcmp(payload.data(), BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC)) != 0) {
+            return false;
+        }
+        payload.remove_prefix(sizeof(BinaryLog::MAGIC));
+        if (!BinaryLog::readRaw(payload, version) || version != BinaryLog::VERSION) return false;
+
+        components.clear();
+        formats.clear();
+        inSession = true;
+        return true;
+    }
+    if (!inSession) return false;
+
+    switch (kind) {
+        case BinaryLog::RecordKind::COMPONENT:
+        case BinaryLog::RecordKind::FORMAT: {
+            std::uint16_t id;
+            if (!BinaryLog::readRaw(payload, id)) return false;
+            auto& names = kind == BinaryLog::RecordKind::COMPONENT ? components : formats;
+            names[id] = std::string(payload);
+            return true;
+        }
+        case BinaryLog::RecordKind::EVENT:
+            return decodeEvent(payload, out);
+        default:
+            return false;
+    }
+}
+
+bool LogDecoder::decodeEvent(std::string_view payload, std::ostream& out) {
+    std::uint16_t componentId;
+    std::uint8_t level;
+    std::int64_t nanoseconds;
+    std::uint16_t formatId;
+    std::uint8_t argc;
+    if (!BinaryLog::readRaw(payload, componentId) || !BinaryLog::readRaw(payload, level) ||
+        !BinaryLog::readRaw(payload, nanoseconds) || !BinaryLog::readRaw(payload, formatId) ||
+        !BinaryLog::readRaw(payload, argc)) {
+        return false;
+    }
+
+    const auto format = formats.find(formatId);
+    if (format == formats.end()) return false;
+    std::string message;
+    if (!BinaryLog::renderMessage(format->second, payload, argc, message)) return false;
+
+    const auto component = components.find(componentId);
+    const std::string_view componentName = component != components.end() ? std::string_view(component->second) : "UNKNOWN";
+
+    timespec time{};
+    time.tv_sec = static_cast<std::time_t>(nanoseconds / 1000000000);
+    time.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+
+    std::string line;
+    EventLogger::formatTextRecord(line, time, precision, componentName, static_cast<EventLogger::LogLevel>(level), message);
+    out << line;
+    decodedEvents++;
+    return true;
+}
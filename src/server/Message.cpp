@@ -17,6 +17,23 @@ Message& Message::operator=(const Message& other) {
     return *this;
 }
 
+Message::Message(Message&& other) noexcept
+    : clientID(other.clientID), type(other.type), subType(other.subType), content(other.content) {
+    other.content = nullptr;
+}
+
+Message& Message::operator=(Message&& other) noexcept {
+    if (this != &other) {
+        clientID = other.clientID;
+        type = other.type;
+        subType = other.subType;
+        if (content) cJSON_Delete(content);
+        content = other.content;
+        other.content = nullptr;
+    }
+    return *this;
+}
+
 Message::~Message() {
     if (content) cJSON_Delete(content);
 }
@@ -43,6 +60,10 @@ std::string Message::toJSONString() const {
     return result;
 }
 
+SharedPayload Message::toSharedPayload() const {
+    return std::make_shared<const std::string>(toJSONString());
+}
+
 Message Message::fromJSONString(const std::string& jsonString) {
     cJSON* root = cJSON_Parse(jsonString.c_str());
     if (!root) throw std::runtime_error("Invalid JSON string");
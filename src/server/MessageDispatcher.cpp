@@ -1,18 +1,28 @@
 #include "server/MessageDispatcher.hpp"
+#include <algorithm>
+#include <chrono>
 
-MessageDispatcher::MessageDispatcher(std::queue<Message> *queue/*, Server* srv*/) : pendingMessages(queue)/*, server(srv)*/ {}
+MessageDispatcher::MessageDispatcher(MessageQueue *queue/*, Server* srv*/) : pendingMessages(queue)/*, server(srv)*/ {}
 
 void MessageDispatcher::ProcessReceivedMessage(Message* msg) {
     if (msg == nullptr) {
         return;
     }
 
+    if (heartbeatMonitor != nullptr) {
+        heartbeatMonitor->registerClient(msg->getClientID());
+    }
+
     switch (msg->getType()) {
         case MessageType::ALERT:
             processReceivedAlert(msg);
             break;
 
         case MessageType::INVENTORY:
+            if (!isSenderAuthorized(msg)) {
+                delete msg;
+                break;
+            }
             switch (static_cast<InventorySubType>(msg->getSubType())) {
                 case InventorySubType::REQUEST:
                     ProcessReceivedInventoryRequest(msg);
@@ -38,6 +48,10 @@ void MessageDispatcher::ProcessReceivedMessage(Message* msg) {
                     processLogout(msg);
                     break;
                 case CredentialSubType::SUBSCRIPTION:
+                    if (!isSenderAuthorized(msg)) {
+                        delete msg;
+                        break;
+                    }
                     ProcessSubscriptions(msg);
                     break;
                 default:
@@ -46,48 +60,179 @@ void MessageDispatcher::ProcessReceivedMessage(Message* msg) {
             }
             break;
 
+        case MessageType::HEARTBEAT:
+            processHeartbeat(msg);
+            break;
+
         default:
             delete msg;
             break;
     }
 }
 
-void MessageDispatcher::processReceivedAlert(Message* msg) {
-    if (msg->getSubType() >= static_cast<int>(AlertSubType::WEATHER) &&
-        msg->getSubType() <= static_cast<int>(AlertSubType::INFECTION)) {
-        // server->generateAlert(msg);
+std::size_t MessageDispatcher::dispatchPending(const std::size_t maxMessages) {
+    if (pendingMessages == nullptr) {
+        return 0;
+    }
+
+    std::size_t dispatched = 0;
+    while (dispatched < maxMessages) {
+        std::optional<Message> next = pendingMessages->pop();
+        if (!next) {
+            break;
+        }
+        ProcessReceivedMessage(new Message(std::move(*next)));
+        dispatched++;
+    }
+    return dispatched;
+}
+
+void MessageDispatcher::setEventLoop(EventLoop* loop) {
+    eventLoop = loop;
+}
+
+void MessageDispatcher::setAuthentication(Authentication* auth) {
+    authentication = auth;
+}
+
+void MessageDispatcher::setNetworkManager(NetworkManager* manager) {
+    networkManager = manager;
+}
+
+void MessageDispatcher::setHeartbeatMonitor(HeartbeatMonitor* monitor) {
+    heartbeatMonitor = monitor;
+}
+
+void MessageDispatcher::setInventoryManager(InventoryManager* inventory) {
+    inventoryManager = inventory;
+}
+
+void MessageDispatcher::setNotificationSystem(NotificationSystem* notifications) {
+    notificationSystem = notifications;
+}
+
+void MessageDispatcher::registerClient(const int clientID) {
+    if (authentication != nullptr) {
+        authentication->openConnection(clientID);
+    }
+}
+
+void MessageDispatcher::removeClient(const int clientID) {
+    if (authentication != nullptr) {
+        authentication->closeConnection(clientID);
+    }
+}
+
+bool MessageDispatcher::isSenderAuthorized(Message* msg) {
+    if (authentication == nullptr) {
+        return true;
+    }
+
+    cJSON* content = msg->getContentRO();
+    cJSON* tokenField = content != nullptr ? cJSON_GetObjectItem(content, "token") : nullptr;
+    if (tokenField != nullptr && cJSON_IsString(tokenField)) {
+        return authentication->validateSessionToken(msg->getClientID(), tokenField->valuestring);
+    }
+    return authentication->isAuthorized(msg->getClientID());
+}
+
+void MessageDispatcher::sendLoginReply(const int clientID, const std::string& token) {
+    if (networkManager == nullptr) {
+        return;
+    }
+
+    cJSON* content = cJSON_CreateObject();
+    if (token.empty()) {
+        cJSON_AddStringToObject(content, "status", "DENIED");
     } else {
-        delete msg;
+        cJSON_AddStringToObject(content, "status", "OK");
+        cJSON_AddStringToObject(content, "token", token.c_str());
+        cJSON_AddNumberToObject(content, "expiresInMs",
+                                static_cast<double>(authentication->getSessionTokenTtl().count()));
+    }
+    networkManager->sendMessage(Message(clientID, MessageType::CREDENTIALS, CredentialSubType::LOGIN, content));
+}
+
+void MessageDispatcher::processReceivedAlert(Message* msg) {
+    if (notificationSystem != nullptr &&
+        msg->getSubType() >= static_cast<int>(AlertSubType::WEATHER) &&
+        msg->getSubType() <= static_cast<int>(AlertSubType::INFECTION) && isSenderAuthorized(msg)) {
+        cJSON* content = msg->getContentRO();
+        cJSON* messageField = content != nullptr ? cJSON_GetObjectItem(content, "message") : nullptr;
+        const std::string text = messageField != nullptr && cJSON_IsString(messageField) ? messageField->valuestring : "";
+        notificationSystem->broadcastAlert(static_cast<AlertSubType>(msg->getSubType()), text);
     }
+    delete msg;
 }
 
 void MessageDispatcher::processLogin(Message* msg) {
-    cJSON* content = msg->getContent();
+    cJSON* content = msg->getContentRO();
     if (content == nullptr) {
         delete msg;
         return;
     }
 
+    int sender = msg->getClientID();
+    cJSON* tokenField = cJSON_GetObjectItem(content, "token");
     cJSON* passwordField = cJSON_GetObjectItem(content, "password");
+
+    // A reconnecting client resumes its session with the token, skipping the password hash.
+    if (authentication != nullptr && tokenField != nullptr && cJSON_IsString(tokenField)) {
+        std::string token = tokenField->valuestring;
+        delete msg;
+        sendLoginReply(sender, authentication->validateSessionToken(sender, token) ? token : std::string());
+        return;
+    }
+
     if (passwordField == nullptr || !cJSON_IsString(passwordField)) {
         delete msg;
         return;
     }
 
     std::string password = passwordField->valuestring;
-    int sender = msg->getClientID();
     delete msg;
-    // server->login(password, sender);
+    if (authentication == nullptr) {
+        // server->login(password, sender);
+        return;
+    }
+
+    const std::string source = networkManager != nullptr ? networkManager->getClientHost(sender) : std::string();
+    std::string token;
+    if (authentication->authenticate(sender, password, source)) {
+        token = authentication->issueSessionToken(sender);
+    }
+    sendLoginReply(sender, token);
 }
 
 void MessageDispatcher::processLogout(Message* msg) {
     int sender = msg->getClientID();
     delete msg;
+    if (authentication != nullptr) {
+        authentication->setLoggedOut(sender);
+    }
     // server->logout(sender);
 }
 
+void MessageDispatcher::processHeartbeat(Message* msg) {
+    switch (static_cast<HeartbeatSubType>(msg->getSubType())) {
+        case HeartbeatSubType::PING:
+            if (networkManager != nullptr) {
+                networkManager->sendMessage(HeartbeatMonitor::makePong(*msg));
+            }
+            break;
+        case HeartbeatSubType::PONG:
+            if (heartbeatMonitor != nullptr) {
+                heartbeatMonitor->handlePong(msg->getClientID(), *msg);
+            }
+            break;
+        default:
+            break;
+    }
+    delete msg;
+}
+
 void MessageDispatcher::ProcessSubscriptions(Message* msg) {
-    cJSON* content = msg->getContent();
+    cJSON* content = msg->getContentRO();
     if (content == nullptr) {
         delete msg;
         return;
@@ -138,7 +283,7 @@ void MessageDispatcher::ProcessSubscriptions(Message* msg) {
 }
 
 void MessageDispatcher::ProcessReceivedInventoryRequest(Message* msg) {
-    cJSON* content = msg->getContent();
+    cJSON* content = msg->getContentRO();
     if (content == nullptr) {
         delete msg;
         return;
@@ -176,9 +321,40 @@ void MessageDispatcher::ProcessInventoryInfoRequest(Message* msg) {
     delete msg;
 }
 
-void MessageDispatcher::ProcessTransactionHistoryRequest(Message* msg) {
+AsyncTask MessageDispatcher::ProcessTransactionHistoryRequest(Message* msg) {
     int clientId = msg->getClientID();
-    // server->checkTransactionHistory(clientId);
-
     delete msg;
+    if (inventoryManager == nullptr || networkManager == nullptr) {
+        co_return;
+    }
+
+    // The journal is copied before suspending, so later messages cannot change the pages.
+    const std::vector<InventoryManager::Transaction> history =
+        inventoryManager->getTransactionHistory(std::to_string(clientId));
+    std::size_t sent = 0;
+    do {
+        if (eventLoop != nullptr) {
+            co_await eventLoop->schedule();
+        }
+
+        const std::size_t end = std::min(history.size(), sent + DispatcherConstants::HISTORY_PAGE_SIZE);
+        cJSON* content = cJSON_CreateObject();
+        cJSON* transactions = cJSON_AddArrayToObject(content, "transactions");
+        for (std::size_t i = sent; i < end; ++i) {
+            cJSON* transaction = cJSON_CreateObject();
+            cJSON_AddNumberToObject(transaction, "id", history[i].itemID);
+            cJSON_AddNumberToObject(transaction, "quantity", history[i].quantity);
+            cJSON_AddNumberToObject(transaction, "time", static_cast<double>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(history[i].time.time_since_epoch()).count()));
+            cJSON_AddItemToArray(transactions, transaction);
+        }
+        cJSON_AddBoolToObject(content, "more", end < history.size());
+        networkManager->sendMessage(Message(clientId, MessageType::INVENTORY, InventorySubType::HISTORY, content));
+        sent = end;
+
+        // The next page waits until this one is written, so the client's queue stays short.
+        if (sent < history.size() && !co_await networkManager->drained(clientId)) {
+            co_return;
+        }
+    } while (sent < history.size());
 }
@@ -0,0 +1,143 @@
+#include "server/MessageQueue.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+MessageQueue::MessageQueue(const std::size_t capacity, const OverflowPolicy policy)
+    : capacity(capacity), policy(policy), closed(false), stats{} {
+    if (capacity == 0) {
+        throw std::invalid_argument("MessageQueue capacity must be greater than 0");
+    }
+}
+
+MessageQueue::PushResult MessageQueue::push(Message msg) {
+    std::unique_lock lock(mutex);
+    if (closed) return PushResult::CLOSED;
+
+    PushResult result = PushResult::ACCEPTED;
+    if (sizeLocked() >= capacity) {
+        if (policy == OverflowPolicy::BLOCK) {
+            stats.blockedPushes++;
+            notFull.wait(lock, [this] {
+                return closed || sizeLocked() < capacity || policy != OverflowPolicy::BLOCK;
+            });
+            if (closed) return PushResult::CLOSED;
+        }
+
+        if (sizeLocked() >= capacity) {
+            // Only regular messages are shed; a queue full of alerts refuses new work instead.
+            if (policy == OverflowPolicy::DROP_OLDEST && !regularMessages.empty()) {
+                regularMessages.pop_front();
+                stats.shed++;
+                result = PushResult::DROPPED_OLDEST;
+            } else {
+                stats.rejected++;
+                return PushResult::REJECTED;
+            }
+        }
+    }
+
+    if (isCritical(msg)) {
+        criticalMessages.push_back(std::move(msg));
+    } else {
+        regularMessages.push_back(std::move(msg));
+    }
+    stats.accepted++;
+    stats.highWaterMark = std::max(stats.highWaterMark, sizeLocked());
+    lock.unlock();
+
+    notEmpty.notify_one();
+    return result;
+}
+
+std::optional<Message> MessageQueue::pop() {
+    std::unique_lock lock(mutex);
+    if (sizeLocked() == 0) return std::nullopt;
+
+    Message msg = popLocked();
+    lock.unlock();
+
+    notFull.notify_one();
+    return msg;
+}
+
+std::optional<Message> MessageQueue::waitAndPop(const std::chrono::milliseconds timeout) {
+    std::unique_lock lock(mutex);
+    if (!notEmpty.wait_for(lock, timeout, [this] { return closed || sizeLocked() > 0; }) ||
+        sizeLocked() == 0) {
+        return std::nullopt;
+    }
+
+    Message msg = popLocked();
+    lock.unlock();
+
+    notFull.notify_one();
+    return msg;
+}
+
+void MessageQueue::close() {
+    {
+        std::lock_guard lock(mutex);
+        closed = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+}
+
+bool MessageQueue::isClosed() const {
+    std::lock_guard lock(mutex);
+    return closed;
+}
+
+std::size_t MessageQueue::size() const {
+    std::lock_guard lock(mutex);
+    return sizeLocked();
+}
+
+bool MessageQueue::empty() const {
+    return size() == 0;
+}
+
+std::size_t MessageQueue::getCapacity() const {
+    return capacity;
+}
+
+MessageQueue::OverflowPolicy MessageQueue::getPolicy() const {
+    std::lock_guard lock(mutex);
+    return policy;
+}
+
+void MessageQueue::setPolicy(const OverflowPolicy newPolicy) {
+    {
+        std::lock_guard lock(mutex);
+        policy = newPolicy;
+    }
+    notFull.notify_all();
+}
+
+MessageQueue::Stats MessageQueue::getStats() const {
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+bool MessageQueue::isCritical(const Message& msg) {
+    return msg.getType() == MessageType::ALERT;
+}
+
+Message MessageQueue::makeBusyReply(const int clientID) {
+    cJSON* content = cJSON_CreateObject();
+    cJSON_AddStringToObject(content, "reason", "Server busy");
+    cJSON_AddNumberToObject(content, "retryAfterMs", MessageQueueConstants::BUSY_RETRY_AFTER_MS);
+    return {clientID, MessageType::STATUS, StatusSubType::BUSY, content};
+}
+
+std::size_t MessageQueue::sizeLocked() const {
+    return criticalMessages.size() + regularMessages.size();
+}
+
+Message MessageQueue::popLocked() {
+    std::deque<Message>& lane = criticalMessages.empty() ? regularMessages : criticalMessages;
+    Message msg = std::move(lane.front());
+    lane.pop_front();
+    stats.dispatched++;
+    return msg;
+}
@@ -1,105 +1,408 @@
 #include "server/NetworkManager.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <cstring>
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <poll.h>
+#include <sys/epoll.h>
 #include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    // io_uring user data: the operation in the top byte, the client ID or listening socket below.
+    enum class RingOperation : std::uint64_t { ACCEPT = 1, RECEIVE = 2, SEND = 3 };
+    constexpr int RING_OPERATION_SHIFT = 56;
+
+    std::uint64_t ringTag(const RingOperation operation, const int id) {
+        return static_cast<std::uint64_t>(operation) << RING_OPERATION_SHIFT | static_cast<std::uint32_t>(id);
+    }
+}
 
 NetworkManager::NetworkManager() : serverSocketTCPv4(-1), serverSocketUDPv4(-1),
-                                   serverSocketTCPv6(-1), serverSocketUDPv6(-1), nextClientID(1) {}
+                                   serverSocketTCPv6(-1), serverSocketUDPv6(-1) {}
+
+NetworkManager::~NetworkManager() {
+    activeClients.forEach([](const ClientConnection& client) {
+        if (client.getProtocol() == ClientConnection::Protocol::TCP) close(client.getSocket());
+    });
+    closeServerSockets();
+}
+
+void NetworkManager::initialize(int port, const IoBackend backend) {
+    try {
+        setupSocket(serverSocketTCPv4, AF_INET, SOCK_STREAM, port);
+        setupSocket(serverSocketUDPv4, AF_INET, SOCK_DGRAM, port);
+        setupSocket(serverSocketTCPv6, AF_INET6, SOCK_STREAM, port);
+        setupSocket(serverSocketUDPv6, AF_INET6, SOCK_DGRAM, port);
+    } catch (const std::runtime_error&) {
+        closeServerSockets();
+        throw;
+    }
 
-void NetworkManager::initialize(int port) {
-    setupSocket(serverSocketTCPv4, AF_INET, SOCK_STREAM, port);
-    setupSocket(serverSocketUDPv4, AF_INET, SOCK_DGRAM, port);
-    setupSocket(serverSocketTCPv6, AF_INET6, SOCK_STREAM, port);
-    setupSocket(serverSocketUDPv6, AF_INET6, SOCK_DGRAM, port);
+    if (backend == IoBackend::IO_URING) {
+        try {
+            ring = std::make_unique<IoUring>();
+            ring->provideBuffers(IoUringConstants::BUFFER_COUNT, IoUringConstants::BUFFER_SIZE, IoUringConstants::BUFFER_GROUP);
+            ring->prepareMultishotAccept(serverSocketTCPv4, ringTag(RingOperation::ACCEPT, serverSocketTCPv4));
+            ring->prepareMultishotAccept(serverSocketTCPv6, ringTag(RingOperation::ACCEPT, serverSocketTCPv6));
+            ring->submitAndWait(0, 0);
+            ioBackend = IoBackend::IO_URING;
+        } catch (const std::runtime_error& error) {
+            std::cerr << "io_uring unavailable, using epoll: " << error.what() << std::endl;
+            ring.reset();
+        }
+    }
 
     std::cout << "Sockets initialized on port " << port << " (IPv4/IPv6, TCP/UDP)" << std::endl;
 }
 
-void NetworkManager::listenForConnections() {
-    sockaddr_storage clientAddr{};
-    socklen_t addrLen = sizeof(clientAddr);
-    int clientSock = accept(serverSocketTCPv4, reinterpret_cast<sockaddr*>(&clientAddr), &addrLen);
-    if (clientSock >= 0) {
-        int id = nextClientID++;
-        ClientConnection conn(id, clientSock, clientAddr, addrLen, ClientConnection::Protocol::TCP);
-        activeClients.emplace(id, conn);
-        std::cout << "TCP Client connected: " << id << std::endl;
+NetworkManager::IoBackend NetworkManager::getIoBackend() const {
+    return ioBackend;
+}
+
+std::size_t NetworkManager::listenForConnections(const int timeoutMs) {
+    if (ring) {
+        const std::size_t accepted = ringAccepted;
+        processCompletions(timeoutMs);
+        while (timeoutMs < 0 && ringAccepted == accepted) processCompletions(-1);
+        return ringAccepted - accepted;
+    }
+
+    std::array<pollfd, 2> listeners{{{serverSocketTCPv4, POLLIN, 0}, {serverSocketTCPv6, POLLIN, 0}}};
+    if (serverSocketTCPv4 < 0 && serverSocketTCPv6 < 0) return 0;
+    std::size_t accepted = 0;
+    do {
+        const int ready = poll(listeners.data(), listeners.size(), timeoutMs);
+        if (ready < 0 && errno != EINTR) {
+            perror("poll failed");
+            break;
+        }
+        // Both sockets are drained even if only one was reported, so a burst on either is not left queued.
+        for (const pollfd& listener : listeners) {
+            if (listener.fd >= 0) accepted += acceptPending(listener.fd);
+        }
+    } while (accepted == 0 && timeoutMs < 0);
+    return accepted;
+}
+
+std::vector<int> NetworkManager::processCompletions(const int timeoutMs) {
+    std::vector<int> readable;
+    if (!ring) return readable;
+
+    ring->submitAndWait(1, timeoutMs);
+    std::vector<IoUring::Completion> completions;
+    ring->drainCompletions(completions);
+
+    for (const IoUring::Completion& completion : completions) {
+        const auto operation = static_cast<RingOperation>(completion.userData >> RING_OPERATION_SHIFT);
+        const auto id = static_cast<int>(static_cast<std::uint32_t>(completion.userData));
+        switch (operation) {
+            case RingOperation::ACCEPT:
+                if (completion.result >= 0) {
+                    sockaddr_storage clientAddr{};
+                    socklen_t addrLen = sizeof(clientAddr);
+                    getpeername(completion.result, reinterpret_cast<sockaddr*>(&clientAddr), &addrLen);
+                    registerAccepted(completion.result, clientAddr, addrLen);
+                }
+                if (!completion.hasMore() && completion.result != -EBADF && completion.result != -EINVAL) {
+                    ring->prepareMultishotAccept(id, completion.userData);
+                }
+                break;
+
+            case RingOperation::RECEIVE: {
+                ClientConnection* client = activeClients.find(id);
+                if (const std::optional<std::uint16_t> buffer = completion.bufferId()) {
+                    if (client != nullptr && completion.result > 0) {
+                        std::deque<std::string>& inbound = ringInbound[id];
+                        if (inbound.empty()) readable.push_back(id);
+                        inbound.emplace_back(ring->buffer(*buffer, static_cast<std::size_t>(completion.result)));
+                        client->touch(std::chrono::steady_clock::now());
+                    }
+                    ring->recycleBuffer(*buffer);
+                }
+                if (client == nullptr) break;
+
+                if (completion.result == 0 || (completion.result < 0 && completion.result != -ENOBUFS)) {
+                    closeConnection(id); // The peer closed the connection or it failed.
+                } else if (!completion.hasMore()) {
+                    ring->prepareMultishotRecv(client->getSocket(), completion.userData);
+                }
+                break;
+            }
+
+            case RingOperation::SEND:
+                completeRingSend(id, completion.result);
+                break;
+        }
     }
+
+    ring->submitAndWait(0, 0);
+    return readable;
 }
 
 std::vector<Message> NetworkManager::receiveUDPMessage() {
     char buffer[1024];
     std::vector<Message> receivedMessages;
+    std::vector<int> acksDue;
 
     auto handleSocket = [&](int socketFd, ClientConnection::Protocol protocol) {
-        sockaddr_storage senderAddr{};
-        socklen_t addrLen = sizeof(senderAddr);
+        for (std::size_t received = 0; received < NetworkConstants::UDP_BATCH_SIZE; ++received) {
+            sockaddr_storage senderAddr{};
+            socklen_t addrLen = sizeof(senderAddr);
 
-        ssize_t bytes = recvfrom(socketFd, buffer, sizeof(buffer), MSG_DONTWAIT,
-                                 reinterpret_cast<sockaddr*>(&senderAddr), &addrLen);
+            ssize_t bytes = recvfrom(socketFd, buffer, sizeof(buffer), MSG_DONTWAIT,
+                                     reinterpret_cast<sockaddr*>(&senderAddr), &addrLen);
 
-        if (bytes <= 0) return;
+            if (bytes <= 0) return;
 
-        std::string data(buffer, bytes);
-        Message msg = Message::fromJSONString(data);
-        std::cout << "Received UDP message: " << msg.toJSONString() << std::endl;
+            std::string data(buffer, bytes);
+            std::string addressKey(reinterpret_cast<const char*>(&senderAddr), addrLen);
+            const auto known = udpClientsByAddress.find(addressKey);
+            int clientId = known != udpClientsByAddress.end() ? known->second : -1;
+            const auto now = std::chrono::steady_clock::now();
 
-        int clientId = -1;
-        for (const auto& [id, client] : activeClients) {
-            sockaddr_storage clientAddr = client.getAddress();
-            if (client.getProtocol() == protocol &&
-                client.getAddressLength() == addrLen &&
-                memcmp(&clientAddr, &senderAddr, addrLen) == 0) {
-                clientId = id;
-                break;
+            if (const std::optional<ReliableChannel::Ack> ack = ReliableChannel::parseAck(data)) {
+                if (const auto channel = reliablePeers.find(clientId); channel != reliablePeers.end()) {
+                    channel->second.acknowledge(*ack, now);
+                    activeClients.find(clientId)->touch(now);
                 }
-        }
+                continue;
+            }
 
-        if (clientId == -1) {
-            clientId = nextClientID++;
-            ClientConnection newClient(clientId, socketFd, senderAddr, addrLen, protocol);
-            activeClients.emplace(clientId, newClient);
-            std::cout << "Registered new UDP client: " << clientId << std::endl;
-        }
+            // Duplicates of a known peer are acknowledged again and dropped before they are parsed.
+            const std::optional<std::uint64_t> sequence = ReliableChannel::parseSequence(data);
+            if (const auto channel = reliablePeers.find(clientId);
+                sequence && channel != reliablePeers.end() && channel->second.isDuplicate(*sequence)) {
+                acceptSequenced(clientId, *sequence, acksDue);
+                continue;
+            }
 
-        msg.setClientID(clientId);
-        receivedMessages.push_back(msg);
+            std::optional<Message> msg;
+            try {
+                msg = Message::fromJSONString(data);
+            } catch (const std::runtime_error&) {
+                continue;
+            }
+            std::cout << "Received UDP message: " << msg->toJSONString() << std::endl;
 
-        std::string response = "Acknowledged";
-        sendto(socketFd, response.c_str(), response.size(), 0,
-               reinterpret_cast<sockaddr*>(&senderAddr), addrLen);
+            if (clientId >= 0) {
+                activeClients.find(clientId)->touch(now);
+            } else {
+                clientId = activeClients.emplace(socketFd, senderAddr, addrLen, protocol);
+                if (clientId < 0) return;
+                {
+                    std::lock_guard lock(openClientsMutex);
+                    openClients.insert(clientId);
+                }
+                udpClientsByAddress.emplace(std::move(addressKey), clientId);
+                scheduleIdleTimer(*activeClients.find(clientId));
+                std::cout << "Registered new UDP client: " << clientId << std::endl;
+                if (openHandler) openHandler(clientId);
+            }
+            // Only datagrams that parsed are recorded, so a malformed one is not acknowledged.
+            if (sequence && !acceptSequenced(clientId, *sequence, acksDue)) continue;
+
+            msg->setClientID(clientId);
+            receivedMessages.push_back(std::move(*msg));
+
+            if (!sequence) {
+                std::string response = "Acknowledged";
+                sendto(socketFd, response.c_str(), response.size(), 0,
+                       reinterpret_cast<sockaddr*>(&senderAddr), addrLen);
+            }
+        }
     };
 
     handleSocket(serverSocketUDPv4, ClientConnection::Protocol::UDP);
     handleSocket(serverSocketUDPv6, ClientConnection::Protocol::UDP);
 
+    // One ACK per peer covers every datagram it sent in this batch.
+    for (int clientId : acksDue) {
+        const ClientConnection* client = activeClients.find(clientId);
+        const auto channel = reliablePeers.find(clientId);
+        if (client == nullptr || channel == reliablePeers.end()) continue;
+
+        const std::string ack = channel->second.takeAck();
+        sendto(client->getSocket(), ack.data(), ack.size(), MSG_DONTWAIT,
+               reinterpret_cast<const sockaddr*>(&client->getAddress()), client->getAddressLength());
+    }
+
     return receivedMessages;
 }
 
 
 void NetworkManager::sendMessage(const Message& msg) {
     int clientID = msg.getClientID();
-    auto it = activeClients.find(clientID);
-    if (it == activeClients.end()) return;
+    if (!isOpen(clientID)) return;
+
+    sendPayload(clientID, msg.toSharedPayload());
+}
 
-    const ClientConnection& client = it->second;
-    std::string raw = msg.toJSONString();
+bool NetworkManager::sendPayload(int clientID, const SharedPayload& payload) {
+    if (!payload) return false;
 
-    if (client.getProtocol() == ClientConnection::Protocol::TCP) {
-        send(client.getSocket(), raw.c_str(), raw.size(), 0);
-    } else {
-        sockaddr_storage clientAddr = client.getAddress();
-        sendto(client.getSocket(), raw.c_str(), raw.size(), 0,
-               reinterpret_cast<sockaddr*>(&clientAddr), client.getAddressLength());
+    if (eventLoop != nullptr && !eventLoop->isInLoopThread()) {
+        // The table belongs to the loop thread; the open set answers for it here.
+        if (!isOpen(clientID)) return false;
+        eventLoop->post([this, clientID, payload] { sendPayload(clientID, payload); });
+        return true;
+    }
+
+    ClientConnection* client = activeClients.find(clientID);
+    if (client == nullptr) return false;
+
+    const bool queued = enqueueOutbound(clientID, *client, payload);
+    if (queued) {
+        flushClient(clientID);
+    }
+    closeDisconnected({clientID});
+    return queued;
+}
+
+std::size_t NetworkManager::broadcastPayload(const std::vector<int>& clientIDs, const SharedPayload& payload) {
+    if (eventLoop != nullptr) {
+        eventLoop->post([this, clientIDs, payload] {
+            queuePayload(clientIDs, payload);
+            scheduleFlush();
+        });
+        return clientIDs.size();
+    }
+
+    const std::size_t queued = queuePayload(clientIDs, payload);
+    flushOutbound();
+    return queued;
+}
+
+std::size_t NetworkManager::queuePayload(const std::vector<int>& clientIDs, const SharedPayload& payload) {
+    if (!payload) return 0;
+
+    std::size_t queued = 0;
+    for (int clientID : clientIDs) {
+        ClientConnection* client = activeClients.find(clientID);
+        if (client == nullptr) continue;
+
+        if (enqueueOutbound(clientID, *client, payload)) queued++;
+    }
+    closeDisconnected(clientIDs);
+    return queued;
+}
+
+std::size_t NetworkManager::flushOutbound() {
+    std::vector<int> dirty;
+    dirty.swap(pendingFlush);
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+    std::size_t written = 0;
+    std::unordered_map<int, std::vector<ClientConnection*>> datagramsBySocket;
+    for (int clientID : dirty) {
+        ClientConnection* found = activeClients.find(clientID);
+        if (found == nullptr || !found->hasPendingOutput()) continue;
+
+        ClientConnection& client = *found;
+        if (client.getProtocol() == ClientConnection::Protocol::TCP && ring) {
+            flushStreamRing(client);
+        } else if (client.getProtocol() == ClientConnection::Protocol::TCP) {
+            written += flushStream(client);
+            if (client.hasPendingOutput()) watchWritable(client.getSocket());
+        } else {
+            datagramsBySocket[client.getSocket()].push_back(&client);
+        }
+    }
+
+    for (const auto& [socketFd, clients] : datagramsBySocket) {
+        written += flushDatagrams(socketFd, clients);
+        for (const ClientConnection* client : clients) {
+            if (client->hasPendingOutput()) {
+                watchWritable(socketFd);
+                break;
+            }
+        }
+    }
+
+    for (int clientID : dirty) {
+        const ClientConnection* client = activeClients.find(clientID);
+        if (client != nullptr && client->hasPendingOutput()) {
+            pendingFlush.push_back(clientID);
+        }
+    }
+    closeDisconnected(dirty);
+    for (int clientID : dirty) {
+        resumeDrained(clientID);
+    }
+    return written;
+}
+
+void NetworkManager::setEventLoop(EventLoop* loop) {
+    eventLoop = loop;
+}
+
+void NetworkManager::setSlowClientPolicy(const SlowClientPolicy policy) {
+    slowClientPolicy = policy;
+}
+
+bool NetworkManager::setHighWaterMark(int clientID, std::size_t bytes) {
+    ClientConnection* client = activeClients.find(clientID);
+    if (client == nullptr) return false;
+
+    client->setHighWaterMark(bytes);
+    return true;
+}
+
+bool NetworkManager::hasPendingOutput(int clientID) const {
+    const ClientConnection* client = activeClients.find(clientID);
+    return client != nullptr && client->hasPendingOutput();
+}
+
+bool NetworkManager::DrainAwaiter::await_ready() const {
+    return manager->eventLoop == nullptr || !manager->hasPendingOutput(clientID);
+}
+
+void NetworkManager::DrainAwaiter::await_suspend(std::coroutine_handle<> handle) const {
+    manager->drainWaiters[clientID].push_back(handle);
+}
+
+bool NetworkManager::DrainAwaiter::await_resume() const {
+    return manager->isOpen(clientID);
+}
+
+NetworkManager::DrainAwaiter NetworkManager::drained(int clientID) {
+    return {this, clientID};
+}
+
+void NetworkManager::resumeDrained(int clientID) {
+    const auto waiting = drainWaiters.find(clientID);
+    if (waiting == drainWaiters.end() || hasPendingOutput(clientID)) return;
+
+    for (const std::coroutine_handle<> handle : waiting->second) {
+        eventLoop->post([handle] { handle.resume(); });
     }
+    drainWaiters.erase(waiting);
+}
+
+NetworkManager::OutboundStats NetworkManager::getOutboundStats() const {
+    return outboundStats;
 }
 
 std::optional<Message> NetworkManager::receiveTCPMessage(int clientID) {
-    auto it = activeClients.find(clientID);
-    if (it == activeClients.end()) return std::nullopt;
+    ClientConnection* found = activeClients.find(clientID);
+    if (found == nullptr) return std::nullopt;
+
+    ClientConnection& client = *found;
+    if (ring && client.getProtocol() == ClientConnection::Protocol::TCP) {
+        while (ringInbound[clientID].empty()) {
+            processCompletions(-1);
+            if (!activeClients.contains(clientID)) return std::nullopt;
+        }
+        std::deque<std::string>& inbound = ringInbound[clientID];
+        const std::string data = std::move(inbound.front());
+        inbound.pop_front();
+        return Message::fromJSONString(data);
+    }
 
-    ClientConnection& client = it->second;
     char buffer[1024] = {0};
 
     ssize_t bytes;
@@ -113,25 +416,518 @@ std::optional<Message> NetworkManager::receiveTCPMessage(int clientID) {
     }
 
     if (bytes > 0) {
+        client.touch(std::chrono::steady_clock::now());
         return Message::fromJSONString(std::string(buffer, bytes));
     }
     return std::nullopt;
 }
 
 void NetworkManager::closeConnection(int clientID) {
-    auto it = activeClients.find(clientID);
-    if (it != activeClients.end()) {
-        close(it->second.getSocket());
-        activeClients.erase(it);
+    if (const ClientConnection* client = activeClients.find(clientID); client != nullptr) {
+        // UDP clients share the server socket, which must stay open.
+        if (client->getProtocol() == ClientConnection::Protocol::TCP) {
+            unwatchWritable(client->getSocket());
+            if (receiveHandler && !ring) eventLoop->unwatch(client->getSocket());
+            // Ring operations hold the socket open; shutting it down completes them.
+            if (ring) shutdown(client->getSocket(), SHUT_RDWR);
+            close(client->getSocket());
+            ringInbound.erase(clientID);
+        } else {
+            udpClientsByAddress.erase(std::string(reinterpret_cast<const char*>(&client->getAddress()),
+                                                  client->getAddressLength()));
+            reliablePeers.erase(clientID);
+        }
+        activeClients.erase(clientID);
+        {
+            std::lock_guard lock(openClientsMutex);
+            openClients.erase(clientID);
+        }
         std::cout << "Connection closed: " << clientID << std::endl;
+        if (closeHandler) closeHandler(clientID);
+        resumeDrained(clientID);
+    }
+}
+
+bool NetworkManager::startReceiving(std::function<void(Message)> handler) {
+    if (eventLoop == nullptr) return false;
+
+    receiveHandler = std::move(handler);
+    if (ring) {
+        eventLoop->watch(ring->getFd(), EPOLLIN, [this](std::uint32_t) {
+            for (const int clientID : processCompletions(0)) {
+                std::deque<std::string>& inbound = ringInbound[clientID];
+                while (!inbound.empty() && activeClients.contains(clientID)) {
+                    const std::string data = std::move(inbound.front());
+                    inbound.pop_front();
+                    deliver(clientID, data);
+                }
+            }
+        });
+        return true;
+    }
+
+    for (const int socketFd : {serverSocketTCPv4, serverSocketTCPv6}) {
+        if (socketFd >= 0) eventLoop->watch(socketFd, EPOLLIN, [this, socketFd](std::uint32_t) { acceptPending(socketFd); });
+    }
+    for (const int socketFd : {serverSocketUDPv4, serverSocketUDPv6}) {
+        if (socketFd < 0) continue;
+        eventLoop->watch(socketFd, EPOLLIN, [this](std::uint32_t) {
+            for (Message& msg : receiveUDPMessage()) receiveHandler(std::move(msg));
+        });
+    }
+    activeClients.forEach([this](const ClientConnection& client) { watchReadable(client); });
+    return true;
+}
+
+void NetworkManager::setCloseHandler(std::function<void(int)> handler) {
+    closeHandler = std::move(handler);
+}
+
+void NetworkManager::setOpenHandler(std::function<void(int)> handler) {
+    openHandler = std::move(handler);
+}
+
+void NetworkManager::setListenBacklog(const int backlog) {
+    if (backlog <= 0) {
+        throw std::invalid_argument("Listen backlog must be positive");
+    }
+    listenBacklog = backlog;
+    // Calling listen again on a listening socket only resizes its queue.
+    for (const int socketFd : {serverSocketTCPv4, serverSocketTCPv6}) {
+        if (socketFd >= 0) listen(socketFd, listenBacklog);
+    }
+}
+
+void NetworkManager::stopAccepting() {
+    for (int* socketFd : {&serverSocketTCPv4, &serverSocketTCPv6}) {
+        if (*socketFd < 0) continue;
+        if (receiveHandler) eventLoop->unwatch(*socketFd);
+        // Shutting the listener down also ends the ring's multishot accept on it.
+        shutdown(*socketFd, SHUT_RDWR);
+        close(*socketFd);
+        *socketFd = -1;
+    }
+}
+
+bool NetworkManager::drainOutbound(const std::chrono::steady_clock::time_point deadline) {
+    for (;;) {
+        flushOutbound();
+
+        std::vector<pollfd> waiting;
+        activeClients.forEach([&waiting](const ClientConnection& client) {
+            if (client.hasPendingOutput()) waiting.push_back({client.getSocket(), POLLOUT, 0});
+        });
+        if (waiting.empty()) return true;
+
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) return false;
+        const int timeoutMs = static_cast<int>(std::min<std::chrono::milliseconds::rep>(remaining.count(), 100));
+        if (ring) {
+            processCompletions(timeoutMs);
+        } else if (poll(waiting.data(), waiting.size(), timeoutMs) < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+void NetworkManager::closeAll() {
+    std::vector<int> clientIDs;
+    activeClients.forEach([&clientIDs](const ClientConnection& client) { clientIDs.push_back(client.getClientID()); });
+    for (const int clientID : clientIDs) {
+        closeConnection(clientID);
+    }
+    unwatchServerSockets();
+    closeServerSockets();
+}
+
+void NetworkManager::setIdleTimeout(const std::chrono::milliseconds timeout) {
+    idleTimeout = timeout;
+    idleTimers = TimerWheel(NetworkConstants::IDLE_TIMER_TICK);
+    activeClients.forEach([this](const ClientConnection& client) { scheduleIdleTimer(client); });
+}
+
+std::size_t NetworkManager::reapIdleConnections(const std::chrono::steady_clock::time_point now) {
+    std::size_t closed = 0;
+    for (const std::uint64_t key : idleTimers.advance(now)) {
+        const int clientID = static_cast<int>(key);
+        const ClientConnection* client = activeClients.find(clientID);
+        if (client == nullptr) continue; // Closed for another reason since the timer was set.
+
+        const auto deadline = client->getLastActivity() + idleTimeout;
+        if (deadline > now) {
+            idleTimers.schedule(key, deadline);
+            continue;
+        }
+
+        std::cout << "Closing idle client: " << clientID << std::endl;
+        closeConnection(clientID);
+        closed++;
+    }
+    return closed;
+}
+
+std::size_t NetworkManager::retransmitReliable(const std::chrono::steady_clock::time_point now) {
+    std::size_t resent = 0;
+    std::vector<int> exhausted;
+    for (auto& [clientID, channel] : reliablePeers) {
+        ClientConnection* client = activeClients.find(clientID);
+        if (client == nullptr) continue;
+
+        for (SharedPayload& payload : channel.collectRetransmissions(now)) {
+            if (!client->hasPendingOutput()) pendingFlush.push_back(clientID);
+            client->queueOutbound(std::move(payload));
+            resent++;
+        }
+        if (channel.isExhausted()) exhausted.push_back(clientID);
+    }
+
+    for (int clientID : exhausted) {
+        std::cout << "Reliable UDP client stopped acknowledging: " << clientID << std::endl;
+        closeConnection(clientID);
+    }
+    if (resent > 0) flushOutbound();
+    return resent;
+}
+
+std::size_t NetworkManager::getUnacknowledged(int clientID) const {
+    const auto channel = reliablePeers.find(clientID);
+    return channel != reliablePeers.end() ? channel->second.getUnacknowledged() : 0;
+}
+
+std::size_t NetworkManager::getConnectionCount() const {
+    return activeClients.size();
+}
+
+std::string NetworkManager::getClientHost(int clientID) const {
+    const ClientConnection* client = activeClients.find(clientID);
+    if (client == nullptr) return {};
+
+    const sockaddr_storage& address = client->getAddress();
+    char host[INET6_ADDRSTRLEN] = {};
+    if (address.ss_family == AF_INET) {
+        inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in*>(&address)->sin_addr, host, sizeof(host));
+    } else if (address.ss_family == AF_INET6) {
+        inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6*>(&address)->sin6_addr, host, sizeof(host));
+    }
+    return host;
+}
+
+bool NetworkManager::enqueueOutbound(int clientID, ClientConnection& client, const SharedPayload& payload) {
+    if (!client.isConnected()) return false;
+
+    if (client.wouldExceedHighWaterMark(payload->size())) {
+        if (slowClientPolicy == SlowClientPolicy::DISCONNECT) {
+            client.disconnect();
+            outboundStats.slowClientDisconnects++;
+        } else {
+            outboundStats.rejectedMessages++;
+        }
+        return false;
+    }
+
+    // A client with pending output is already in the flush list.
+    if (!client.hasPendingOutput()) pendingFlush.push_back(clientID);
+    if (const auto channel = reliablePeers.find(clientID); channel != reliablePeers.end()) {
+        client.queueOutbound(channel->second.send(payload, std::chrono::steady_clock::now()));
+    } else {
+        client.queueOutbound(payload);
+    }
+    return true;
+}
+
+bool NetworkManager::acceptSequenced(int clientID, std::uint64_t sequence, std::vector<int>& acksDue) {
+    ReliableChannel& channel = reliablePeers[clientID];
+    const bool alreadyDue = channel.hasPendingAck();
+    const ReliableChannel::Delivery delivery = channel.receive(sequence);
+    if (!alreadyDue && channel.hasPendingAck()) acksDue.push_back(clientID);
+    return delivery == ReliableChannel::Delivery::DELIVER;
+}
+
+void NetworkManager::flushClient(int clientID) {
+    ClientConnection* found = activeClients.find(clientID);
+    if (found == nullptr) return;
+
+    ClientConnection& client = *found;
+    if (client.getProtocol() == ClientConnection::Protocol::TCP && ring) {
+        flushStreamRing(client);
+        return;
+    }
+    if (client.getProtocol() == ClientConnection::Protocol::TCP) {
+        flushStream(client);
+    } else {
+        flushDatagrams(client.getSocket(), {&client});
+    }
+
+    if (client.hasPendingOutput()) {
+        watchWritable(client.getSocket());
+    }
+    resumeDrained(clientID);
+}
+
+void NetworkManager::watchWritable(int fd) {
+    if (eventLoop == nullptr || writeWatchedFds.contains(fd)) return;
+
+    const bool watched = eventLoop->watch(fd, EPOLLOUT, [this, fd](std::uint32_t) {
+        unwatchWritable(fd);
+        flushOutbound();
+    });
+    if (watched) writeWatchedFds.insert(fd);
+}
+
+void NetworkManager::unwatchWritable(int fd) {
+    if (writeWatchedFds.erase(fd) > 0) {
+        eventLoop->unwatch(fd, EPOLLOUT);
+    }
+}
+
+bool NetworkManager::isOpen(const int clientID) const {
+    std::lock_guard lock(openClientsMutex);
+    return openClients.contains(clientID);
+}
+
+void NetworkManager::unwatchServerSockets() {
+    if (!receiveHandler) return;
+
+    if (ring) eventLoop->unwatch(ring->getFd());
+    for (const int socketFd : {serverSocketTCPv4, serverSocketUDPv4, serverSocketTCPv6, serverSocketUDPv6}) {
+        if (socketFd >= 0) eventLoop->unwatch(socketFd);
+    }
+}
+
+void NetworkManager::watchReadable(const ClientConnection& client) {
+    if (!receiveHandler || ring || client.getProtocol() != ClientConnection::Protocol::TCP) return;
+
+    const int clientID = client.getClientID();
+    eventLoop->watch(client.getSocket(), EPOLLIN, [this, clientID](std::uint32_t) { readStream(clientID); });
+}
+
+void NetworkManager::readStream(const int clientID) {
+    ClientConnection* client = activeClients.find(clientID);
+    if (client == nullptr) return;
+
+    char buffer[1024];
+    const ssize_t bytes = recv(client->getSocket(), buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+    if (bytes <= 0) {
+        closeConnection(clientID); // The peer closed the connection or it failed.
+        return;
+    }
+    client->touch(std::chrono::steady_clock::now());
+    deliver(clientID, std::string(buffer, static_cast<std::size_t>(bytes)));
+}
+
+void NetworkManager::deliver(const int clientID, const std::string& data) {
+    std::optional<Message> msg;
+    try {
+        msg = Message::fromJSONString(data);
+    } catch (const std::runtime_error&) {
+        return;
+    }
+    msg->setClientID(clientID);
+    receiveHandler(std::move(*msg));
+}
+
+void NetworkManager::closeDisconnected(const std::vector<int>& clientIDs) {
+    for (int clientID : clientIDs) {
+        const ClientConnection* client = activeClients.find(clientID);
+        if (client != nullptr && !client->isConnected()) {
+            closeConnection(clientID);
+        }
+    }
+}
+
+std::size_t NetworkManager::acceptPending(const int listenFd) {
+    std::size_t accepted = 0;
+    while (true) {
+        sockaddr_storage clientAddr{};
+        socklen_t addrLen = sizeof(clientAddr);
+        const int clientSock = accept4(listenFd, reinterpret_cast<sockaddr*>(&clientAddr), &addrLen,
+                                       SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientSock < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept failed");
+            return accepted;
+        }
+        if (registerAccepted(clientSock, clientAddr, addrLen) >= 0) accepted++;
+    }
+}
+
+int NetworkManager::registerAccepted(const int clientSock, const sockaddr_storage& clientAddr, const socklen_t addrLen) {
+    const int id = activeClients.emplace(clientSock, clientAddr, addrLen, ClientConnection::Protocol::TCP);
+    if (id < 0) {
+        close(clientSock);
+        return -1;
+    }
+    {
+        std::lock_guard lock(openClientsMutex);
+        openClients.insert(id);
+    }
+    scheduleIdleTimer(*activeClients.find(id));
+    watchReadable(*activeClients.find(id));
+    if (ring) {
+        ringAccepted++;
+        ring->prepareMultishotRecv(clientSock, ringTag(RingOperation::RECEIVE, id));
+    }
+    std::cout << "TCP Client connected: " << id << std::endl;
+    if (openHandler) openHandler(id);
+    return id;
+}
+
+void NetworkManager::completeRingSend(int clientID, int result) {
+    const auto chain = ringSends.find(clientID);
+    if (chain == ringSends.end()) return;
+
+    ClientConnection* client = activeClients.find(clientID);
+    if (client != nullptr) {
+        if (result > 0) {
+            client->consumeOutboundBytes(static_cast<std::size_t>(result));
+        } else if (result < 0 && result != -ECANCELED) {
+            client->consumeOutboundMessages(client->getPendingOutputCount());
+            client->disconnect();
+        }
+    }
+
+    // The buffers stay referenced until the last send of the chain completes.
+    if (--chain->second.remaining > 0) return;
+    ringSends.erase(chain);
+    if (client == nullptr) return;
+
+    if (!client->isConnected()) {
+        closeConnection(clientID);
+    } else if (client->hasPendingOutput()) {
+        flushStreamRing(*client);
+    }
+    resumeDrained(clientID);
+}
+
+void NetworkManager::flushStreamRing(ClientConnection& client) {
+    const int clientID = client.getClientID();
+    if (ringSends.contains(clientID) || !client.hasPendingOutput()) return;
+
+    std::array<iovec, NetworkConstants::MAX_IOV_PER_WRITE> iov{};
+    const std::size_t count = client.fillOutboundIov(iov.data(), std::min<std::size_t>(iov.size(), ring->getFreeEntries()));
+    if (count == 0) return;
+
+    RingSendChain& chain = ringSends[clientID];
+    chain.remaining = count;
+    for (std::size_t i = 0; i < count; ++i) {
+        chain.payloads.push_back(client.getOutboundAt(i));
+        ring->prepareSend(client.getSocket(), iov[i].iov_base, iov[i].iov_len,
+                          ringTag(RingOperation::SEND, clientID), i + 1 < count);
+    }
+    ring->submitAndWait(0, 0);
+}
+
+std::size_t NetworkManager::flushStream(ClientConnection& client) {
+    const std::size_t before = client.getPendingOutputCount();
+    std::array<iovec, NetworkConstants::MAX_IOV_PER_WRITE> iov{};
+
+    while (client.hasPendingOutput()) {
+        msghdr msg{};
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = client.fillOutboundIov(iov.data(), iov.size());
+
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < msg.msg_iovlen; ++i) total += iov[i].iov_len;
+
+        // Vectored write like writev, but MSG_NOSIGNAL keeps a vanished peer from raising SIGPIPE.
+        const ssize_t sent = sendmsg(client.getSocket(), &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                client.consumeOutboundMessages(client.getPendingOutputCount());
+                client.disconnect();
+            }
+            break;
+        }
+
+        client.consumeOutboundBytes(static_cast<std::size_t>(sent));
+        if (static_cast<std::size_t>(sent) < total) break;
     }
+    return before - client.getPendingOutputCount();
+}
+
+std::size_t NetworkManager::flushDatagrams(int socketFd, const std::vector<ClientConnection*>& clients) {
+    constexpr std::size_t batchSize = NetworkConstants::UDP_BATCH_SIZE;
+    std::array<mmsghdr, batchSize> messages{};
+    std::array<iovec, batchSize> iov{};
+    std::array<sockaddr_storage, batchSize> addresses{};
+    std::array<ClientConnection*, batchSize> owners{};
+
+    std::size_t sentTotal = 0;
+    std::size_t nextClient = 0;
+    while (nextClient < clients.size()) {
+        const std::size_t batchStart = nextClient;
+        std::size_t count = 0;
+        while (nextClient < clients.size() && count < batchSize) {
+            ClientConnection& client = *clients[nextClient];
+            const std::size_t filled = client.fillOutboundIov(&iov[count], batchSize - count);
+            const sockaddr_storage& address = client.getAddress();
+            for (std::size_t i = count; i < count + filled; ++i) {
+                addresses[i] = address;
+                messages[i] = {};
+                messages[i].msg_hdr.msg_name = &addresses[i];
+                messages[i].msg_hdr.msg_namelen = client.getAddressLength();
+                messages[i].msg_hdr.msg_iov = &iov[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+                owners[i] = &client;
+            }
+            count += filled;
+            // A client that did not fit entirely is continued in the next batch.
+            if (filled < client.getPendingOutputCount()) break;
+            nextClient++;
+        }
+
+        const int sent = sendmmsg(socketFd, messages.data(), static_cast<unsigned int>(count), MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            // The first datagram of the batch was refused; drop it so the rest can go out.
+            owners[0]->consumeOutboundMessages(1);
+            nextClient = batchStart;
+            continue;
+        }
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(sent);) {
+            std::size_t j = i;
+            while (j < static_cast<std::size_t>(sent) && owners[j] == owners[i]) j++;
+            owners[i]->consumeOutboundMessages(j - i);
+            i = j;
+        }
+        sentTotal += static_cast<std::size_t>(sent);
+        if (static_cast<std::size_t>(sent) < count) break;
+    }
+    return sentTotal;
+}
+
+void NetworkManager::scheduleFlush() {
+    if (flushScheduled) return;
+
+    flushScheduled = true;
+    eventLoop->post([this] {
+        flushScheduled = false;
+        flushOutbound();
+    });
+}
+
+void NetworkManager::scheduleIdleTimer(const ClientConnection& client) {
+    if (idleTimeout.count() <= 0) return;
+
+    idleTimers.schedule(static_cast<std::uint64_t>(client.getClientID()), client.getLastActivity() + idleTimeout);
 }
 
 void NetworkManager::setupSocket(int& socketFd, int family, int type, int port) {
-    socketFd = socket(family, type, 0);
+    const auto fail = [&socketFd](const std::string& step) {
+        const int error = errno;
+        if (socketFd >= 0) close(socketFd);
+        socketFd = -1;
+        throw std::runtime_error(step + " failed: " + std::strerror(error));
+    };
+
+    // Listeners are non-blocking so acceptPending can drain them until EAGAIN.
+    socketFd = socket(family, type == SOCK_STREAM ? type | SOCK_NONBLOCK : type, 0);
     if (socketFd < 0) {
-        perror("Socket creation failed");
-        exit(EXIT_FAILURE);
+        fail("Socket creation");
     }
 
     int opt = 1;
@@ -149,8 +945,7 @@ void NetworkManager::setupSocket(int& socketFd, int family, int type, int port)
         addr.sin_port = htons(port);
 
         if (bind(socketFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
-            perror("Bind failed (IPv4)");
-            exit(EXIT_FAILURE);
+            fail("Bind (IPv4)");
         }
     } else {
         sockaddr_in6 addr6{};
@@ -159,15 +954,20 @@ void NetworkManager::setupSocket(int& socketFd, int family, int type, int port)
         addr6.sin6_port = htons(port);
 
         if (bind(socketFd, reinterpret_cast<sockaddr*>(&addr6), sizeof(addr6)) < 0) {
-            perror("Bind failed (IPv6)");
-            exit(EXIT_FAILURE);
+            fail("Bind (IPv6)");
         }
     }
 
     if (type == SOCK_STREAM) {
-        if (listen(socketFd, 10) < 0) {
-            perror("Listen failed");
-            exit(EXIT_FAILURE);
+        if (listen(socketFd, listenBacklog) < 0) {
+            fail("Listen");
         }
     }
 }
+
+void NetworkManager::closeServerSockets() {
+    for (int* socketFd : {&serverSocketTCPv4, &serverSocketUDPv4, &serverSocketTCPv6, &serverSocketUDPv6}) {
+        if (*socketFd >= 0) close(*socketFd);
+        *socketFd = -1;
+    }
+}
@@ -1,7 +1,6 @@
 #include "server/NotificationSystem.hpp"
-#include <ranges>
 
-const std::set DEFAULT_NOTIFICATIONS = {
+const std::array DEFAULT_NOTIFICATIONS = {
     NotificationSubType::ON_ROUTE,
     NotificationSubType::RECEIVED,
     NotificationSubType::NO_STOCK
@@ -12,34 +11,82 @@ NotificationSystem::NotificationSystem(NetworkManager* networkManager) {
 }
 
 void NotificationSystem::registerClient(int clientID) {
-    subscriptions[clientID] = DEFAULT_NOTIFICATIONS;
+    ClientSubscriptions& state = ensureRegistered(clientID);
+    for (std::size_t i = 0; i < NotificationConstants::NOTIFICATION_TYPE_COUNT; ++i) {
+        const auto type = static_cast<NotificationSubType>(i);
+        if (state.mask & maskOf(type)) {
+            removeFromIndex(state, type);
+        }
+    }
+    for (NotificationSubType type : DEFAULT_NOTIFICATIONS) {
+        addToIndex(clientID, state, type);
+    }
 }
 
 void NotificationSystem::removeClient(int clientID) {
-    subscriptions.erase(clientID);
+    const auto it = subscriptions.find(clientID);
+    if (it == subscriptions.end()) return;
+
+    ClientSubscriptions& state = it->second;
+    for (std::size_t i = 0; i < NotificationConstants::NOTIFICATION_TYPE_COUNT; ++i) {
+        const auto type = static_cast<NotificationSubType>(i);
+        if (state.mask & maskOf(type)) {
+            removeFromIndex(state, type);
+        }
+    }
+
+    const std::size_t slot = state.clientSlot;
+    const int moved = clients.back();
+    clients[slot] = moved;
+    clients.pop_back();
+    if (moved != clientID) {
+        subscriptions[moved].clientSlot = slot;
+    }
+    subscriptions.erase(it);
 }
 
 bool NotificationSystem::isSubscribed(int clientID, NotificationSubType type) const {
-    auto it = subscriptions.find(clientID);
-    return it != subscriptions.end() && it->second.contains(type);
+    const auto it = subscriptions.find(clientID);
+    return it != subscriptions.end() && (it->second.mask & maskOf(type)) != 0;
 }
 
 void NotificationSystem::broadcastAlert(AlertSubType subType, const std::string& message) {
     cJSON* content = cJSON_CreateObject();
     cJSON_AddStringToObject(content, "message", message.c_str());
-    for (int clientID : subscriptions | std::views::keys) {
-        Message msg(clientID, MessageType::ALERT, subType, content);
-        networkManager->sendMessage(msg);
-    }
+    // Encoded once without a client ID; every hub receives the same bytes.
+    const Message alert(MessageType::ALERT, subType, content);
+    networkManager->broadcastPayload(clients, alert.toSharedPayload());
+}
+
+std::size_t NotificationSystem::notifySubscribers(NotificationSubType type, const std::string& message) {
+    const std::vector<int>& subscribers = getSubscribers(type);
+    if (subscribers.empty()) return 0;
+
+    cJSON* content = cJSON_CreateObject();
+    cJSON_AddStringToObject(content, "message", message.c_str());
+    const Message notification(MessageType::NOTIFICATION, type, content);
+    networkManager->broadcastPayload(subscribers, notification.toSharedPayload());
+    return subscribers.size();
+}
+
+const std::vector<int>& NotificationSystem::getSubscribers(NotificationSubType type) const {
+    static const std::vector<int> none;
+    return isValidType(type) ? subscribersByType[static_cast<std::size_t>(type)] : none;
 }
 
 void NotificationSystem::subscribe(int clientID, NotificationSubType type) {
-    subscriptions[clientID].insert(type);
+    if (!isValidType(type)) return;
+
+    ClientSubscriptions& state = ensureRegistered(clientID);
+    if (!(state.mask & maskOf(type))) {
+        addToIndex(clientID, state, type);
+    }
 }
 
 void NotificationSystem::unsubscribe(int clientID, NotificationSubType type) {
-    if (auto it = subscriptions.find(clientID); it != subscriptions.end()) {
-        it->second.erase(type);
+    if (auto it = subscriptions.find(clientID);
+        it != subscriptions.end() && (it->second.mask & maskOf(type))) {
+        removeFromIndex(it->second, type);
     }
 }
 
@@ -47,10 +94,59 @@ bool NotificationSystem::notify(const Message* msg) {
     const int clientID = msg->getClientID();
     const auto type = static_cast<NotificationSubType>(msg->getSubType());
 
-    if (const auto it = subscriptions.find(clientID);
-        it != subscriptions.end() && it->second.contains(type)) {
+    if (isSubscribed(clientID, type)) {
         networkManager->sendMessage(*msg);
         return true;
     }
     return false;
 }
+
+bool NotificationSystem::notify(int clientID, NotificationSubType type, const std::string& message) {
+    if (!isSubscribed(clientID, type)) return false;
+
+    cJSON* content = cJSON_CreateObject();
+    cJSON_AddStringToObject(content, "message", message.c_str());
+    const Message msg(clientID, MessageType::NOTIFICATION, type, content);
+    networkManager->sendMessage(msg);
+    return true;
+}
+
+bool NotificationSystem::isValidType(NotificationSubType type) {
+    return static_cast<std::size_t>(type) < NotificationConstants::NOTIFICATION_TYPE_COUNT;
+}
+
+NotificationSystem::SubscriptionMask NotificationSystem::maskOf(NotificationSubType type) {
+    return isValidType(type) ? static_cast<SubscriptionMask>(1u << static_cast<unsigned>(type)) : 0;
+}
+
+NotificationSystem::ClientSubscriptions& NotificationSystem::ensureRegistered(int clientID) {
+    auto [it, inserted] = subscriptions.try_emplace(clientID);
+    if (inserted) {
+        it->second.mask = 0;
+        it->second.clientSlot = clients.size();
+        clients.push_back(clientID);
+    }
+    return it->second;
+}
+
+void NotificationSystem::addToIndex(int clientID, ClientSubscriptions& state, NotificationSubType type) {
+    if (!isValidType(type)) return;
+
+    std::vector<int>& subscribers = subscribersByType[static_cast<std::size_t>(type)];
+    state.typeSlots[static_cast<std::size_t>(type)] = subscribers.size();
+    subscribers.push_back(clientID);
+    state.mask |= maskOf(type);
+}
+
+void NotificationSystem::removeFromIndex(ClientSubscriptions& state, NotificationSubType type) {
+    const auto index = static_cast<std::size_t>(type);
+    std::vector<int>& subscribers = subscribersByType[index];
+    const std::size_t slot = state.typeSlots[index];
+
+    const int moved = subscribers.back();
+    subscribers[slot] = moved;
+    subscribers.pop_back();
+    // The moved client may be the one being removed; updating its slot is then harmless.
+    subscriptions[moved].typeSlots[index] = slot;
+    state.mask &= static_cast<SubscriptionMask>(~maskOf(type));
+}
@@ -0,0 +1,94 @@
+#include "server/RateLimiter.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    constexpr std::uint64_t LEVEL_MASK = (std::uint64_t{1} << RateLimiterConstants::LEVEL_BITS) - 1;
+
+    // Spreads keys such as consecutive client IDs over the shards.
+    std::uint64_t mix(std::uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+}
+
+RateLimiter::RateLimiter(const Options& options)
+    : options(options), origin(std::chrono::steady_clock::now()) {
+    if (options.tokensPerSecond <= 0 || options.burst < 1) {
+        throw std::invalid_argument("Rate limiter needs a positive rate and a burst of at least one token");
+    }
+    capacity = static_cast<std::uint64_t>(options.burst * RateLimiterConstants::MILLI);
+    if (capacity > LEVEL_MASK) {
+        throw std::invalid_argument("Rate limiter burst is too large");
+    }
+    keysPerShard = std::max<std::size_t>(options.maxKeys / RateLimiterConstants::SHARDS, 1);
+}
+
+bool RateLimiter::tryAcquire(const std::uint64_t key) {
+    return tryAcquire(key, std::chrono::steady_clock::now());
+}
+
+bool RateLimiter::tryAcquire(const std::uint64_t key, const std::chrono::steady_clock::time_point now) {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - origin).count();
+    const std::uint64_t nowMs = elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0;
+
+    Shard& shard = shards[mix(key) & (RateLimiterConstants::SHARDS - 1)];
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.buckets.find(key);
+    if (it == shard.buckets.end()) {
+        if (shard.buckets.size() >= keysPerShard) evict(shard, nowMs);
+        // A zero word is a full bucket.
+        it = shard.buckets.emplace(key, 0).first;
+        shard.order.push_back(key);
+    }
+
+    const std::uint64_t updatedMs = it->second >> RateLimiterConstants::LEVEL_BITS;
+    const std::uint64_t remaining = deficitAt(it->second, nowMs);
+    if (remaining + RateLimiterConstants::MILLI > capacity) {
+        return false;
+    }
+    it->second = std::max(nowMs, updatedMs) << RateLimiterConstants::LEVEL_BITS | (remaining + RateLimiterConstants::MILLI);
+    return true;
+}
+
+std::size_t RateLimiter::getTrackedKeys() const {
+    std::size_t keys = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard lock(shard.mutex);
+        keys += shard.buckets.size();
+    }
+    return keys;
+}
+
+std::uint64_t RateLimiter::deficitAt(const std::uint64_t word, const std::uint64_t nowMs) const {
+    const std::uint64_t deficit = word & LEVEL_MASK;
+    const std::uint64_t updatedMs = word >> RateLimiterConstants::LEVEL_BITS;
+    const std::uint64_t sinceMs = nowMs > updatedMs ? nowMs - updatedMs : 0;
+
+    // tokensPerSecond tokens per second is tokensPerSecond thousandths per millisecond.
+    const double refill = static_cast<double>(sinceMs) * options.tokensPerSecond;
+    return refill >= static_cast<double>(deficit) ? 0 : deficit - static_cast<std::uint64_t>(refill);
+}
+
+void RateLimiter::evict(Shard& shard, const std::uint64_t nowMs) const {
+    for (std::size_t probe = 0; probe < RateLimiterConstants::EVICTION_PROBES && shard.order.size() > 1; ++probe) {
+        const std::uint64_t key = shard.order.front();
+        shard.order.pop_front();
+        const auto it = shard.buckets.find(key);
+        if (deficitAt(it->second, nowMs) == 0) {
+            shard.buckets.erase(it);
+            return;
+        }
+        // Still limited; it gets another chance after the keys behind it.
+        shard.order.push_back(key);
+    }
+
+    if (!shard.order.empty()) {
+        shard.buckets.erase(shard.order.front());
+        shard.order.pop_front();
+    }
+}
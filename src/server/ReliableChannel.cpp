@@ -0,0 +1,174 @@
+#include "server/ReliableChannel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    constexpr std::string_view SEQUENCE_PREFIX = "{\"seq\":";
+    constexpr std::string_view ACK_PREFIX = "{\"ack\":";
+}
+
+std::optional<std::uint64_t> ReliableChannel::parseSequence(const std::string& datagram) {
+    if (datagram.compare(0, SEQUENCE_PREFIX.size(), SEQUENCE_PREFIX) != 0) return std::nullopt;
+
+    std::uint64_t sequence = 0;
+    const char* first = datagram.data() + SEQUENCE_PREFIX.size();
+    const auto [end, error] = std::from_chars(first, datagram.data() + datagram.size(), sequence);
+    if (error != std::errc() || end == first) return std::nullopt;
+    return sequence;
+}
+
+std::optional<ReliableChannel::Ack> ReliableChannel::parseAck(const std::string& datagram) {
+    if (datagram.compare(0, ACK_PREFIX.size(), ACK_PREFIX) != 0) return std::nullopt;
+
+    cJSON* root = cJSON_Parse(datagram.c_str());
+    cJSON* cumulative = root != nullptr ? cJSON_GetObjectItemCaseSensitive(root, "ack") : nullptr;
+    if (!cJSON_IsNumber(cumulative) || cumulative->valuedouble < 0) {
+        cJSON_Delete(root);
+        return std::nullopt;
+    }
+
+    Ack ack{static_cast<std::uint64_t>(cumulative->valuedouble), {}};
+    cJSON* ranges = cJSON_GetObjectItemCaseSensitive(root, "sack");
+    cJSON* range = nullptr;
+    cJSON_ArrayForEach(range, ranges) {
+        if (!cJSON_IsArray(range) || cJSON_GetArraySize(range) != 2) continue;
+        cJSON* low = cJSON_GetArrayItem(range, 0);
+        cJSON* high = cJSON_GetArrayItem(range, 1);
+        if (!cJSON_IsNumber(low) || !cJSON_IsNumber(high) || low->valuedouble < 0 || high->valuedouble < low->valuedouble) {
+            continue;
+        }
+        ack.selective.emplace_back(static_cast<std::uint64_t>(low->valuedouble), static_cast<std::uint64_t>(high->valuedouble));
+    }
+    cJSON_Delete(root);
+    return ack;
+}
+
+ReliableChannel::Delivery ReliableChannel::receive(const std::uint64_t sequence) {
+    // Within the window the first datagram may just be reordered, so the window stays at 0.
+    if (!receiving && sequence > ReliableChannelConstants::RECEIVE_WINDOW) {
+        receivedThrough = sequence - 1;
+    }
+    if (sequence == 0 || sequence > receivedThrough + ReliableChannelConstants::RECEIVE_WINDOW) {
+        return Delivery::OUT_OF_WINDOW;
+    }
+    ackPending = true;
+    receiving = true;
+    if (sequence <= receivedThrough || !receivedAhead.insert(sequence).second) {
+        return Delivery::DUPLICATE;
+    }
+
+    while (!receivedAhead.empty() && *receivedAhead.begin() == receivedThrough + 1) {
+        receivedAhead.erase(receivedAhead.begin());
+        receivedThrough++;
+    }
+    return Delivery::DELIVER;
+}
+
+bool ReliableChannel::isDuplicate(const std::uint64_t sequence) const {
+    return receiving && (sequence <= receivedThrough || receivedAhead.contains(sequence));
+}
+
+bool ReliableChannel::hasPendingAck() const {
+    return ackPending;
+}
+
+std::string ReliableChannel::takeAck() {
+    ackPending = false;
+
+    std::string ack = std::string(ACK_PREFIX) + std::to_string(receivedThrough) + ",\"sack\":[";
+    std::size_t ranges = 0;
+    for (auto it = receivedAhead.begin(); it != receivedAhead.end() && ranges < ReliableChannelConstants::MAX_SACK_RANGES; ranges++) {
+        const std::uint64_t low = *it;
+        std::uint64_t high = low;
+        while (++it != receivedAhead.end() && *it == high + 1) high++;
+        if (ranges > 0) ack += ',';
+        ack += '[' + std::to_string(low) + ',' + std::to_string(high) + ']';
+    }
+    return ack + "]}";
+}
+
+SharedPayload ReliableChannel::send(const SharedPayload& payload, const Clock::time_point now) {
+    if (!payload || payload->empty() || payload->front() != '{') {
+        throw std::invalid_argument("Reliable datagrams must be JSON objects");
+    }
+
+    const std::uint64_t sequence = nextSequence++;
+    std::string framed = std::string(SEQUENCE_PREFIX) + std::to_string(sequence);
+    if (payload->size() > 1 && (*payload)[1] != '}') framed += ',';
+    framed.append(*payload, 1);
+
+    auto sequenced = std::make_shared<const std::string>(std::move(framed));
+    unacknowledged.emplace(sequence, Outstanding{sequenced, now, 1});
+    if (!timerDeadline) timerDeadline = now + rto;
+    return sequenced;
+}
+
+std::size_t ReliableChannel::acknowledge(const Ack& ack, const Clock::time_point now) {
+    std::size_t released = 0;
+    std::optional<Clock::time_point> newestSample;
+    auto release = [&](std::map<std::uint64_t, Outstanding>::iterator first, std::map<std::uint64_t, Outstanding>::iterator last) {
+        for (auto it = first; it != last; ++it) {
+            // Karn: the ACK of a resent datagram may answer any of its copies.
+            if (it->second.transmissions == 1 && (!newestSample || it->second.sentAt > *newestSample)) {
+                newestSample = it->second.sentAt;
+            }
+            released++;
+        }
+        unacknowledged.erase(first, last);
+    };
+
+    release(unacknowledged.begin(), unacknowledged.upper_bound(ack.cumulative));
+    for (const auto& [low, high] : ack.selective) {
+        release(unacknowledged.lower_bound(low), unacknowledged.upper_bound(high));
+    }
+
+    if (newestSample) sampleRtt(now - *newestSample);
+    if (released > 0) {
+        timerDeadline = unacknowledged.empty() ? std::nullopt : std::optional<Clock::time_point>(now + rto);
+    }
+    return released;
+}
+
+std::vector<SharedPayload> ReliableChannel::collectRetransmissions(const Clock::time_point now) {
+    if (!timerDeadline || now < *timerDeadline || unacknowledged.empty()) return {};
+
+    Outstanding& oldest = unacknowledged.begin()->second;
+    if (oldest.transmissions >= ReliableChannelConstants::MAX_TRANSMISSIONS) {
+        exhausted = true;
+        return {};
+    }
+
+    oldest.transmissions++;
+    rto = std::min(rto * 2, ReliableChannelConstants::MAX_RTO);
+    timerDeadline = now + rto;
+    return {oldest.payload};
+}
+
+bool ReliableChannel::isExhausted() const {
+    return exhausted;
+}
+
+std::chrono::milliseconds ReliableChannel::getRto() const {
+    return rto;
+}
+
+std::size_t ReliableChannel::getUnacknowledged() const {
+    return unacknowledged.size();
+}
+
+void ReliableChannel::sampleRtt(const Clock::duration sample) {
+    if (!smoothedRtt) {
+        smoothedRtt = sample;
+        rttVariance = sample / 2;
+    } else {
+        const Clock::duration error = *smoothedRtt > sample ? *smoothedRtt - sample : sample - *smoothedRtt;
+        rttVariance = (3 * rttVariance + error) / 4;
+        smoothedRtt = (7 * *smoothedRtt + sample) / 8;
+    }
+
+    const Clock::duration computed = *smoothedRtt + std::max<Clock::duration>(ReliableChannelConstants::CLOCK_GRANULARITY, 4 * rttVariance);
+    rto = std::clamp(std::chrono::ceil<std::chrono::milliseconds>(computed),
+                     ReliableChannelConstants::MIN_RTO, ReliableChannelConstants::MAX_RTO);
+}
@@ -0,0 +1,179 @@
+#include "server/RotatingLogFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+RotatingLogFile::RotatingLogFile(const std::string& path, const Options& options)
+    : path(path), options(options), fd(-1), mapped(nullptr), offset(0), fileBytes(0), preambleEnd(0), droppedBytes(0) {
+    this->options.segmentBytes = std::max(options.segmentBytes, RotatingLogFileConstants::MIN_SEGMENT_BYTES);
+
+    // Appending to a previous run's segment would mean finding where its data ends;
+    // starting a new segment keeps every file a clean prefix of written records.
+    struct stat existing{};
+    if (stat(path.c_str(), &existing) == 0 && existing.st_size > 0) {
+        shiftSegments();
+    }
+    if (!openSegment()) {
+        throw std::runtime_error("No se pudo abrir el archivo de log: " + path);
+    }
+}
+
+RotatingLogFile::~RotatingLogFile() {
+    closeSegment();
+}
+
+bool RotatingLogFile::write(const char* data, std::size_t length) {
+    while (length > 0) {
+        // A segment that could not be opened is retried on every write.
+        if (fd < 0 && !openSegment()) {
+            drop(length);
+            return false;
+        }
+
+        const std::size_t room = offset < options.segmentBytes ? options.segmentBytes - offset : 0;
+        if (length > room && offset > preambleEnd) {
+            rotate();
+            continue;
+        }
+
+        // A segment filled by its preamble alone is extended past its size instead.
+        const std::size_t chunk = room == 0 ? length : std::min(length, room);
+        if (mapped != nullptr && chunk <= room && extendTo(offset + chunk)) {
+            std::memcpy(mapped + offset, data, chunk);
+            offset += chunk;
+        } else if (!writeThrough(data, chunk)) {
+            drop(length);
+            return false;
+        }
+        data += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+bool RotatingLogFile::rotateIfDue() {
+    if (options.interval.count() <= 0 || offset <= preambleEnd) return false;
+    if (std::chrono::steady_clock::now() - openedAt < options.interval) return false;
+
+    rotate();
+    return true;
+}
+
+void RotatingLogFile::rotate() {
+    closeSegment();
+    shiftSegments();
+    openSegment();
+}
+
+void RotatingLogFile::appendPreamble(std::string_view bytes) {
+    preamble.append(bytes);
+}
+
+void RotatingLogFile::clearPreamble() {
+    preamble.clear();
+}
+
+std::string RotatingLogFile::segmentPath(std::size_t index) const {
+    return index == 0 ? path : path + "." + std::to_string(index);
+}
+
+std::size_t RotatingLogFile::getWrittenBytes() const {
+    return offset;
+}
+
+std::size_t RotatingLogFile::getDroppedBytes() const {
+    return droppedBytes;
+}
+
+bool RotatingLogFile::openSegment() {
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    offset = 0;
+    fileBytes = 0;
+    // Set before the preamble is written, so writing it never triggers a rotation.
+    preambleEnd = preamble.size();
+    openedAt = std::chrono::steady_clock::now();
+
+    // The blocks are reserved without growing the file, so readers never see padding.
+    // Without the reservation a store into the mapping could fault on a full disk,
+    // so such a segment is written with pwrite instead.
+    const bool reserved = fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(options.segmentBytes)) == 0;
+    void* region = reserved ? mmap(nullptr, options.segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (region != MAP_FAILED) {
+        mapped = static_cast<char*>(region);
+    } else {
+        std::perror(("Log segment not mapped, writing it with pwrite: " + path).c_str());
+    }
+
+    write(preamble.data(), preamble.size());
+    preambleEnd = offset;
+    return true;
+}
+
+bool RotatingLogFile::extendTo(const std::size_t end) {
+    if (end <= fileBytes) return true;
+    if (ftruncate(fd, static_cast<off_t>(end)) != 0) return false;
+
+    fileBytes = end;
+    return true;
+}
+
+bool RotatingLogFile::writeThrough(const char* data, std::size_t length) {
+    while (length > 0) {
+        const ssize_t written = pwrite(fd, data, length, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        offset += static_cast<std::size_t>(written);
+        data += written;
+        length -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+void RotatingLogFile::drop(const std::size_t length) {
+    // Reported when dropping starts, not for every record after it.
+    if (droppedBytes == 0) std::perror(("Log data dropped: " + path).c_str());
+    droppedBytes += length;
+}
+
+void RotatingLogFile::closeSegment() {
+    if (mapped != nullptr) {
+        munmap(mapped, options.segmentBytes);
+        mapped = nullptr;
+    }
+    if (fd >= 0) {
+        // Blocks reserved past the end of the file stay allocated until released.
+        if (offset < options.segmentBytes) {
+            [[maybe_unused]] const int released = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                static_cast<off_t>(offset), static_cast<off_t>(options.segmentBytes - offset));
+        }
+        [[maybe_unused]] const int truncated = ftruncate(fd, static_cast<off_t>(offset));
+        close(fd);
+        fd = -1;
+    }
+    offset = 0;
+    fileBytes = 0;
+    preambleEnd = 0;
+}
+
+void RotatingLogFile::shiftSegments() const {
+    if (options.keepSegments == 0) {
+        unlink(path.c_str());
+        return;
+    }
+
+    unlink(segmentPath(options.keepSegments).c_str());
+    for (std::size_t index = options.keepSegments - 1; index >= 1; --index) {
+        std::rename(segmentPath(index).c_str(), segmentPath(index + 1).c_str());
+    }
+    std::rename(path.c_str(), segmentPath(1).c_str());
+}
@@ -0,0 +1,157 @@
+#include "server/Server.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <utility>
+
+Server::Server() : Server(Options{}) {}
+
+Server::Server(const Options& options) : pendingMessages(options.queueCapacity, options.overflowPolicy),
+                                         dispatcher(&pendingMessages), notificationSystem(&networkManager),
+                                         heartbeatMonitor(&networkManager, options.heartbeat),
+                                         ioBackend(options.ioBackend), snapshotPath(options.snapshotPath),
+                                         shutdownDeadline(options.shutdownDeadline),
+                                         handleSignals(options.handleSignals) {
+    networkManager.setEventLoop(&eventLoop);
+    networkManager.setIdleTimeout(options.idleTimeout);
+    networkManager.setCloseHandler([this](const int clientID) { releaseClient(clientID); });
+    networkManager.setOpenHandler([this](const int clientID) { dispatcher.registerClient(clientID); });
+    dispatcher.setEventLoop(&eventLoop);
+    dispatcher.setNetworkManager(&networkManager);
+    dispatcher.setHeartbeatMonitor(&heartbeatMonitor);
+    dispatcher.setInventoryManager(&inventoryManager);
+    dispatcher.setNotificationSystem(&notificationSystem);
+}
+
+Server::~Server() {
+    if (maintenanceTimer >= 0) {
+        eventLoop.unwatch(maintenanceTimer);
+        close(maintenanceTimer);
+    }
+}
+
+void Server::start(const int port) {
+    networkManager.initialize(port, ioBackend);
+    networkManager.startReceiving([this](Message msg) { receive(std::move(msg)); });
+
+    maintenanceTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (maintenanceTimer < 0) {
+        throw std::runtime_error("Failed to create the maintenance timer");
+    }
+    const auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(ServerConstants::MAINTENANCE_INTERVAL);
+    itimerspec period{};
+    period.it_interval.tv_sec = static_cast<time_t>(interval.count() / 1000000000);
+    period.it_interval.tv_nsec = static_cast<long>(interval.count() % 1000000000);
+    period.it_value = period.it_interval;
+    timerfd_settime(maintenanceTimer, 0, &period, nullptr);
+    eventLoop.watch(maintenanceTimer, EPOLLIN, [this](std::uint32_t) {
+        std::uint64_t expirations;
+        while (read(maintenanceTimer, &expirations, sizeof(expirations)) > 0) {}
+        runMaintenance();
+    });
+    if (handleSignals) ShutdownCoordinator::installSignalHandlers();
+}
+
+void Server::run() {
+    eventLoop.run();
+    if (ShutdownCoordinator::isShutdownRequested() && !shuttingDown) shutdown();
+}
+
+ShutdownCoordinator::Report Server::shutdown() {
+    shuttingDown = true;
+    ShutdownCoordinator coordinator;
+    coordinator.setNetworkManager(&networkManager);
+    coordinator.setDispatcher(&pendingMessages, &dispatcher);
+    coordinator.setEventLoop(&eventLoop);
+    coordinator.setInventory(&inventoryManager, snapshotPath);
+    return coordinator.run(shutdownDeadline);
+}
+
+void Server::stop() {
+    eventLoop.stop();
+}
+
+std::size_t Server::runOnce(const int timeoutMs) {
+    return eventLoop.runOnce(timeoutMs);
+}
+
+EventLoop& Server::getEventLoop() {
+    return eventLoop;
+}
+
+MessageQueue& Server::getMessageQueue() {
+    return pendingMessages;
+}
+
+NetworkManager& Server::getNetworkManager() {
+    return networkManager;
+}
+
+MessageDispatcher& Server::getDispatcher() {
+    return dispatcher;
+}
+
+NotificationSystem& Server::getNotificationSystem() {
+    return notificationSystem;
+}
+
+InventoryManager& Server::getInventoryManager() {
+    return inventoryManager;
+}
+
+HeartbeatMonitor& Server::getHeartbeatMonitor() {
+    return heartbeatMonitor;
+}
+
+void Server::receive(Message msg) {
+    const int sender = msg.getClientID();
+    if (pendingMessages.getPolicy() == MessageQueue::OverflowPolicy::BLOCK &&
+        pendingMessages.size() >= pendingMessages.getCapacity()) {
+        dispatcher.dispatchPending(ServerConstants::DISPATCH_BATCH);
+    }
+
+    switch (pendingMessages.push(std::move(msg))) {
+        case MessageQueue::PushResult::REJECTED:
+            networkManager.sendMessage(MessageQueue::makeBusyReply(sender));
+            break;
+        case MessageQueue::PushResult::CLOSED:
+            break;
+        default:
+            scheduleDispatch();
+            break;
+    }
+}
+
+void Server::scheduleDispatch() {
+    if (dispatchScheduled) return;
+
+    dispatchScheduled = true;
+    eventLoop.post([this] {
+        dispatchScheduled = false;
+        dispatcher.dispatchPending(ServerConstants::DISPATCH_BATCH);
+        if (!pendingMessages.empty()) scheduleDispatch();
+    });
+}
+
+void Server::releaseClient(const int clientID) {
+    dispatcher.removeClient(clientID);
+    notificationSystem.removeClient(clientID);
+    inventoryManager.removeClient(clientID);
+    heartbeatMonitor.removeClient(clientID);
+}
+
+void Server::runMaintenance() {
+    if (shuttingDown) return;
+    // The request may come from a signal handler, which cannot stop the loop itself.
+    if (ShutdownCoordinator::isShutdownRequested()) {
+        eventLoop.stop();
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    networkManager.reapIdleConnections(now);
+    networkManager.retransmitReliable(now);
+    heartbeatMonitor.tick(now);
+}
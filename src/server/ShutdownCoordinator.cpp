@@ -0,0 +1,86 @@
+#include "server/ShutdownCoordinator.hpp"
+#include <csignal>
+#include <utility>
+
+std::atomic<bool> ShutdownCoordinator::shutdownRequested{false};
+
+void ShutdownCoordinator::setNetworkManager(NetworkManager* manager) {
+    networkManager = manager;
+}
+
+void ShutdownCoordinator::setDispatcher(MessageQueue* queue, MessageDispatcher* messageDispatcher) {
+    pendingMessages = queue;
+    dispatcher = messageDispatcher;
+}
+
+void ShutdownCoordinator::setEventLoop(EventLoop* loop) {
+    eventLoop = loop;
+}
+
+void ShutdownCoordinator::setEventLogger(EventLogger* logger) {
+    eventLogger = logger;
+}
+
+void ShutdownCoordinator::setInventory(InventoryManager* inventory, std::string path) {
+    inventoryManager = inventory;
+    snapshotPath = std::move(path);
+}
+
+ShutdownCoordinator::Report ShutdownCoordinator::run(const std::chrono::milliseconds deadline) {
+    const auto until = std::chrono::steady_clock::now() + deadline;
+    Report report{0, 0, true, false, true};
+    if (eventLogger) eventLogger->logEvent("Server", EventLogger::INFO, "Shutting down");
+
+    if (networkManager) networkManager->stopAccepting();
+    drainPending(until, report);
+    if (networkManager) report.outboundFlushed = networkManager->drainOutbound(until);
+    report.deadlineMet = report.abandoned == 0 && report.outboundFlushed;
+
+    if (eventLogger) {
+        eventLogger->logEvent("Server", report.deadlineMet ? EventLogger::INFO : EventLogger::WARNING,
+                              "Drained " + std::to_string(report.dispatched) + " pending messages, abandoned " +
+                              std::to_string(report.abandoned) +
+                              (report.outboundFlushed ? "; outbound queues flushed" : "; outbound queues not flushed"));
+        eventLogger->flush();
+    }
+    if (inventoryManager && !snapshotPath.empty()) {
+        report.snapshotSaved = inventoryManager->saveSnapshot(snapshotPath);
+    }
+    if (networkManager) networkManager->closeAll();
+    return report;
+}
+
+void ShutdownCoordinator::installSignalHandlers() {
+    static_assert(std::atomic<bool>::is_always_lock_free, "the request must be settable from a signal handler");
+    struct sigaction action{};
+    action.sa_handler = &ShutdownCoordinator::handleSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+}
+
+void ShutdownCoordinator::requestShutdown() {
+    shutdownRequested.store(true);
+}
+
+bool ShutdownCoordinator::isShutdownRequested() {
+    return shutdownRequested.load();
+}
+
+void ShutdownCoordinator::drainPending(const std::chrono::steady_clock::time_point deadline, Report& report) {
+    if (pendingMessages == nullptr) return;
+
+    // Closing refuses new messages; the ones already queued can still be popped.
+    pendingMessages->close();
+    while (dispatcher && !pendingMessages->empty() && std::chrono::steady_clock::now() < deadline) {
+        report.dispatched += dispatcher->dispatchPending(ShutdownConstants::DISPATCH_BATCH);
+        if (eventLoop) eventLoop->runOnce(0);
+        if (networkManager) networkManager->flushOutbound();
+    }
+    report.abandoned = pendingMessages->size();
+}
+
+void ShutdownCoordinator::handleSignal(int) {
+    requestShutdown();
+}
@@ -0,0 +1,80 @@
+#include "server/TimerWheel.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    constexpr std::uint64_t SLOT_MASK = TimerWheelConstants::SLOTS - 1;
+    constexpr std::uint64_t SPAN = std::uint64_t{1} << (TimerWheelConstants::SLOT_BITS * TimerWheelConstants::LEVELS);
+
+    constexpr int shiftOf(const std::size_t level) {
+        return static_cast<int>(level) * TimerWheelConstants::SLOT_BITS;
+    }
+}
+
+TimerWheel::TimerWheel(const std::chrono::milliseconds tick, const Clock::time_point start) : tick(tick), start(start) {
+    if (tick.count() <= 0) {
+        throw std::invalid_argument("Timer wheel tick must be positive");
+    }
+}
+
+void TimerWheel::schedule(const std::uint64_t key, const Clock::time_point deadline) {
+    std::uint64_t expiry = 0;
+    if (deadline > start) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - start);
+        const auto tickLength = std::chrono::duration_cast<std::chrono::nanoseconds>(tick);
+        expiry = static_cast<std::uint64_t>((elapsed.count() + tickLength.count() - 1) / tickLength.count());
+    }
+    expiry = std::clamp(expiry, currentTick + 1, currentTick + SPAN - 1);
+
+    insert(Timer{key, expiry});
+    count++;
+}
+
+std::vector<std::uint64_t> TimerWheel::advance(const Clock::time_point now) {
+    std::vector<std::uint64_t> fired;
+    if (now <= start) return fired;
+
+    const auto target = static_cast<std::uint64_t>((now - start) / tick);
+    while (currentTick < target) {
+        if (count == 0) {
+            currentTick = target;
+            break;
+        }
+
+        const std::uint64_t t = ++currentTick;
+        for (std::size_t level = TimerWheelConstants::LEVELS - 1; level > 0; --level) {
+            if ((t & ((std::uint64_t{1} << shiftOf(level)) - 1)) == 0) {
+                cascade(level, (t >> shiftOf(level)) & SLOT_MASK);
+            }
+        }
+
+        std::vector<Timer>& slot = levels[0][t & SLOT_MASK];
+        for (const Timer& timer : slot) {
+            fired.push_back(timer.key);
+        }
+        count -= slot.size();
+        slot.clear();
+    }
+    return fired;
+}
+
+std::size_t TimerWheel::size() const {
+    return count;
+}
+
+void TimerWheel::insert(const Timer& timer) {
+    const std::uint64_t delta = timer.expiry - currentTick;
+    std::size_t level = 0;
+    while (level + 1 < TimerWheelConstants::LEVELS && delta >= (std::uint64_t{1} << shiftOf(level + 1))) {
+        level++;
+    }
+    levels[level][(timer.expiry >> shiftOf(level)) & SLOT_MASK].push_back(timer);
+}
+
+void TimerWheel::cascade(const std::size_t level, const std::size_t slot) {
+    std::vector<Timer> timers = std::exchange(levels[level][slot], {});
+    for (const Timer& timer : timers) {
+        insert(timer);
+    }
+}
@@ -0,0 +1,40 @@
+#include "server/LogDecoder.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+/**
+ * @brief Renders a binary EventLogger log as text on standard output.
+ *
+ * Usage: logdecode [--ms | --us] <log file>
+ */
+int main(int argc, char* argv[]) {
+    auto precision = EventLogger::TimestampPrecision::SECONDS;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--ms") == 0) {
+            precision = EventLogger::TimestampPrecision::MILLISECONDS;
+        } else if (std::strcmp(argv[i], "--us") == 0) {
+            precision = EventLogger::TimestampPrecision::MICROSECONDS;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [--ms | --us] <log file>" << std::endl;
+        return 2;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "No se pudo abrir el archivo de log: " << path << std::endl;
+        return 1;
+    }
+
+    LogDecoder decoder(precision);
+    if (!decoder.decode(in, std::cout)) {
+        std::cerr << "Registro binario inválido tras " << decoder.getDecodedEvents() << " eventos" << std::endl;
+        return 1;
+    }
+    return 0;
+}
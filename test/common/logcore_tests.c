@@ -0,0 +1,118 @@
+#include "unity.h"
+#include "logcore.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char* LOG_FILE = "test_logcore.log";
+
+void setUp(void) {
+    unlink(LOG_FILE);
+}
+
+void tearDown(void) {
+    unlink(LOG_FILE);
+}
+
+static size_t readLog(char* buffer, size_t size) {
+    FILE* file = fopen(LOG_FILE, "r");
+    if (file == NULL) return 0;
+    size_t length = fread(buffer, 1, size - 1, file);
+    buffer[length] = '\0';
+    fclose(file);
+    return length;
+}
+
+static size_t countLines(const char* text) {
+    size_t lines = 0;
+    for (; *text; ++text) {
+        if (*text == '\n') lines++;
+    }
+    return lines;
+}
+
+void test_FormatRecordMatchesServerFormat(void) {
+    struct timespec time = { 0, 123456789 };
+    char record[256];
+    size_t length = logCoreFormatRecord(record, &time, 3, "Client", 6, LOG_CORE_WARNING, "hello", 5);
+    record[length] = '\0';
+
+    TEST_ASSERT_EQUAL_CHAR('[', record[0]);
+    TEST_ASSERT_EQUAL_CHAR('.', record[20]);
+    TEST_ASSERT_EQUAL_STRING("123] [Client] [WARNING] hello\n", record + 21);
+}
+
+void test_TimestampPrecision(void) {
+    struct timespec time = { 1000, 987654321 };
+    char stamp[LOG_CORE_TIMESTAMP_MAX_LENGTH];
+
+    TEST_ASSERT_EQUAL_size_t(19, logCoreFormatTimestamp(stamp, &time, 0));
+    TEST_ASSERT_EQUAL_size_t(23, logCoreFormatTimestamp(stamp, &time, 3));
+    TEST_ASSERT_EQUAL_MEMORY(".987", stamp + 19, 4);
+    TEST_ASSERT_EQUAL_size_t(26, logCoreFormatTimestamp(stamp, &time, 6));
+    TEST_ASSERT_EQUAL_MEMORY(".987654", stamp + 19, 7);
+}
+
+void test_SyncSinkBuffersUntilFlush(void) {
+    LogCoreSink* sink = logCoreOpen(LOG_FILE, NULL);
+    TEST_ASSERT_NOT_NULL(sink);
+
+    TEST_ASSERT_TRUE(logCoreLog(sink, LOG_CORE_INFO, "Client", "buffered"));
+    char contents[4096];
+    TEST_ASSERT_EQUAL_size_t(0, readLog(contents, sizeof(contents)));
+
+    logCoreFlush(sink);
+    readLog(contents, sizeof(contents));
+    TEST_ASSERT_NOT_NULL(strstr(contents, "[Client] [INFO] buffered\n"));
+    logCoreClose(sink);
+}
+
+void test_AsyncSinkWritesEverythingOnClose(void) {
+    LogCoreOptions options = logCoreDefaultOptions();
+    options.async = true;
+    options.bufferBytes = 1024;
+    LogCoreSink* sink = logCoreOpen(LOG_FILE, &options);
+    TEST_ASSERT_NOT_NULL(sink);
+
+    for (int i = 0; i < 500; ++i) {
+        logCoreLog(sink, LOG_CORE_DEBUG, "Load", "request sent");
+    }
+    logCoreClose(sink);
+
+    static char contents[128 * 1024];
+    readLog(contents, sizeof(contents));
+    TEST_ASSERT_EQUAL_size_t(500, countLines(contents));
+}
+
+void test_LongRecordIsWrittenWhole(void) {
+    LogCoreOptions options = logCoreDefaultOptions();
+    options.bufferBytes = 64;
+    LogCoreSink* sink = logCoreOpen(LOG_FILE, &options);
+
+    char message[300];
+    memset(message, 'm', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+    logCoreLog(sink, LOG_CORE_INFO, "Client", "short");
+    logCoreLog(sink, LOG_CORE_INFO, "Client", message);
+    logCoreClose(sink);
+
+    char contents[4096];
+    readLog(contents, sizeof(contents));
+    TEST_ASSERT_EQUAL_size_t(2, countLines(contents));
+    TEST_ASSERT_NOT_NULL(strstr(contents, message));
+}
+
+void test_OpenFailsForInvalidPath(void) {
+    TEST_ASSERT_NULL(logCoreOpen("/invalid/path/to/log.log", NULL));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_FormatRecordMatchesServerFormat);
+    RUN_TEST(test_TimestampPrecision);
+    RUN_TEST(test_SyncSinkBuffersUntilFlush);
+    RUN_TEST(test_AsyncSinkWritesEverythingOnClose);
+    RUN_TEST(test_LongRecordIsWrittenWhole);
+    RUN_TEST(test_OpenFailsForInvalidPath);
+    return UNITY_END();
+}
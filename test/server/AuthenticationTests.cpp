@@ -1,13 +1,32 @@
 #include "server/Authentication.hpp"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unistd.h>
 
 class AuthenticationTest : public ::testing::Test {
 protected:
-    Authentication auth;
+    // A low iteration count keeps the suite fast; the hashing path is the same.
+    static Authentication::Config fastConfig() {
+        Authentication::Config config;
+        config.kdfIterations = 1000;
+        return config;
+    }
+
+    Authentication auth{fastConfig()};
 
     void SetUp() override {
         auth.addCredentials(1, "password123");
     }
+
+    // The emergency phrase is only ever read from a credential database.
+    void configureSecretPhrase(const std::string& phrase) {
+        const std::string path = "test_auth_phrase.db";
+        CredentialDatabase::write(path, {}, phrase, 1000);
+        auth.loadDatabase(path);
+        unlink(path.c_str());
+    }
 };
 
 TEST_F(AuthenticationTest, SuccessfulAuthentication) {
@@ -77,6 +96,7 @@ TEST_F(AuthenticationTest, BlockDueToEmergency) {
 }
 
 TEST_F(AuthenticationTest, UnlockWithCorrectSecretPhrase) {
+    configureSecretPhrase("emergencyUnlock");
     auth.blockDueToEmergency(1);
     EXPECT_FALSE(auth.isAuthorized(1));
 
@@ -86,6 +106,7 @@ TEST_F(AuthenticationTest, UnlockWithCorrectSecretPhrase) {
 }
 
 TEST_F(AuthenticationTest, UnlockWithIncorrectSecretPhrase) {
+    configureSecretPhrase("emergencyUnlock");
     auth.blockDueToEmergency(1);
     EXPECT_FALSE(auth.isAuthorized(1));
 
@@ -99,5 +120,409 @@ TEST_F(AuthenticationTest, BlockDueToEmergencyForUnregisteredClient) {
 }
 
 TEST_F(AuthenticationTest, UnlockWithSecretPhraseForUnregisteredClient) {
+    configureSecretPhrase("emergencyUnlock");
     EXPECT_FALSE(auth.unlockWithSecretPhrase(99, "emergencyUnlock"));
-}
\ No newline at end of file
+}
+
+TEST_F(AuthenticationTest, NoConfiguredSecretPhraseUnlocksNobody) {
+    auth.blockDueToEmergency(1);
+    EXPECT_FALSE(auth.unlockWithSecretPhrase(1, "emergencyUnlock"));
+    EXPECT_FALSE(auth.unlockWithSecretPhrase(1, ""));
+    EXPECT_FALSE(auth.isAuthorized(1));
+}
+TEST_F(AuthenticationTest, ReconnectWithinTtlSkipsKdf) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::size_t evaluations = auth.getKdfEvaluations();
+
+    auth.setLoggedOut(1);
+    EXPECT_TRUE(auth.authenticate(1, "password123"));
+    EXPECT_EQ(auth.getKdfEvaluations(), evaluations);
+}
+
+TEST_F(AuthenticationTest, WrongPasswordIsNotAcceptedFromCache) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    EXPECT_FALSE(auth.authenticate(1, "password124"));
+}
+
+TEST_F(AuthenticationTest, ExpiredVerificationRunsKdfAgain) {
+    Authentication::Config config;
+    config.kdfIterations = 1000;
+    config.verifiedLoginTtl = std::chrono::milliseconds(1);
+    Authentication shortLived(config);
+    shortLived.addCredentials(5, "hub5");
+
+    ASSERT_TRUE(shortLived.authenticate(5, "hub5"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(shortLived.authenticate(5, "hub5"));
+    EXPECT_EQ(shortLived.getKdfEvaluations(), 2);
+}
+
+TEST_F(AuthenticationTest, DefaultSettingsHashAndVerify) {
+    Authentication defaults;
+    defaults.addCredentials(7, "hub7");
+    EXPECT_TRUE(defaults.authenticate(7, "hub7"));
+    EXPECT_FALSE(defaults.authenticate(7, "hub8"));
+}
+
+TEST_F(AuthenticationTest, RecreatedCredentialsInvalidateCache) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    auth.removeCredentials(1);
+    auth.addCredentials(1, "changed");
+
+    EXPECT_FALSE(auth.authenticate(1, "password123"));
+    EXPECT_TRUE(auth.authenticate(1, "changed"));
+}
+
+TEST_F(AuthenticationTest, SessionTokenRequiresLogin) {
+    EXPECT_TRUE(auth.issueSessionToken(1).empty());
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    EXPECT_EQ(auth.issueSessionToken(1).size(), 2 * AuthenticationConstants::SESSION_TOKEN_BYTES);
+}
+
+TEST_F(AuthenticationTest, SessionTokenAuthorizesWithoutKdf) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string token = auth.issueSessionToken(1);
+    const std::size_t evaluations = auth.getKdfEvaluations();
+
+    EXPECT_TRUE(auth.validateSessionToken(1, token));
+    EXPECT_TRUE(auth.isAuthorized(1));
+    EXPECT_EQ(auth.getKdfEvaluations(), evaluations);
+}
+
+TEST_F(AuthenticationTest, SessionTokenMovesToTheConnectionPresentingIt) {
+    auth.addCredentials(2, "hub2");
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string token = auth.issueSessionToken(1);
+
+    EXPECT_FALSE(auth.validateSessionToken(2, token));
+    EXPECT_FALSE(auth.isAuthorized(2));
+    EXPECT_FALSE(auth.validateSessionToken(3, "not-a-token"));
+
+    EXPECT_TRUE(auth.validateSessionToken(3, token));
+    EXPECT_TRUE(auth.isAuthorized(3));
+    EXPECT_FALSE(auth.isAuthorized(1));
+    EXPECT_TRUE(auth.validateSessionToken(3, token));
+    auth.setLoggedOut(3);
+    EXPECT_FALSE(auth.validateSessionToken(3, token));
+}
+
+TEST_F(AuthenticationTest, ReissuedSessionTokenReplacesPrevious) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string first = auth.issueSessionToken(1);
+    const std::string second = auth.issueSessionToken(1);
+
+    EXPECT_FALSE(auth.validateSessionToken(1, first));
+    EXPECT_TRUE(auth.validateSessionToken(1, second));
+}
+
+TEST_F(AuthenticationTest, LogoutAndBlockRevokeSessionToken) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    std::string token = auth.issueSessionToken(1);
+    auth.setLoggedOut(1);
+    EXPECT_FALSE(auth.validateSessionToken(1, token));
+
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    token = auth.issueSessionToken(1);
+    auth.blockDueToEmergency(1);
+    EXPECT_FALSE(auth.validateSessionToken(1, token));
+}
+
+TEST_F(AuthenticationTest, ExpiredSessionTokenIsRejected) {
+    Authentication::Config config = fastConfig();
+    config.sessionTokenTtl = std::chrono::milliseconds(1);
+    Authentication shortLived(config);
+    shortLived.addCredentials(5, "hub5");
+
+    ASSERT_TRUE(shortLived.authenticate(5, "hub5"));
+    const std::string token = shortLived.issueSessionToken(5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_FALSE(shortLived.validateSessionToken(5, token));
+}
+
+TEST_F(AuthenticationTest, ClientIdsOutsideStatusTableAreAuthorized) {
+    const int largeID = static_cast<int>(AuthenticationConstants::STATUS_CHUNKS * AuthenticationConstants::STATUS_CHUNK_SIZE) + 7;
+    auth.addCredentials(largeID, "far");
+    auth.addCredentials(-3, "negative");
+
+    EXPECT_FALSE(auth.isAuthorized(largeID));
+    ASSERT_TRUE(auth.authenticate(largeID, "far"));
+    ASSERT_TRUE(auth.authenticate(-3, "negative"));
+    EXPECT_TRUE(auth.isAuthorized(largeID));
+    EXPECT_TRUE(auth.isAuthorized(-3));
+
+    auth.setLoggedOut(largeID);
+    EXPECT_FALSE(auth.isAuthorized(largeID));
+}
+
+TEST_F(AuthenticationTest, ClientIdsSharingAStatusSlotKeepTheirOwnStatus) {
+    // Same slot as client 1, as a later generation of a ConnectionTable ID would be.
+    const int reused = (3 << AuthenticationConstants::STATUS_SLOT_BITS) | 1;
+    auth.addCredentials(reused, "reused");
+
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    EXPECT_FALSE(auth.isAuthorized(reused));
+    ASSERT_TRUE(auth.authenticate(reused, "reused"));
+    EXPECT_TRUE(auth.isAuthorized(1));
+    EXPECT_TRUE(auth.isAuthorized(reused));
+
+    auth.setLoggedOut(1);
+    EXPECT_FALSE(auth.isAuthorized(1));
+    EXPECT_TRUE(auth.isAuthorized(reused));
+
+    auth.setLoggedOut(reused);
+    EXPECT_FALSE(auth.isAuthorized(reused));
+}
+
+TEST_F(AuthenticationTest, ClosedConnectionIsLoggedOutButKeepsItsSession) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string token = auth.issueSessionToken(1);
+    auth.closeConnection(1);
+    EXPECT_FALSE(auth.isAuthorized(1));
+
+    // The next connection of the slot takes its status entry over.
+    const int reconnected = (1 << AuthenticationConstants::STATUS_SLOT_BITS) | 1;
+    auth.openConnection(reconnected);
+    EXPECT_FALSE(auth.isAuthorized(reconnected));
+    EXPECT_TRUE(auth.validateSessionToken(reconnected, token));
+    EXPECT_TRUE(auth.isAuthorized(reconnected));
+}
+
+TEST_F(AuthenticationTest, RemovedClientIsNoLongerAuthorized) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    auth.removeCredentials(1);
+    EXPECT_FALSE(auth.isAuthorized(1));
+}
+
+TEST_F(AuthenticationTest, ConcurrentReadersSeeConsistentStatus) {
+    auth.addCredentials(2, "hub2");
+    ASSERT_TRUE(auth.authenticate(2, "hub2"));
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> wrongReads{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                // Client 2 stays logged in; client 1 flips between states.
+                if (!auth.isAuthorized(2)) wrongReads++;
+                (void)auth.isAuthorized(1);
+            }
+        });
+    }
+
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(auth.authenticate(1, "password123"));
+        auth.setLoggedOut(1);
+    }
+    stop = true;
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(wrongReads.load(), 0);
+    EXPECT_FALSE(auth.isAuthorized(1));
+    EXPECT_TRUE(auth.isAuthorized(2));
+}
+
+TEST_F(AuthenticationTest, GlobalLockdownBlocksEveryClient) {
+    auth.addCredentials(2, "hub2");
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    ASSERT_TRUE(auth.authenticate(2, "hub2"));
+
+    auth.beginLockdown();
+    EXPECT_TRUE(auth.isLockedDown(1));
+    EXPECT_FALSE(auth.isAuthorized(1));
+    EXPECT_FALSE(auth.isAuthorized(2));
+    EXPECT_FALSE(auth.authenticate(2, "hub2"));
+
+    auth.endLockdown();
+    EXPECT_FALSE(auth.isLockedDown(1));
+    EXPECT_TRUE(auth.isAuthorized(1));
+    EXPECT_TRUE(auth.isAuthorized(2));
+}
+
+TEST_F(AuthenticationTest, GroupLockdownOnlyBlocksItsGroup) {
+    auth.addCredentials(2, "hub2");
+    auth.setGroup(2, 4);
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    ASSERT_TRUE(auth.authenticate(2, "hub2"));
+
+    auth.beginLockdown(4);
+    EXPECT_TRUE(auth.isAuthorized(1));
+    EXPECT_FALSE(auth.isAuthorized(2));
+
+    auth.endLockdown(4);
+    EXPECT_TRUE(auth.isAuthorized(2));
+}
+
+TEST_F(AuthenticationTest, SecretPhraseExemptsClientFromCurrentLockdown) {
+    auth.addCredentials(2, "hub2");
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    ASSERT_TRUE(auth.authenticate(2, "hub2"));
+    auth.beginLockdown();
+    configureSecretPhrase("emergencyUnlock");
+
+    EXPECT_FALSE(auth.unlockWithSecretPhrase(1, "wrongPhrase"));
+    EXPECT_TRUE(auth.unlockWithSecretPhrase(1, "emergencyUnlock"));
+    EXPECT_TRUE(auth.isAuthorized(1));
+    EXPECT_FALSE(auth.isAuthorized(2));
+
+    // A new lockdown applies to the client again.
+    auth.beginLockdown();
+    EXPECT_FALSE(auth.isAuthorized(1));
+}
+
+TEST_F(AuthenticationTest, LockdownInvalidatesCachedCredentials) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string token = auth.issueSessionToken(1);
+    auth.setLoggedOut(1);
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string second = auth.issueSessionToken(1);
+    const std::size_t evaluations = auth.getKdfEvaluations();
+
+    auth.beginLockdown();
+    EXPECT_TRUE(auth.issueSessionToken(1).empty());
+    auth.endLockdown();
+
+    EXPECT_FALSE(auth.validateSessionToken(1, token));
+    EXPECT_FALSE(auth.validateSessionToken(1, second));
+    EXPECT_TRUE(auth.authenticate(1, "password123"));
+    EXPECT_EQ(auth.getKdfEvaluations(), evaluations + 1);
+}
+
+TEST_F(AuthenticationTest, LoginFloodFromClientIsThrottledBeforeHashing) {
+    Authentication::Config config = fastConfig();
+    config.clientLoginLimit = {0.001, 2};
+    Authentication limited(config);
+    limited.addCredentials(1, "password123");
+
+    EXPECT_FALSE(limited.authenticate(1, "guess1"));
+    EXPECT_FALSE(limited.authenticate(1, "guess2"));
+    EXPECT_FALSE(limited.authenticate(1, "password123"));
+    EXPECT_EQ(limited.getKdfEvaluations(), 2);
+    EXPECT_EQ(limited.getThrottledLogins(), 1);
+
+    // Throttled attempts do not count towards blocking the client.
+    EXPECT_FALSE(limited.unblockWithFingerprint(1));
+}
+
+TEST_F(AuthenticationTest, LoginFloodFromSourceIsThrottled) {
+    Authentication::Config config = fastConfig();
+    config.sourceLoginLimit = {0.001, 2};
+    Authentication limited(config);
+    for (int id = 1; id <= 3; ++id) limited.addCredentials(id, "hub");
+
+    EXPECT_TRUE(limited.authenticate(1, "hub", "10.0.0.9"));
+    EXPECT_TRUE(limited.authenticate(2, "hub", "10.0.0.9"));
+    EXPECT_FALSE(limited.authenticate(3, "hub", "10.0.0.9"));
+    EXPECT_TRUE(limited.authenticate(3, "hub", "10.0.0.10"));
+    EXPECT_EQ(limited.getThrottledLogins(), 1);
+}
+
+TEST_F(AuthenticationTest, CachedLoginsAreNotThrottled) {
+    Authentication::Config config = fastConfig();
+    config.clientLoginLimit = {0.001, 1};
+    Authentication limited(config);
+    limited.addCredentials(1, "password123");
+
+    ASSERT_TRUE(limited.authenticate(1, "password123"));
+    for (int i = 0; i < 10; ++i) {
+        limited.setLoggedOut(1);
+        EXPECT_TRUE(limited.authenticate(1, "password123"));
+    }
+    EXPECT_EQ(limited.getThrottledLogins(), 0);
+}
+
+TEST_F(AuthenticationTest, ClientsAreLoadedFromDatabase) {
+    const std::string path = "test_auth_credentials.db";
+    CredentialDatabase::write(path, {CredentialDatabase::makeEntry(10, "hub10", 1000),
+                                     CredentialDatabase::makeEntry(11, "hub11", 1000, 3)}, "", 1000);
+    auth.loadDatabase(path);
+    unlink(path.c_str());
+
+    EXPECT_EQ(auth.getDatabaseSize(), 2);
+    EXPECT_TRUE(auth.authenticate(10, "hub10"));
+    EXPECT_FALSE(auth.authenticate(11, "hub10"));
+    EXPECT_TRUE(auth.authenticate(1, "password123"));
+
+    auth.beginLockdown(3);
+    EXPECT_TRUE(auth.isLockedDown(11));
+    EXPECT_FALSE(auth.isLockedDown(10));
+}
+
+TEST_F(AuthenticationTest, ReloadAppliesRemovalsAndPasswordChanges) {
+    const std::string path = "test_auth_credentials.db";
+    const auto unchanged = CredentialDatabase::makeEntry(10, "hub10", 1000);
+    CredentialDatabase::write(path, {unchanged,
+                                     CredentialDatabase::makeEntry(11, "hub11", 1000),
+                                     CredentialDatabase::makeEntry(12, "hub12", 1000)}, "", 1000);
+    auth.loadDatabase(path);
+    ASSERT_TRUE(auth.authenticate(10, "hub10"));
+    ASSERT_TRUE(auth.authenticate(11, "hub11"));
+    ASSERT_TRUE(auth.authenticate(12, "hub12"));
+
+    CredentialDatabase::write(path, {unchanged, CredentialDatabase::makeEntry(11, "changed", 1000)}, "", 1000);
+    auth.loadDatabase(path);
+    unlink(path.c_str());
+
+    EXPECT_TRUE(auth.isAuthorized(10));
+    EXPECT_FALSE(auth.isAuthorized(11));
+    EXPECT_FALSE(auth.isAuthorized(12));
+    EXPECT_FALSE(auth.authenticate(11, "hub11"));
+    EXPECT_TRUE(auth.authenticate(11, "changed"));
+    EXPECT_FALSE(auth.authenticate(12, "hub12"));
+}
+
+TEST_F(AuthenticationTest, FailedReloadKeepsCurrentDatabase) {
+    const std::string path = "test_auth_credentials.db";
+    CredentialDatabase::write(path, {CredentialDatabase::makeEntry(10, "hub10", 1000)}, "", 1000);
+    auth.loadDatabase(path);
+    unlink(path.c_str());
+
+    EXPECT_THROW(auth.loadDatabase(path), std::runtime_error);
+    EXPECT_TRUE(auth.authenticate(10, "hub10"));
+}
+
+TEST_F(AuthenticationTest, SecretPhraseComesFromDatabase) {
+    const std::string path = "test_auth_credentials.db";
+    CredentialDatabase::write(path, {}, "new phrase", 1000);
+    auth.loadDatabase(path);
+    unlink(path.c_str());
+
+    auth.blockDueToEmergency(1);
+    EXPECT_FALSE(auth.unlockWithSecretPhrase(1, "emergencyUnlock"));
+    EXPECT_TRUE(auth.unlockWithSecretPhrase(1, "new phrase"));
+}
+
+TEST_F(AuthenticationTest, RemovedDatabaseClientStaysRemoved) {
+    const std::string path = "test_auth_credentials.db";
+    CredentialDatabase::write(path, {CredentialDatabase::makeEntry(10, "hub10", 1000)}, "", 1000);
+    auth.loadDatabase(path);
+    ASSERT_TRUE(auth.authenticate(10, "hub10"));
+
+    auth.removeCredentials(10);
+    EXPECT_FALSE(auth.isAuthorized(10));
+    EXPECT_FALSE(auth.authenticate(10, "hub10"));
+    auth.loadDatabase(path);
+    unlink(path.c_str());
+    EXPECT_FALSE(auth.authenticate(10, "hub10"));
+
+    auth.addCredentials(10, "again");
+    EXPECT_TRUE(auth.authenticate(10, "again"));
+}
+
+TEST_F(AuthenticationTest, ReloadUpdatesGroupAndPasswordOfLoggedInClients) {
+    const std::string path = "test_auth_credentials.db";
+    CredentialDatabase::write(path, {CredentialDatabase::makeEntry(10, "hub10", 1000)}, "", 1000);
+    auth.loadDatabase(path);
+    ASSERT_TRUE(auth.authenticate(10, "hub10"));
+    auth.loadDatabase(path);
+    EXPECT_TRUE(auth.isAuthorized(10));
+
+    CredentialDatabase::write(path, {CredentialDatabase::makeEntry(10, "changed", 1000, 2)}, "", 1000);
+    auth.loadDatabase(path);
+    unlink(path.c_str());
+    EXPECT_FALSE(auth.isAuthorized(10));
+    EXPECT_FALSE(auth.authenticate(10, "hub10"));
+    EXPECT_TRUE(auth.authenticate(10, "changed"));
+    auth.beginLockdown(2);
+    EXPECT_FALSE(auth.isAuthorized(10));
+}
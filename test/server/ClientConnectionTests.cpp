@@ -85,6 +85,16 @@ TEST_F(ClientConnectionTest, ConnectionState) {
     EXPECT_FALSE(connection.isConnected());
 }
 
+TEST_F(ClientConnectionTest, TouchRecordsLastActivity) {
+    const auto before = std::chrono::steady_clock::now();
+    ClientConnection connection(6, 47, ipv4Addr, sizeof(ipv4Addr), ClientConnection::Protocol::UDP);
+    EXPECT_GE(connection.getLastActivity(), before);
+
+    const auto later = before + std::chrono::seconds(30);
+    connection.touch(later);
+    EXPECT_EQ(connection.getLastActivity(), later);
+}
+
 TEST_F(ClientConnectionTest, ProtocolHandling) {
     ClientConnection tcpConnection(4, 45, ipv4Addr, sizeof(ipv4Addr), ClientConnection::Protocol::TCP);
     ClientConnection udpConnection(5, 46, ipv4Addr, sizeof(ipv4Addr), ClientConnection::Protocol::UDP);
@@ -92,3 +102,20 @@ TEST_F(ClientConnectionTest, ProtocolHandling) {
     EXPECT_EQ(tcpConnection.getProtocol(), ClientConnection::Protocol::TCP);
     EXPECT_EQ(udpConnection.getProtocol(), ClientConnection::Protocol::UDP);
 }
+
+TEST_F(ClientConnectionTest, OutboundQueueResumesPartialWrites) {
+    ClientConnection connection(8, 49, ipv4Addr, sizeof(ipv4Addr), ClientConnection::Protocol::TCP);
+    connection.queueOutbound(std::make_shared<const std::string>("hello"));
+    connection.queueOutbound(std::make_shared<const std::string>("world"));
+    EXPECT_EQ(connection.getPendingOutputCount(), 2);
+
+    connection.consumeOutboundBytes(7);
+    EXPECT_EQ(connection.getPendingOutputCount(), 1);
+
+    iovec iov[4];
+    ASSERT_EQ(connection.fillOutboundIov(iov, 4), 1);
+    EXPECT_EQ(std::string(static_cast<const char*>(iov[0].iov_base), iov[0].iov_len), "rld");
+
+    connection.consumeOutboundBytes(3);
+    EXPECT_FALSE(connection.hasPendingOutput());
+}
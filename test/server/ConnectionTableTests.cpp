@@ -0,0 +1,67 @@
+#include "server/ConnectionTable.hpp"
+#include <gtest/gtest.h>
+
+class ConnectionTableTest : public ::testing::Test {
+protected:
+    ConnectionTable table;
+    sockaddr_storage address{};
+
+    int add(int sock) {
+        return table.emplace(sock, address, sizeof(sockaddr_in), ClientConnection::Protocol::TCP);
+    }
+};
+
+TEST_F(ConnectionTableTest, FirstClientsGetSmallIds) {
+    EXPECT_EQ(add(10), 1);
+    EXPECT_EQ(add(11), 2);
+    EXPECT_EQ(table.size(), 2);
+}
+
+TEST_F(ConnectionTableTest, FindReturnsTheStoredConnection) {
+    const int id = add(10);
+    ClientConnection* connection = table.find(id);
+    ASSERT_NE(connection, nullptr);
+    EXPECT_EQ(connection->getClientID(), id);
+    EXPECT_EQ(connection->getSocket(), 10);
+    EXPECT_TRUE(table.contains(id));
+}
+
+TEST_F(ConnectionTableTest, UnknownIdsAreNotFound) {
+    add(10);
+    EXPECT_EQ(table.find(0), nullptr);
+    EXPECT_EQ(table.find(-1), nullptr);
+    EXPECT_EQ(table.find(2), nullptr);
+    EXPECT_EQ(table.find(1 + (1 << ConnectionTableConstants::INDEX_BITS)), nullptr);
+}
+
+TEST_F(ConnectionTableTest, ErasedSlotIsReusedWithNewId) {
+    const int first = add(10);
+    add(11);
+    ASSERT_TRUE(table.erase(first));
+    EXPECT_FALSE(table.erase(first));
+    EXPECT_EQ(table.find(first), nullptr);
+
+    const int reused = add(12);
+    EXPECT_NE(reused, first);
+    EXPECT_EQ(reused & ConnectionTableConstants::MAX_CONNECTIONS, first);
+    EXPECT_EQ(table.find(reused)->getSocket(), 12);
+    EXPECT_EQ(table.find(first), nullptr);
+    EXPECT_EQ(table.size(), 2);
+}
+
+TEST_F(ConnectionTableTest, ConnectionsDoNotMoveWhenTableGrows) {
+    const ClientConnection* connection = table.find(add(10));
+    for (int i = 0; i < 1000; ++i) add(100 + i);
+    EXPECT_EQ(table.find(1), connection);
+}
+
+TEST_F(ConnectionTableTest, ForEachVisitsOpenConnections) {
+    add(10);
+    const int erased = add(11);
+    add(12);
+    table.erase(erased);
+
+    int sockets = 0;
+    table.forEach([&](ClientConnection& connection) { sockets += connection.getSocket(); });
+    EXPECT_EQ(sockets, 22);
+}
@@ -0,0 +1,69 @@
+#include "server/CredentialDatabase.hpp"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <unistd.h>
+
+class CredentialDatabaseTest : public ::testing::Test {
+protected:
+    std::string databaseFile = "test_credentials.db";
+
+    void TearDown() override {
+        unlink(databaseFile.c_str());
+    }
+};
+
+TEST_F(CredentialDatabaseTest, WrittenEntriesAreFound) {
+    std::vector<CredentialDatabase::Entry> entries;
+    for (int id : {30, 10, 20}) {
+        entries.push_back(CredentialDatabase::makeEntry(id, "hub" + std::to_string(id), 10, static_cast<std::uint8_t>(id / 10)));
+    }
+    CredentialDatabase::write(databaseFile, entries, "", 10);
+
+    const CredentialDatabase database(databaseFile);
+    EXPECT_EQ(database.size(), 3);
+    for (const auto& expected : entries) {
+        const auto found = database.find(expected.clientID);
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(found->iterations, 10);
+        EXPECT_EQ(found->salt, expected.salt);
+        EXPECT_EQ(found->hash, expected.hash);
+        EXPECT_EQ(found->group, expected.group);
+    }
+    EXPECT_FALSE(database.find(15).has_value());
+    EXPECT_FALSE(database.find(-1).has_value());
+}
+
+TEST_F(CredentialDatabaseTest, EmptyDatabaseHasNoEntries) {
+    CredentialDatabase::write(databaseFile, {}, "", 10);
+    const CredentialDatabase database(databaseFile);
+    EXPECT_EQ(database.size(), 0);
+    EXPECT_FALSE(database.find(1).has_value());
+    EXPECT_FALSE(database.hasSecretPhrase());
+    EXPECT_FALSE(database.verifySecretPhrase(""));
+}
+
+TEST_F(CredentialDatabaseTest, SecretPhraseIsVerified) {
+    CredentialDatabase::write(databaseFile, {}, "open sesame", 10);
+    const CredentialDatabase database(databaseFile);
+    EXPECT_TRUE(database.hasSecretPhrase());
+    EXPECT_TRUE(database.verifySecretPhrase("open sesame"));
+    EXPECT_FALSE(database.verifySecretPhrase("open sesame!"));
+}
+
+TEST_F(CredentialDatabaseTest, DuplicateClientIdsAreRejected) {
+    const auto entry = CredentialDatabase::makeEntry(1, "hub", 10);
+    EXPECT_THROW(CredentialDatabase::write(databaseFile, {entry, entry}, "", 10), std::invalid_argument);
+}
+
+TEST_F(CredentialDatabaseTest, MissingOrMalformedFilesThrow) {
+    EXPECT_THROW(CredentialDatabase{"missing_credentials.db"}, std::runtime_error);
+
+    std::ofstream(databaseFile) << "this is not a credential database, just some text long enough for a header";
+    EXPECT_THROW(CredentialDatabase{databaseFile}, std::runtime_error);
+}
+
+TEST_F(CredentialDatabaseTest, TruncatedFileThrows) {
+    CredentialDatabase::write(databaseFile, {CredentialDatabase::makeEntry(1, "hub", 10)}, "", 10);
+    ASSERT_EQ(truncate(databaseFile.c_str(), 100), 0);
+    EXPECT_THROW(CredentialDatabase{databaseFile}, std::runtime_error);
+}
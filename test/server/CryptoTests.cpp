@@ -0,0 +1,58 @@
+#include "server/Crypto.hpp"
+#include <gtest/gtest.h>
+
+class CryptoTest : public ::testing::Test {
+protected:
+    static std::string hex(const Crypto::Sha256Digest& digest) {
+        return Crypto::toHex(std::string_view(reinterpret_cast<const char*>(digest.data()), digest.size()));
+    }
+};
+
+TEST_F(CryptoTest, Sha256KnownVectors) {
+    EXPECT_EQ(hex(Crypto::sha256("")), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    EXPECT_EQ(hex(Crypto::sha256("abc")), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(hex(Crypto::sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+TEST_F(CryptoTest, Sha256IncrementalMatchesOneShot) {
+    const std::string data(1000, 'a');
+    Crypto::Sha256 hasher;
+    for (std::size_t i = 0; i < data.size(); i += 7) {
+        hasher.update(std::string_view(data).substr(i, 7));
+    }
+    EXPECT_EQ(hasher.finish(), Crypto::sha256(data));
+}
+
+TEST_F(CryptoTest, HmacSha256Rfc4231) {
+    const Crypto::HmacSha256 mac("Jefe");
+    EXPECT_EQ(hex(mac.compute("what do ya want for nothing?")),
+              "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+    const Crypto::HmacSha256 longKey(std::string(131, '\xaa'));
+    EXPECT_EQ(hex(longKey.compute("Test Using Larger Than Block-Size Key - Hash Key First")),
+              "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+}
+
+TEST_F(CryptoTest, Pbkdf2Sha256KnownVectors) {
+    EXPECT_EQ(Crypto::toHex(Crypto::pbkdf2Sha256("password", "salt", 1, 32)),
+              "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b");
+    EXPECT_EQ(Crypto::toHex(Crypto::pbkdf2Sha256("password", "salt", 4096, 32)),
+              "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a");
+    EXPECT_EQ(Crypto::pbkdf2Sha256("password", "salt", 2, 40).size(), 40);
+}
+
+TEST_F(CryptoTest, HexRoundTrip) {
+    const std::string bytes = Crypto::randomBytes(16);
+    std::string decoded;
+    ASSERT_TRUE(Crypto::fromHex(Crypto::toHex(bytes), decoded));
+    EXPECT_EQ(decoded, bytes);
+    EXPECT_FALSE(Crypto::fromHex("abc", decoded));
+    EXPECT_FALSE(Crypto::fromHex("zz", decoded));
+}
+
+TEST_F(CryptoTest, ConstantTimeEquals) {
+    EXPECT_TRUE(Crypto::constantTimeEquals("secret", "secret"));
+    EXPECT_FALSE(Crypto::constantTimeEquals("secret", "secreT"));
+    EXPECT_FALSE(Crypto::constantTimeEquals("secret", "secrets"));
+}
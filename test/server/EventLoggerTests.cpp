@@ -2,7 +2,11 @@
 #include <gtest/gtest.h>
 #include <fstream>
 #include <sstream>
+#include <cctype>
+#include <csignal>
 #include <cstdio>
+#include <thread>
+#include <vector>
 
 class EventLoggerTest : public ::testing::Test {
 protected:
@@ -39,6 +43,7 @@ TEST_F(EventLoggerTest, ConstructorFailsWithInvalidPath) {
 TEST_F(EventLoggerTest, LogEventWritesExpectedOutput) {
     EventLogger logger(logFile);
     logger.logEvent("TestComponent", EventLogger::INFO, "Hello world!");
+    logger.flush();
     std::string last = getLastLogEntry();
     EXPECT_NE(last.find("[TestComponent]"), std::string::npos);
     EXPECT_NE(last.find("[INFO]"), std::string::npos);
@@ -48,6 +53,7 @@ TEST_F(EventLoggerTest, LogEventWritesExpectedOutput) {
 TEST_F(EventLoggerTest, LogIncludesFormattedTimestamp) {
     EventLogger logger(logFile);
     logger.logEvent("X", EventLogger::INFO, "msg");
+    logger.flush();
     std::string last = getLastLogEntry();
     ASSERT_GE(last.size(), 20);
     EXPECT_EQ(last[0], '[');
@@ -63,10 +69,12 @@ TEST_F(EventLoggerTest, LogsAllLevelsCorrectly) {
     EventLogger logger(logFile);
     logger.logEvent("X", EventLogger::INFO, "info msg");
     logger.logEvent("X", EventLogger::WARNING, "warn msg");
+    logger.flush();
     std::string last = getLastLogEntry();
     EXPECT_NE(last.find("warn msg"), std::string::npos);
     EXPECT_NE(last.find("[WARNING]"), std::string::npos);
     logger.logEvent("X", EventLogger::ERROR, "error msg");
+    logger.flush();
     last = getLastLogEntry();
     EXPECT_NE(last.find("error msg"), std::string::npos);
     EXPECT_NE(last.find("[ERROR]"), std::string::npos);
@@ -75,7 +83,220 @@ TEST_F(EventLoggerTest, LogsAllLevelsCorrectly) {
 TEST_F(EventLoggerTest, HandlesEmptyComponentAndMessage) {
     EventLogger logger(logFile);
     logger.logEvent("", EventLogger::WARNING, "");
+    logger.flush();
     std::string last = getLastLogEntry();
     EXPECT_NE(last.find("[]"), std::string::npos);
     EXPECT_NE(last.find("[WARNING]"), std::string::npos);
 }
+
+TEST_F(EventLoggerTest, FlushWritesAllPendingRecords) {
+    EventLogger logger(logFile);
+    for (int i = 0; i < 100; ++i) {
+        logger.logEvent("X", EventLogger::INFO, "record " + std::to_string(i));
+    }
+    logger.flush();
+
+    std::ifstream file(logFile);
+    std::string line;
+    int count = 0;
+    while (std::getline(file, line)) count++;
+    EXPECT_EQ(count, 100);
+    EXPECT_NE(getLastLogEntry().find("record 99"), std::string::npos);
+}
+
+TEST_F(EventLoggerTest, DestructorWritesPendingRecords) {
+    {
+        EventLogger logger(logFile);
+        logger.logEvent("X", EventLogger::ERROR, "last words");
+    }
+    EXPECT_NE(getLastLogEntry().find("last words"), std::string::npos);
+}
+
+TEST_F(EventLoggerTest, ConcurrentProducersLoseNoRecords) {
+    EventLogger::Config config;
+    config.ringCapacity = 64;
+    EventLogger logger(logFile, config);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&logger, t] {
+            for (int i = 0; i < 500; ++i) {
+                logger.logEvent("T" + std::to_string(t), EventLogger::INFO, "msg");
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    logger.flush();
+
+    std::ifstream file(logFile);
+    std::string line;
+    int count = 0;
+    while (std::getline(file, line)) {
+        EXPECT_NE(line.find("] [INFO] msg"), std::string::npos);
+        count++;
+    }
+    EXPECT_EQ(count, 2000);
+}
+
+TEST_F(EventLoggerTest, MillisecondPrecisionTimestamp) {
+    EventLogger::Config config;
+    config.precision = EventLogger::TimestampPrecision::MILLISECONDS;
+    EventLogger logger(logFile, config);
+    logger.logEvent("X", EventLogger::INFO, "msg");
+    logger.flush();
+
+    std::string last = getLastLogEntry();
+    ASSERT_GE(last.size(), 25);
+    EXPECT_EQ(last[20], '.');
+    EXPECT_TRUE(std::isdigit(static_cast<unsigned char>(last[23])));
+    EXPECT_EQ(last[24], ']');
+}
+
+TEST_F(EventLoggerTest, MicrosecondPrecisionTimestamp) {
+    EventLogger::Config config;
+    config.precision = EventLogger::TimestampPrecision::MICROSECONDS;
+    EventLogger logger(logFile, config);
+    logger.logEvent("X", EventLogger::INFO, "msg");
+    logger.flush();
+
+    std::string last = getLastLogEntry();
+    ASSERT_GE(last.size(), 28);
+    EXPECT_EQ(last[20], '.');
+    EXPECT_EQ(last[27], ']');
+    EXPECT_NE(last.find("[X] [INFO] msg"), std::string::npos);
+}
+
+TEST_F(EventLoggerTest, StructuredEventRendersPatternInTextMode) {
+    EventLogger logger(logFile);
+    const auto component = logger.registerComponent("Inventory");
+    const auto format = logger.registerFormat("item {} now has {} units ({}%)");
+    logger.logStructured(component, EventLogger::WARNING, format, "bolts", 42, 12.5);
+    logger.flush();
+
+    std::string last = getLastLogEntry();
+    EXPECT_NE(last.find("[Inventory] [WARNING] item bolts now has 42 units (12.5%)"), std::string::npos);
+}
+
+TEST_F(EventLoggerTest, RegistrationReturnsStableIds) {
+    EventLogger logger(logFile);
+    const auto first = logger.registerComponent("A");
+    const auto second = logger.registerComponent("B");
+    EXPECT_NE(first, second);
+    EXPECT_EQ(logger.registerComponent("A"), first);
+    EXPECT_EQ(logger.registerFormat("{} {}"), logger.registerFormat("{} {}"));
+}
+
+TEST_F(EventLoggerTest, DebugIsFilteredByDefault) {
+    EventLogger logger(logFile);
+    logger.logEvent("X", EventLogger::DEBUG, "hidden");
+    logger.logEvent("X", EventLogger::INFO, "shown");
+    logger.flush();
+
+    std::ifstream file(logFile);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(contents.str().find("hidden"), std::string::npos);
+    EXPECT_NE(contents.str().find("shown"), std::string::npos);
+}
+
+TEST_F(EventLoggerTest, SetLevelChangesFilterAtRuntime) {
+    EventLogger logger(logFile);
+    logger.setLevel(EventLogger::DEBUG);
+    logger.logEvent("X", EventLogger::DEBUG, "trace");
+    logger.flush();
+    EXPECT_NE(getLastLogEntry().find("[DEBUG] trace"), std::string::npos);
+
+    logger.setLevel(EventLogger::ERROR);
+    logger.logEvent("X", EventLogger::WARNING, "dropped");
+    logger.flush();
+    EXPECT_EQ(getLastLogEntry().find("dropped"), std::string::npos);
+}
+
+TEST_F(EventLoggerTest, ComponentLevelOverridesGlobalLevel) {
+    EventLogger logger(logFile);
+    logger.setComponentLevel("Noisy", EventLogger::ERROR);
+    logger.setComponentLevel("Traced", EventLogger::DEBUG);
+
+    EXPECT_FALSE(logger.isEnabled("Noisy", EventLogger::WARNING));
+    EXPECT_TRUE(logger.isEnabled("Other", EventLogger::WARNING));
+    EXPECT_TRUE(logger.isEnabled("Traced", EventLogger::DEBUG));
+    EXPECT_FALSE(logger.isEnabled("Other", EventLogger::DEBUG));
+
+    logger.clearComponentLevel("Noisy");
+    EXPECT_TRUE(logger.isEnabled("Noisy", EventLogger::WARNING));
+}
+
+TEST_F(EventLoggerTest, ComponentLevelChangesApplyToResolvedNames) {
+    EventLogger logger(logFile);
+    logger.setComponentLevel("Traced", EventLogger::DEBUG);
+    EXPECT_TRUE(logger.isEnabled("Late", EventLogger::INFO));
+
+    logger.setComponentLevel("Late", EventLogger::ERROR);
+    EXPECT_FALSE(logger.isEnabled("Late", EventLogger::WARNING));
+    std::thread other([&logger] { EXPECT_FALSE(logger.isEnabled("Late", EventLogger::WARNING)); });
+    other.join();
+
+    EventLogger second(logFile + ".2");
+    second.setComponentLevel("Traced", EventLogger::DEBUG);
+    EXPECT_TRUE(second.isEnabled("Late", EventLogger::WARNING));
+    std::remove((logFile + ".2").c_str());
+}
+
+static int evaluations = 0;
+
+static int countedArgument() {
+    return ++evaluations;
+}
+
+TEST_F(EventLoggerTest, MacroSkipsArgumentsWhenFiltered) {
+    EventLogger logger(logFile);
+    const auto component = logger.registerComponent("X");
+    const auto format = logger.registerFormat("value {}");
+    evaluations = 0;
+
+    LOG_EVENT(logger, component, EventLogger::DEBUG, format, countedArgument());
+    EXPECT_EQ(evaluations, 0);
+
+    LOG_EVENT(logger, component, EventLogger::INFO, format, countedArgument());
+    EXPECT_EQ(evaluations, 1);
+    logger.flush();
+    EXPECT_NE(getLastLogEntry().find("value 1"), std::string::npos);
+}
+
+TEST_F(EventLoggerTest, SignalsSwitchDebugLogging) {
+    EventLogger logger(logFile);
+    EventLogger::enableSignalControl(&logger);
+
+    raise(SIGUSR1);
+    EXPECT_EQ(logger.getLevel(), EventLogger::DEBUG);
+    raise(SIGUSR2);
+    EXPECT_EQ(logger.getLevel(), EventLogger::INFO);
+
+    EventLogger::enableSignalControl(nullptr);
+}
+
+TEST_F(EventLoggerTest, RotationKeepsRecordsWhole) {
+    EventLogger::Config config;
+    config.rotateBytes = RotatingLogFileConstants::MIN_SEGMENT_BYTES;
+    config.keepSegments = 10;
+    const int records = 5000;
+    {
+        EventLogger logger(logFile, config);
+        for (int i = 0; i < records; ++i) {
+            logger.logEvent("Rotation", EventLogger::INFO, "record number " + std::to_string(i));
+        }
+    }
+
+    int lines = 0;
+    for (int segment = 0; segment <= 10; ++segment) {
+        const std::string path = segment == 0 ? logFile : logFile + "." + std::to_string(segment);
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            EXPECT_NE(line.find("[Rotation] [INFO] record number"), std::string::npos);
+            lines++;
+        }
+        if (segment > 0) std::remove(path.c_str());
+    }
+    EXPECT_EQ(lines, records);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "server/AsyncTask.hpp"
+#include "server/EventLoop.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <thread>
+
+class EventLoopTest : public ::testing::Test {
+protected:
+    EventLoop loop;
+    int pipeFds[2]{-1, -1};
+
+    void SetUp() override {
+        ASSERT_EQ(pipe(pipeFds), 0);
+    }
+
+    void TearDown() override {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+    }
+};
+
+TEST_F(EventLoopTest, PostedCallbackRunsOnLoop) {
+    bool ran = false;
+    loop.post([&] { ran = true; });
+
+    EXPECT_FALSE(ran);
+    EXPECT_EQ(loop.runOnce(0), 1);
+    EXPECT_TRUE(ran);
+}
+
+TEST_F(EventLoopTest, WatchedDescriptorInvokesHandler) {
+    std::uint32_t reported = 0;
+    ASSERT_TRUE(loop.watch(pipeFds[0], EPOLLIN, [&](std::uint32_t events) { reported = events; }));
+
+    ASSERT_EQ(write(pipeFds[1], "x", 1), 1);
+    loop.runOnce(100);
+    EXPECT_TRUE(reported & EPOLLIN);
+
+    loop.unwatch(pipeFds[0]);
+    reported = 0;
+    loop.runOnce(0);
+    EXPECT_EQ(reported, 0);
+}
+
+TEST_F(EventLoopTest, StopFromAnotherThreadEndsRun) {
+    std::thread runner([&] { loop.run(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    loop.stop();
+    runner.join();
+    SUCCEED();
+}
+
+static AsyncTask resumeOnLoop(EventLoop& loop, bool& onLoopThread) {
+    co_await loop.schedule();
+    onLoopThread = loop.isInLoopThread();
+}
+
+TEST_F(EventLoopTest, CoroutineResumesOnLoopThread) {
+    bool onLoopThread = false;
+    resumeOnLoop(loop, onLoopThread);
+    EXPECT_FALSE(onLoopThread);
+
+    loop.runOnce(0);
+    EXPECT_TRUE(onLoopThread);
+}
+
+static AsyncTask readWhenReady(EventLoop& loop, int fd, char& received) {
+    std::uint32_t events = co_await loop.readable(fd);
+    if (events & EPOLLIN) {
+        EXPECT_EQ(read(fd, &received, 1), 1);
+    }
+}
+
+TEST_F(EventLoopTest, CoroutineAwaitsReadableDescriptor) {
+    char received = 0;
+    readWhenReady(loop, pipeFds[0], received);
+    loop.runOnce(0);
+    EXPECT_EQ(received, 0);
+
+    ASSERT_EQ(write(pipeFds[1], "y", 1), 1);
+    loop.runOnce(100);
+    EXPECT_EQ(received, 'y');
+}
+
+TEST_F(EventLoopTest, AwaitedEventsLeaveOtherWatchersInPlace) {
+    ASSERT_TRUE(loop.watch(pipeFds[0], EPOLLOUT, [](std::uint32_t) {}));
+    char received = 0;
+    readWhenReady(loop, pipeFds[0], received);
+    loop.runOnce(0);
+
+    ASSERT_EQ(write(pipeFds[1], "w", 1), 1);
+    loop.runOnce(100);
+    EXPECT_EQ(received, 'w');
+    EXPECT_TRUE(loop.watch(pipeFds[0], EPOLLIN, [](std::uint32_t) {}));
+    EXPECT_FALSE(loop.watch(pipeFds[0], EPOLLOUT, [](std::uint32_t) {}));
+    loop.unwatch(pipeFds[0]);
+}
+
+TEST_F(EventLoopTest, StopBeforeRunIsNotLost) {
+    loop.stop();
+    std::thread runner([&] { loop.run(); });
+    runner.join();
+    SUCCEED();
+}
+
+TEST_F(EventLoopTest, ReaderAndWriterShareDescriptor) {
+    int pair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    int reads = 0;
+    int writes = 0;
+    ASSERT_TRUE(loop.watch(pair[0], EPOLLIN, [&](std::uint32_t) { reads++; }));
+    ASSERT_TRUE(loop.watch(pair[0], EPOLLOUT, [&](std::uint32_t) { writes++; }));
+    EXPECT_FALSE(loop.watch(pair[0], EPOLLIN, [](std::uint32_t) {}));
+
+    ASSERT_EQ(write(pair[1], "z", 1), 1);
+    loop.runOnce(100);
+    EXPECT_EQ(reads, 1);
+    EXPECT_EQ(writes, 1);
+
+    loop.unwatch(pair[0], EPOLLOUT);
+    loop.runOnce(100);
+    EXPECT_EQ(reads, 2);
+    EXPECT_EQ(writes, 1);
+
+    loop.unwatch(pair[0]);
+    EXPECT_EQ(loop.runOnce(0), 0);
+    close(pair[0]);
+    close(pair[1]);
+}
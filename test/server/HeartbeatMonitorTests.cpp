@@ -0,0 +1,96 @@
+#include "server/HeartbeatMonitor.hpp"
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+class HeartbeatMonitorTest : public ::testing::Test {
+protected:
+    static HeartbeatMonitor::Options options() {
+        HeartbeatMonitor::Options result;
+        result.interval = 1s;
+        result.missedLimit = 2;
+        return result;
+    }
+
+    TimerWheel::Clock::time_point start = TimerWheel::Clock::now();
+    NetworkManager network;
+    HeartbeatMonitor monitor{&network, options(), start};
+
+    static Message pong(int clientID, double sequence) {
+        cJSON* content = cJSON_CreateObject();
+        cJSON_AddNumberToObject(content, "seq", sequence);
+        return {clientID, MessageType::HEARTBEAT, HeartbeatSubType::PONG, content};
+    }
+};
+
+TEST_F(HeartbeatMonitorTest, InvalidOptionsThrow) {
+    HeartbeatMonitor::Options invalid = options();
+    invalid.missedLimit = 0;
+    EXPECT_THROW(HeartbeatMonitor(&network, invalid, start), std::invalid_argument);
+}
+
+TEST_F(HeartbeatMonitorTest, PingsRegisteredClientsEveryInterval) {
+    monitor.registerClient(1, start);
+    monitor.registerClient(1, start + 500ms);
+
+    EXPECT_EQ(monitor.tick(start + 900ms), 0);
+    EXPECT_EQ(monitor.tick(start + 1s), 1);
+    ASSERT_TRUE(monitor.handlePong(1, pong(1, 1), start + 1s + 20ms));
+    EXPECT_EQ(monitor.tick(start + 2s), 1);
+}
+
+TEST_F(HeartbeatMonitorTest, PongsAreTimedIntoTheHistogram) {
+    monitor.registerClient(1, start);
+    ASSERT_EQ(monitor.tick(start + 1s), 1);
+
+    EXPECT_FALSE(monitor.handlePong(1, pong(1, 7), start + 1s + 10ms));
+    EXPECT_TRUE(monitor.handlePong(1, pong(1, 1), start + 1s + 40ms));
+    EXPECT_FALSE(monitor.handlePong(1, pong(1, 1), start + 1s + 50ms));
+
+    const LatencyHistogram* rtt = monitor.getRttHistogram(1);
+    ASSERT_NE(rtt, nullptr);
+    EXPECT_EQ(rtt->getCount(), 1);
+    EXPECT_EQ(rtt->getMax(), 40ms);
+}
+
+TEST_F(HeartbeatMonitorTest, SilentClientsAreDeclaredDead) {
+    monitor.registerClient(1, start);
+    EXPECT_EQ(monitor.tick(start + 1s), 1);
+    EXPECT_EQ(monitor.tick(start + 2s), 1);
+    EXPECT_EQ(monitor.tick(start + 3s), 0);
+
+    EXPECT_EQ(monitor.getDeadClients(), 1);
+    EXPECT_EQ(monitor.getRttHistogram(1), nullptr);
+}
+
+TEST_F(HeartbeatMonitorTest, RemovedClientsAreNotPinged) {
+    monitor.registerClient(1, start);
+    monitor.removeClient(1);
+    EXPECT_EQ(monitor.tick(start + 5s), 0);
+}
+
+TEST_F(HeartbeatMonitorTest, MakePongEchoesThePing) {
+    cJSON* content = cJSON_CreateObject();
+    cJSON_AddNumberToObject(content, "seq", 3);
+    const Message ping(4, MessageType::HEARTBEAT, HeartbeatSubType::PING, content);
+
+    const Message answer = HeartbeatMonitor::makePong(ping);
+    EXPECT_EQ(answer.getClientID(), 4);
+    EXPECT_EQ(answer.getType(), MessageType::HEARTBEAT);
+    EXPECT_EQ(answer.getSubType(), static_cast<int>(HeartbeatSubType::PONG));
+    EXPECT_EQ(cJSON_GetObjectItem(answer.getContentRO(), "seq")->valueint, 3);
+}
+
+TEST_F(HeartbeatMonitorTest, ExportsHistogramsByClient) {
+    monitor.registerClient(2, start);
+    ASSERT_EQ(monitor.tick(start + 1s), 1);
+    ASSERT_TRUE(monitor.handlePong(2, pong(2, 1), start + 1s + 3ms));
+
+    cJSON* exported = cJSON_Parse(monitor.exportRttHistograms().c_str());
+    ASSERT_NE(exported, nullptr);
+    cJSON* client = cJSON_GetObjectItem(exported, "2");
+    ASSERT_NE(client, nullptr);
+    EXPECT_EQ(cJSON_GetObjectItem(client, "count")->valueint, 1);
+    EXPECT_EQ(cJSON_GetObjectItem(client, "missed")->valueint, 0);
+    cJSON_Delete(exported);
+}
@@ -1,5 +1,8 @@
 #include "gtest/gtest.h"
 #include "server/InventoryManager.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 class InventoryManagerTest : public ::testing::Test {
 protected:
@@ -72,3 +75,37 @@ TEST_F(InventoryManagerTest, DecreaseStock_ItemDoesNotExist) {
 TEST_F(InventoryManagerTest, GetStockLevel_ItemNotPresent) {
     EXPECT_EQ(inventory.getStockLevel(999), 0);
 }
+
+TEST_F(InventoryManagerTest, SaveSnapshotWritesAllInventories) {
+    const std::string path = "inventory_snapshot_test.json";
+    cJSON* initialInventory = cJSON_CreateObject();
+    cJSON_AddNumberToObject(initialInventory, "3", 10);
+    inventory.addClient(1, initialInventory);
+    cJSON_Delete(initialInventory);
+
+    ASSERT_TRUE(inventory.saveSnapshot(path));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(contents.str(), R"({"global":{"3":10},"clients":{"1":{"3":10}}})");
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(inventory.saveSnapshot("/nonexistent/dir/snapshot.json"));
+}
+
+TEST_F(InventoryManagerTest, TransactionHistoryIsPerClientAndBounded) {
+    inventory.logTransaction(1, 5, "1");
+    inventory.logTransaction(2, 3, "2");
+    inventory.logTransaction(3, 7, "1");
+
+    const std::vector<InventoryManager::Transaction> history = inventory.getTransactionHistory("1");
+    ASSERT_EQ(history.size(), 2);
+    EXPECT_EQ(history[0].itemID, 1);
+    EXPECT_EQ(history[1].quantity, 7);
+
+    for (std::size_t i = 0; i < InventoryConstants::MAX_TRANSACTIONS; ++i) {
+        inventory.logTransaction(4, 1, "2");
+    }
+    EXPECT_TRUE(inventory.getTransactionHistory("1").empty());
+    EXPECT_EQ(inventory.getTransactionHistory("2").size(), InventoryConstants::MAX_TRANSACTIONS);
+}
@@ -0,0 +1,53 @@
+#include "server/LatencyHistogram.hpp"
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+class LatencyHistogramTest : public ::testing::Test {
+protected:
+    LatencyHistogram histogram;
+};
+
+TEST_F(LatencyHistogramTest, EmptyHistogramReportsZero) {
+    EXPECT_EQ(histogram.getCount(), 0);
+    EXPECT_EQ(histogram.getMean(), 0us);
+    EXPECT_EQ(histogram.getPercentile(0.99), 0us);
+}
+
+TEST_F(LatencyHistogramTest, SamplesFallInPowerOfTwoBuckets) {
+    histogram.record(0us);
+    histogram.record(1us);
+    histogram.record(3us);
+    histogram.record(1000us);
+    histogram.record(-5us);
+
+    const auto& buckets = histogram.getBuckets();
+    EXPECT_EQ(buckets[0], 2);
+    EXPECT_EQ(buckets[1], 1);
+    EXPECT_EQ(buckets[2], 1);
+    EXPECT_EQ(buckets[10], 1);
+    EXPECT_EQ(histogram.getCount(), 5);
+    EXPECT_EQ(histogram.getMin(), 0us);
+    EXPECT_EQ(histogram.getMax(), 1000us);
+    EXPECT_EQ(histogram.getMean(), 200us);
+}
+
+TEST_F(LatencyHistogramTest, PercentilesUseBucketUpperBounds) {
+    for (int i = 0; i < 98; ++i) histogram.record(100us);
+    histogram.record(5000us);
+    histogram.record(9000us);
+
+    EXPECT_EQ(histogram.getPercentile(0.5), 127us);
+    EXPECT_EQ(histogram.getPercentile(0.99), 8191us);
+    EXPECT_EQ(histogram.getPercentile(1.0), 9000us);
+}
+
+TEST_F(LatencyHistogramTest, ExportsSummaryAndBuckets) {
+    histogram.record(100us);
+    cJSON* json = histogram.toJSON();
+
+    EXPECT_EQ(cJSON_GetObjectItem(json, "count")->valueint, 1);
+    EXPECT_EQ(cJSON_GetObjectItem(json, "p99Us")->valueint, 100);
+    EXPECT_EQ(cJSON_GetArraySize(cJSON_GetObjectItem(json, "buckets")), 8);
+    cJSON_Delete(json);
+}
@@ -0,0 +1,165 @@
+#include "server/LogDecoder.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+class LogDecoderTest : public ::testing::Test {
+protected:
+    std::string logFile = "test_binary_log.bin";
+    EventLogger::Config config;
+
+    void SetUp() override {
+        std::remove(logFile.c_str());
+        config.format = EventLogger::Format::BINARY;
+    }
+
+    void TearDown() override {
+        std::remove(logFile.c_str());
+    }
+
+    std::string readFile() {
+        std::ifstream file(logFile, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+};
+
+TEST_F(LogDecoderTest, DecodesTextAndStructuredEvents) {
+    {
+        EventLogger logger(logFile, config);
+        logger.logEvent("Server", EventLogger::INFO, "started");
+        const auto component = logger.registerComponent("Inventory");
+        const auto format = logger.registerFormat("item {} moved to hub {}");
+        logger.logStructured(component, EventLogger::ERROR, format, "crate", -7);
+    }
+
+    std::ifstream in(logFile, std::ios::binary);
+    std::ostringstream out;
+    LogDecoder decoder;
+    ASSERT_TRUE(decoder.decode(in, out));
+    EXPECT_EQ(decoder.getDecodedEvents(), 2);
+
+    std::istringstream lines(out.str());
+    std::string first, second;
+    std::getline(lines, first);
+    std::getline(lines, second);
+    EXPECT_EQ(first[0], '[');
+    EXPECT_EQ(first[20], ']');
+    EXPECT_EQ(first.substr(21), " [Server] [INFO] started");
+    EXPECT_EQ(second.substr(21), " [Inventory] [ERROR] item crate moved to hub -7");
+}
+
+TEST_F(LogDecoderTest, BinaryModeDoesNotWriteMessageText) {
+    {
+        EventLogger logger(logFile, config);
+        const auto component = logger.registerComponent("Net");
+        const auto format = logger.registerFormat("client {} connected");
+        for (int i = 0; i < 100; ++i) {
+            logger.logStructured(component, EventLogger::INFO, format, i);
+        }
+    }
+
+    const std::string contents = readFile();
+    EXPECT_EQ(contents.find("connected"), contents.rfind("connected"));
+    EXPECT_EQ(contents.find("[INFO]"), std::string::npos);
+}
+
+TEST_F(LogDecoderTest, DecodesAppendedSessions) {
+    for (int session = 0; session < 2; ++session) {
+        EventLogger logger(logFile, config);
+        logger.logEvent(session == 0 ? "First" : "Second", EventLogger::INFO, "hello");
+    }
+
+    std::ifstream in(logFile, std::ios::binary);
+    std::ostringstream out;
+    LogDecoder decoder;
+    ASSERT_TRUE(decoder.decode(in, out));
+    EXPECT_EQ(decoder.getDecodedEvents(), 2);
+    EXPECT_NE(out.str().find("[First] [INFO] hello"), std::string::npos);
+    EXPECT_NE(out.str().find("[Second] [INFO] hello"), std::string::npos);
+}
+
+TEST_F(LogDecoderTest, RejectsTextLog) {
+    std::istringstream in("[2024-01-01 00:00:00] [X] [INFO] msg\n");
+    std::ostringstream out;
+    LogDecoder decoder;
+    EXPECT_FALSE(decoder.decode(in, out));
+    EXPECT_TRUE(out.str().empty());
+}
+
+TEST_F(LogDecoderTest, StopsAtTruncatedRecord) {
+    {
+        EventLogger logger(logFile, config);
+        logger.logEvent("X", EventLogger::INFO, "complete");
+        logger.logEvent("X", EventLogger::INFO, "cut short");
+    }
+    std::string contents = readFile();
+    contents.resize(contents.size() - 3);
+
+    std::istringstream in(contents);
+    std::ostringstream out;
+    LogDecoder decoder;
+    EXPECT_FALSE(decoder.decode(in, out));
+    EXPECT_EQ(decoder.getDecodedEvents(), 1);
+    EXPECT_NE(out.str().find("complete"), std::string::npos);
+}
+
+TEST_F(LogDecoderTest, CorruptLengthDoesNotAllocateIt) {
+    {
+        EventLogger logger(logFile, config);
+        logger.logEvent("X", EventLogger::INFO, "before");
+    }
+    std::string contents = readFile();
+    contents.push_back(static_cast<char>(BinaryLog::RecordKind::EVENT));
+    contents.append(4, '\xFF');
+    contents.append("short");
+
+    std::istringstream in(contents);
+    std::ostringstream out;
+    LogDecoder decoder;
+    EXPECT_FALSE(decoder.decode(in, out));
+    EXPECT_EQ(decoder.getDecodedEvents(), 1);
+}
+
+TEST_F(LogDecoderTest, RotatedSegmentsDecodeOnTheirOwn) {
+    config.rotateBytes = RotatingLogFileConstants::MIN_SEGMENT_BYTES;
+    config.keepSegments = 10;
+    {
+        EventLogger logger(logFile, config);
+        const auto component = logger.registerComponent("Net");
+        const auto format = logger.registerFormat("packet {} from hub {}");
+        for (int i = 0; i < 10000; ++i) {
+            logger.logStructured(component, EventLogger::INFO, format, i, "north");
+        }
+    }
+
+    std::size_t total = 0;
+    for (int segment = 0; segment <= 10; ++segment) {
+        const std::string path = segment == 0 ? logFile : logFile + "." + std::to_string(segment);
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) continue;
+        std::ostringstream out;
+        LogDecoder decoder;
+        EXPECT_TRUE(decoder.decode(in, out)) << path;
+        total += decoder.getDecodedEvents();
+        if (segment > 0) std::remove(path.c_str());
+    }
+    EXPECT_EQ(total, 10000);
+}
+
+TEST_F(LogDecoderTest, DecodesTheActiveSegment) {
+    config.rotateBytes = RotatingLogFileConstants::MIN_SEGMENT_BYTES;
+    EventLogger logger(logFile, config);
+    const auto component = logger.registerComponent("Net");
+    const auto format = logger.registerFormat("packet {} from hub {}");
+    for (int i = 0; i < 10; ++i) {
+        logger.logStructured(component, EventLogger::INFO, format, i, "north");
+    }
+    logger.flush();
+
+    std::ifstream in(logFile, std::ios::binary);
+    std::ostringstream out;
+    LogDecoder decoder;
+    EXPECT_TRUE(decoder.decode(in, out));
+    EXPECT_EQ(decoder.getDecodedEvents(), 10);
+}
@@ -0,0 +1,159 @@
+#include "server/MessageDispatcher.hpp"
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class MessageDispatcherTest : public ::testing::Test {
+protected:
+    static Authentication::Config fastConfig() {
+        Authentication::Config config;
+        config.kdfIterations = 1000;
+        return config;
+    }
+
+    Authentication auth{fastConfig()};
+    MessageDispatcher dispatcher{nullptr};
+
+    void SetUp() override {
+        auth.addCredentials(1, "password123");
+        dispatcher.setAuthentication(&auth);
+    }
+
+    static Message* makeLogin(int clientID, const char* field, const std::string& value) {
+        cJSON* content = cJSON_CreateObject();
+        cJSON_AddStringToObject(content, field, value.c_str());
+        return new Message(clientID, MessageType::CREDENTIALS, CredentialSubType::LOGIN, content);
+    }
+};
+
+TEST_F(MessageDispatcherTest, PasswordLoginAuthorizesClient) {
+    dispatcher.ProcessReceivedMessage(makeLogin(1, "password", "password123"));
+    EXPECT_TRUE(auth.isAuthorized(1));
+}
+
+TEST_F(MessageDispatcherTest, WrongPasswordLoginIsDenied) {
+    dispatcher.ProcessReceivedMessage(makeLogin(1, "password", "wrong"));
+    EXPECT_FALSE(auth.isAuthorized(1));
+}
+
+TEST_F(MessageDispatcherTest, TokenLoginSkipsPasswordCheck) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string token = auth.issueSessionToken(1);
+    const std::size_t evaluations = auth.getKdfEvaluations();
+
+    dispatcher.ProcessReceivedMessage(makeLogin(1, "token", token));
+    EXPECT_TRUE(auth.isAuthorized(1));
+    EXPECT_EQ(auth.getKdfEvaluations(), evaluations);
+}
+
+TEST_F(MessageDispatcherTest, TokenLoginResumesOnANewConnection) {
+    dispatcher.ProcessReceivedMessage(makeLogin(1, "password", "password123"));
+    const std::string token = auth.issueSessionToken(1);
+    ASSERT_FALSE(token.empty());
+
+    // The same slot under a later generation, as the connection table hands out after a reconnect.
+    const int reconnected = (1 << 16) | 1;
+    dispatcher.ProcessReceivedMessage(makeLogin(reconnected, "token", token));
+    EXPECT_TRUE(auth.isAuthorized(reconnected));
+    EXPECT_FALSE(auth.isAuthorized(1));
+}
+
+TEST_F(MessageDispatcherTest, LogoutRevokesSession) {
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    const std::string token = auth.issueSessionToken(1);
+
+    dispatcher.ProcessReceivedMessage(new Message(1, MessageType::CREDENTIALS, CredentialSubType::LOGOUT, cJSON_CreateObject()));
+    EXPECT_FALSE(auth.isAuthorized(1));
+
+    dispatcher.ProcessReceivedMessage(makeLogin(1, "token", token));
+    EXPECT_FALSE(auth.isAuthorized(1));
+}
+
+TEST_F(MessageDispatcherTest, PongsReachTheHeartbeatMonitor) {
+    const auto start = TimerWheel::Clock::now();
+    HeartbeatMonitor monitor(nullptr, HeartbeatMonitor::Options{}, start);
+    dispatcher.setHeartbeatMonitor(&monitor);
+
+    dispatcher.ProcessReceivedMessage(new Message(1, MessageType::HEARTBEAT, HeartbeatSubType::PING, cJSON_CreateObject()));
+    ASSERT_NE(monitor.getRttHistogram(1), nullptr);
+    ASSERT_EQ(monitor.tick(start + HeartbeatConstants::DEFAULT_INTERVAL + std::chrono::seconds(1)), 1);
+
+    cJSON* content = cJSON_CreateObject();
+    cJSON_AddNumberToObject(content, "seq", 1);
+    dispatcher.ProcessReceivedMessage(new Message(1, MessageType::HEARTBEAT, HeartbeatSubType::PONG, content));
+    EXPECT_EQ(monitor.getRttHistogram(1)->getCount(), 1);
+}
+
+TEST_F(MessageDispatcherTest, TransactionHistoryIsSentInPagesFromTheLoop) {
+    const int port = 20000 + (std::chrono::steady_clock::now().time_since_epoch().count() % 10000);
+    EventLoop loop;
+    NetworkManager manager;
+    manager.initialize(port);
+    InventoryManager inventory;
+    dispatcher.setEventLoop(&loop);
+    dispatcher.setNetworkManager(&manager);
+    dispatcher.setInventoryManager(&inventory);
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+    ASSERT_EQ(connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+    ASSERT_EQ(manager.listenForConnections(1000), 1);
+
+    for (std::size_t i = 0; i <= DispatcherConstants::HISTORY_PAGE_SIZE; ++i) {
+        inventory.logTransaction(static_cast<int>(i), 1, "1");
+    }
+    dispatcher.ProcessReceivedMessage(new Message(1, MessageType::INVENTORY, InventorySubType::HISTORY, cJSON_CreateObject()));
+
+    char buffer[16384];
+    EXPECT_EQ(recv(sockfd, buffer, sizeof(buffer), MSG_DONTWAIT), -1);
+    loop.runOnce(0);
+    ssize_t received = recv(sockfd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    ASSERT_GT(received, 0);
+    EXPECT_NE(std::string(buffer, received).find("\"more\":true"), std::string::npos);
+
+    loop.runOnce(0);
+    received = recv(sockfd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    ASSERT_GT(received, 0);
+    EXPECT_NE(std::string(buffer, received).find("\"more\":false"), std::string::npos);
+    close(sockfd);
+}
+
+TEST_F(MessageDispatcherTest, AlertsFromAuthorizedSendersAreBroadcast) {
+    const int port = 20000 + (std::chrono::steady_clock::now().time_since_epoch().count() % 10000);
+    NetworkManager manager;
+    manager.initialize(port);
+    NotificationSystem notifications(&manager);
+    dispatcher.setNotificationSystem(&notifications);
+
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+    ASSERT_EQ(connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+    ASSERT_EQ(manager.listenForConnections(1000), 1);
+    notifications.registerClient(1);
+
+    auto makeAlert = [] {
+        cJSON* content = cJSON_CreateObject();
+        cJSON_AddStringToObject(content, "message", "storm");
+        return new Message(1, MessageType::ALERT, AlertSubType::WEATHER, content);
+    };
+    char buffer[1024];
+    dispatcher.ProcessReceivedMessage(makeAlert());
+    EXPECT_EQ(recv(sockfd, buffer, sizeof(buffer), MSG_DONTWAIT), -1);
+
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+    dispatcher.ProcessReceivedMessage(makeAlert());
+    const ssize_t received = recv(sockfd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    ASSERT_GT(received, 0);
+    EXPECT_NE(std::string(buffer, received).find("storm"), std::string::npos);
+    close(sockfd);
+}
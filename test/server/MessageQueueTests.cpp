@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "server/MessageQueue.hpp"
+
+#include <thread>
+#include <chrono>
+
+class MessageQueueTest : public ::testing::Test {
+protected:
+    static Message makeRegular(int clientID) {
+        return {clientID, MessageType::INVENTORY, InventorySubType::INFO, cJSON_CreateObject()};
+    }
+
+    static Message makeAlert(int clientID) {
+        return {clientID, MessageType::ALERT, AlertSubType::INFECTION, cJSON_CreateObject()};
+    }
+};
+
+TEST_F(MessageQueueTest, ZeroCapacityThrows) {
+    EXPECT_THROW(MessageQueue(0), std::invalid_argument);
+}
+
+TEST_F(MessageQueueTest, PushAndPopInOrder) {
+    MessageQueue queue(4);
+    EXPECT_EQ(queue.push(makeRegular(1)), MessageQueue::PushResult::ACCEPTED);
+    EXPECT_EQ(queue.push(makeRegular(2)), MessageQueue::PushResult::ACCEPTED);
+
+    EXPECT_EQ(queue.pop()->getClientID(), 1);
+    EXPECT_EQ(queue.pop()->getClientID(), 2);
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST_F(MessageQueueTest, AlertsAreDispatchedFirst) {
+    MessageQueue queue(4);
+    queue.push(makeRegular(1));
+    queue.push(makeAlert(2));
+
+    EXPECT_EQ(queue.pop()->getClientID(), 2);
+    EXPECT_EQ(queue.pop()->getClientID(), 1);
+}
+
+TEST_F(MessageQueueTest, DropOldestShedsRegularMessagesOnly) {
+    MessageQueue queue(2, MessageQueue::OverflowPolicy::DROP_OLDEST);
+    queue.push(makeAlert(1));
+    queue.push(makeRegular(2));
+
+    EXPECT_EQ(queue.push(makeRegular(3)), MessageQueue::PushResult::DROPPED_OLDEST);
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.pop()->getClientID(), 1);
+    EXPECT_EQ(queue.pop()->getClientID(), 3);
+    EXPECT_EQ(queue.getStats().shed, 1);
+}
+
+TEST_F(MessageQueueTest, DropOldestRejectsWhenFullOfAlerts) {
+    MessageQueue queue(1, MessageQueue::OverflowPolicy::DROP_OLDEST);
+    queue.push(makeAlert(1));
+
+    EXPECT_EQ(queue.push(makeRegular(2)), MessageQueue::PushResult::REJECTED);
+    EXPECT_EQ(queue.getStats().rejected, 1);
+}
+
+TEST_F(MessageQueueTest, RejectBusyKeepsQueuedMessages) {
+    MessageQueue queue(1, MessageQueue::OverflowPolicy::REJECT_BUSY);
+    queue.push(makeRegular(1));
+
+    EXPECT_EQ(queue.push(makeRegular(2)), MessageQueue::PushResult::REJECTED);
+    EXPECT_EQ(queue.pop()->getClientID(), 1);
+
+    Message reply = MessageQueue::makeBusyReply(2);
+    EXPECT_EQ(reply.getClientID(), 2);
+    EXPECT_EQ(reply.getType(), MessageType::STATUS);
+    EXPECT_EQ(reply.getSubType(), static_cast<int>(StatusSubType::BUSY));
+}
+
+TEST_F(MessageQueueTest, BlockWaitsForRoom) {
+    MessageQueue queue(1, MessageQueue::OverflowPolicy::BLOCK);
+    queue.push(makeRegular(1));
+
+    std::thread producer([&] {
+        EXPECT_EQ(queue.push(makeRegular(2)), MessageQueue::PushResult::ACCEPTED);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(queue.pop()->getClientID(), 1);
+    producer.join();
+
+    EXPECT_EQ(queue.pop()->getClientID(), 2);
+    EXPECT_EQ(queue.getStats().blockedPushes, 1);
+}
+
+TEST_F(MessageQueueTest, CloseWakesBlockedProducer) {
+    MessageQueue queue(1, MessageQueue::OverflowPolicy::BLOCK);
+    queue.push(makeRegular(1));
+
+    std::thread producer([&] {
+        EXPECT_EQ(queue.push(makeRegular(2)), MessageQueue::PushResult::CLOSED);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    queue.close();
+    producer.join();
+
+    EXPECT_EQ(queue.pop()->getClientID(), 1);
+    EXPECT_FALSE(queue.waitAndPop(std::chrono::milliseconds(10)).has_value());
+}
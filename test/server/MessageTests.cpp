@@ -20,7 +20,7 @@ TEST_F(MessageTest, ConstructorWithoutClientID) {
     EXPECT_EQ(msg.getClientID(), -1);
     EXPECT_EQ(msg.getType(), MessageType::NOTIFICATION);
     EXPECT_EQ(msg.getSubType(), 1);
-    ASSERT_NE(msg.getContent(), nullptr);
+    ASSERT_NE(msg.getContentRO(), nullptr);
 }
 
 TEST_F(MessageTest, ConstructorWithAllFields) {
@@ -28,8 +28,8 @@ TEST_F(MessageTest, ConstructorWithAllFields) {
     EXPECT_EQ(msg.getClientID(), 10);
     EXPECT_EQ(msg.getType(), MessageType::ALERT);
     EXPECT_EQ(msg.getSubType(), 0);
-    ASSERT_NE(msg.getContent(), nullptr);
-    const cJSON* key = cJSON_GetObjectItemCaseSensitive(msg.getContent(), "key");
+    ASSERT_NE(msg.getContentRO(), nullptr);
+    const cJSON* key = cJSON_GetObjectItemCaseSensitive(msg.getContentRO(), "key");
     ASSERT_TRUE(cJSON_IsString(key));
     EXPECT_STREQ(key->valuestring, "value");
 }
@@ -41,7 +41,7 @@ TEST_F(MessageTest, CopyConstructorCreatesDeepCopy) {
     EXPECT_EQ(copy.getClientID(), original.getClientID());
     EXPECT_EQ(copy.getType(), original.getType());
     EXPECT_EQ(copy.getSubType(), original.getSubType());
-    EXPECT_NE(copy.getContent(), original.getContent());
+    EXPECT_NE(copy.getContentRO(), original.getContentRO());
 }
 
 TEST_F(MessageTest, AssignmentOperatorCreatesDeepCopy) {
@@ -52,10 +52,10 @@ TEST_F(MessageTest, AssignmentOperatorCreatesDeepCopy) {
     EXPECT_EQ(copy.getClientID(), original.getClientID());
     EXPECT_EQ(copy.getType(), original.getType());
     EXPECT_EQ(copy.getSubType(), original.getSubType());
-    EXPECT_NE(copy.getContent(), original.getContent());
+    EXPECT_NE(copy.getContentRO(), original.getContentRO());
 
-    const cJSON* originalKey = cJSON_GetObjectItemCaseSensitive(original.getContent(), "key");
-    const cJSON* copyKey = cJSON_GetObjectItemCaseSensitive(copy.getContent(), "key");
+    const cJSON* originalKey = cJSON_GetObjectItemCaseSensitive(original.getContentRO(), "key");
+    const cJSON* copyKey = cJSON_GetObjectItemCaseSensitive(copy.getContentRO(), "key");
     ASSERT_TRUE(cJSON_IsString(originalKey));
     ASSERT_TRUE(cJSON_IsString(copyKey));
     EXPECT_STREQ(originalKey->valuestring, copyKey->valuestring);
@@ -90,7 +90,7 @@ TEST_F(MessageTest, FromJSONStringParsesCorrectly) {
     EXPECT_EQ(msg.getType(), MessageType::NOTIFICATION);
     EXPECT_EQ(msg.getSubType(), 2);
 
-    const cJSON* foo = cJSON_GetObjectItemCaseSensitive(msg.getContent(), "foo");
+    const cJSON* foo = cJSON_GetObjectItemCaseSensitive(msg.getContentRO(), "foo");
     ASSERT_TRUE(cJSON_IsString(foo));
     EXPECT_STREQ(foo->valuestring, "bar");
 }
@@ -104,3 +104,12 @@ TEST_F(MessageTest, FromJSONStringThrowsOnInvalidJson) {
     std::string notJson = "not a json!";
     EXPECT_THROW(Message::fromJSONString(notJson), std::runtime_error);
 }
+
+TEST_F(MessageTest, SharedPayloadMatchesJSONString) {
+    const Message msg(MessageType::ALERT, AlertSubType::WEATHER, testContent);
+    const SharedPayload payload = msg.toSharedPayload();
+
+    ASSERT_NE(payload, nullptr);
+    EXPECT_EQ(*payload, msg.toJSONString());
+    EXPECT_EQ(Message::fromJSONString(*payload).getClientID(), -1);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
+#include "server/AsyncTask.hpp"
 #include "server/NetworkManager.hpp"
+#include "server/NotificationSystem.hpp"
 #include "server/Message.hpp"
 
 #include <thread>
@@ -36,6 +38,23 @@ protected:
         delete testMessage1;
         delete testMessage2;
     }
+
+    int connectTCPClient() {
+        std::thread serverThread([&]() {
+            manager.listenForConnections();
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in serverAddr{};
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr));
+
+        serverThread.join();
+        return sockfd;
+    }
 };
 
 TEST_F(NetworkManagerTest, SendMessageTest) {
@@ -65,8 +84,8 @@ TEST_F(NetworkManagerTest, SendMessageTest) {
 
     std::string received(buffer, bytes);
     auto parsed = Message::fromJSONString(received);
-    EXPECT_STREQ(cJSON_GetObjectItem(parsed.getContent(), "type")->valuestring, "TEST");
-    EXPECT_STREQ(cJSON_GetObjectItem(parsed.getContent(), "content")->valuestring, "Message 1 content");
+    EXPECT_STREQ(cJSON_GetObjectItem(parsed.getContentRO(), "type")->valuestring, "TEST");
+    EXPECT_STREQ(cJSON_GetObjectItem(parsed.getContentRO(), "content")->valuestring, "Message 1 content");
 
     close(sockfd);
     serverThread.join();
@@ -99,8 +118,8 @@ TEST_F(NetworkManagerTest, ReceiveTCPMessageTest) {
 
     auto received = manager.receiveTCPMessage(1);
     ASSERT_TRUE(received.has_value());
-    EXPECT_STREQ(cJSON_GetObjectItem(received->getContent(), "type")->valuestring, "TEST");
-    EXPECT_STREQ(cJSON_GetObjectItem(received->getContent(), "content")->valuestring, "Message 2 content");
+    EXPECT_STREQ(cJSON_GetObjectItem(received->getContentRO(), "type")->valuestring, "TEST");
+    EXPECT_STREQ(cJSON_GetObjectItem(received->getContentRO(), "content")->valuestring, "Message 2 content");
 
     close(sockfd);
     serverThread.join();
@@ -168,7 +187,472 @@ TEST_F(NetworkManagerTest, ReceiveUDPMessageTest) {
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     auto messages = manager.receiveUDPMessage();
     ASSERT_FALSE(messages.empty());
-    EXPECT_STREQ(cJSON_GetObjectItem(messages[0].getContent(), "content")->valuestring, "Message 2 content");
+    EXPECT_STREQ(cJSON_GetObjectItem(messages[0].getContentRO(), "content")->valuestring, "Message 2 content");
+
+    close(sock_fd);
+}
+
+TEST_F(NetworkManagerTest, BroadcastPayloadSkipsUnknownClients) {
+    std::thread serverThread([&]() {
+        manager.listenForConnections();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(sockfd, 0);
+
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+
+    ASSERT_EQ(connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+    serverThread.join();
+
+    cJSON* content = cJSON_CreateObject();
+    cJSON_AddStringToObject(content, "message", "Broadcast");
+    const Message alert(MessageType::ALERT, AlertSubType::WEATHER, content);
+    EXPECT_EQ(manager.broadcastPayload({1, 99}, alert.toSharedPayload()), 1);
+
+    char buffer[1024];
+    ssize_t bytes = recv(sockfd, buffer, sizeof(buffer), 0);
+    ASSERT_GT(bytes, 0);
+
+    auto parsed = Message::fromJSONString(std::string(buffer, bytes));
+    EXPECT_EQ(parsed.getClientID(), -1);
+    EXPECT_STREQ(cJSON_GetObjectItem(parsed.getContentRO(), "message")->valuestring, "Broadcast");
+
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, BroadcastPayloadOnEventLoopReachesUDPClients) {
+    EventLoop loop;
+    manager.setEventLoop(&loop);
+
+    int sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sock_fd, 0);
+
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+
+    std::string json = testMessage2->toJSONString();
+    ASSERT_GT(sendto(sock_fd, json.c_str(), json.size(), 0,
+                     reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto messages = manager.receiveUDPMessage();
+    ASSERT_EQ(messages.size(), 1);
+
+    char buffer[1024];
+    ASSERT_GT(recv(sock_fd, buffer, sizeof(buffer), 0), 0); // Acknowledgement
+
+    cJSON* content = cJSON_CreateObject();
+    cJSON_AddStringToObject(content, "message", "Fan-out");
+    const Message alert(MessageType::ALERT, AlertSubType::INFECTION, content);
+    manager.broadcastPayload({messages[0].getClientID()}, alert.toSharedPayload());
+
+    loop.runOnce(0);
+    loop.runOnce(0);
+
+    ssize_t bytes = recv(sock_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    ASSERT_GT(bytes, 0);
+    auto parsed = Message::fromJSONString(std::string(buffer, bytes));
+    EXPECT_STREQ(cJSON_GetObjectItem(parsed.getContentRO(), "message")->valuestring, "Fan-out");
+
+    close(sock_fd);
+}
+
+TEST_F(NetworkManagerTest, HighWaterMarkRejectsWithBackpressurePolicy) {
+    int sockfd = connectTCPClient();
+    manager.setSlowClientPolicy(NetworkManager::SlowClientPolicy::REJECT);
+    ASSERT_TRUE(manager.setHighWaterMark(1, 10));
+
+    EXPECT_FALSE(manager.sendPayload(1, testMessage1->toSharedPayload()));
+    EXPECT_EQ(manager.getOutboundStats().rejectedMessages, 1);
+
+    ASSERT_TRUE(manager.setHighWaterMark(1, 1 << 20));
+    EXPECT_TRUE(manager.sendPayload(1, testMessage1->toSharedPayload()));
+
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, HighWaterMarkDisconnectsSlowClient) {
+    int sockfd = connectTCPClient();
+    ASSERT_TRUE(manager.setHighWaterMark(1, 10));
+
+    EXPECT_FALSE(manager.sendPayload(1, testMessage1->toSharedPayload()));
+    EXPECT_EQ(manager.getOutboundStats().slowClientDisconnects, 1);
+
+    char buffer[16];
+    EXPECT_EQ(recv(sockfd, buffer, sizeof(buffer), 0), 0);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, PartialWritesResumeWhenSocketDrains) {
+    EventLoop loop;
+    manager.setEventLoop(&loop);
+    int sockfd = connectTCPClient();
+
+    ASSERT_TRUE(manager.setHighWaterMark(1, 16 * 1024 * 1024));
+
+    const auto payload = std::make_shared<const std::string>(8 * 1024 * 1024, 'x');
+    ASSERT_TRUE(manager.sendPayload(1, payload));
+    loop.runOnce(0);
+    EXPECT_TRUE(manager.hasPendingOutput(1));
+
+    std::vector<char> buffer(64 * 1024);
+    std::size_t received = 0;
+    for (int i = 0; i < 5000 && received < payload->size(); ++i) {
+        ssize_t bytes = recv(sockfd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (bytes > 0) received += static_cast<std::size_t>(bytes);
+        loop.runOnce(1);
+    }
+
+    EXPECT_EQ(received, payload->size());
+    EXPECT_FALSE(manager.hasPendingOutput(1));
+    close(sockfd);
+}
+
+static AsyncTask awaitDrained(NetworkManager& manager, int clientID, int& resumed, bool& open) {
+    open = co_await manager.drained(clientID);
+    resumed++;
+}
+
+TEST_F(NetworkManagerTest, DrainedResumesOnceOutputIsWritten) {
+    EventLoop loop;
+    manager.setEventLoop(&loop);
+    int sockfd = connectTCPClient();
+    ASSERT_TRUE(manager.setHighWaterMark(1, 16 * 1024 * 1024));
+
+    int resumed = 0;
+    bool open = false;
+    awaitDrained(manager, 1, resumed, open);
+    EXPECT_EQ(resumed, 1);
+
+    const auto payload = std::make_shared<const std::string>(8 * 1024 * 1024, 'x');
+    ASSERT_TRUE(manager.sendPayload(1, payload));
+    loop.runOnce(0);
+    ASSERT_TRUE(manager.hasPendingOutput(1));
+    awaitDrained(manager, 1, resumed, open);
+    loop.runOnce(0);
+    EXPECT_EQ(resumed, 1);
+
+    std::vector<char> buffer(64 * 1024);
+    std::size_t received = 0;
+    for (int i = 0; i < 5000 && resumed < 2; ++i) {
+        ssize_t bytes = recv(sockfd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (bytes > 0) received += static_cast<std::size_t>(bytes);
+        loop.runOnce(1);
+    }
+    EXPECT_EQ(resumed, 2);
+    EXPECT_TRUE(open);
+    EXPECT_FALSE(manager.hasPendingOutput(1));
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, DrainedReportsAClosedClient) {
+    EventLoop loop;
+    manager.setEventLoop(&loop);
+    int sockfd = connectTCPClient();
+    ASSERT_TRUE(manager.setHighWaterMark(1, 16 * 1024 * 1024));
+
+    ASSERT_TRUE(manager.sendPayload(1, std::make_shared<const std::string>(8 * 1024 * 1024, 'x')));
+    loop.runOnce(0);
+    ASSERT_TRUE(manager.hasPendingOutput(1));
+
+    int resumed = 0;
+    bool open = true;
+    awaitDrained(manager, 1, resumed, open);
+    manager.closeConnection(1);
+    EXPECT_EQ(resumed, 0);
+    loop.runOnce(0);
+    EXPECT_EQ(resumed, 1);
+    EXPECT_FALSE(open);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, SendPayloadFromAnotherThreadChecksTheClient) {
+    EventLoop loop;
+    manager.setEventLoop(&loop);
+    int sockfd = connectTCPClient();
+
+    const auto payload = std::make_shared<const std::string>("hello");
+    EXPECT_FALSE(manager.sendPayload(7, payload));
+    EXPECT_TRUE(manager.sendPayload(1, payload));
+    EXPECT_EQ(loop.runOnce(0), 1);
+
+    char buffer[16];
+    EXPECT_EQ(recv(sockfd, buffer, sizeof(buffer), 0), 5);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, IdleClientsAreReapedAndReported) {
+    std::vector<int> closed;
+    manager.setCloseHandler([&closed](int clientID) { closed.push_back(clientID); });
+    manager.setIdleTimeout(std::chrono::seconds(10));
+    int sockfd = connectTCPClient();
+    const auto connected = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(manager.reapIdleConnections(connected + std::chrono::seconds(5)), 0);
+    EXPECT_TRUE(closed.empty());
+
+    EXPECT_EQ(manager.reapIdleConnections(connected + std::chrono::seconds(11)), 1);
+    ASSERT_EQ(closed.size(), 1);
+    EXPECT_EQ(closed[0], 1);
+
+    char buffer[16];
+    EXPECT_EQ(recv(sockfd, buffer, sizeof(buffer), 0), 0);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, ActivityPostponesIdleTimeout) {
+    manager.setIdleTimeout(std::chrono::seconds(10));
+    int sockfd = connectTCPClient();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::string json = testMessage1->toJSONString();
+    ASSERT_GT(send(sockfd, json.c_str(), json.size(), 0), 0);
+    ASSERT_TRUE(manager.receiveTCPMessage(1).has_value());
+    const auto heard = std::chrono::steady_clock::now();
+
+    // The timer set at connection time fires first and is pushed back by the activity.
+    EXPECT_EQ(manager.reapIdleConnections(heard + std::chrono::milliseconds(9900)), 0);
+    EXPECT_EQ(manager.reapIdleConnections(heard + std::chrono::milliseconds(10200)), 1);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, ZeroIdleTimeoutKeepsClientsOpen) {
+    manager.setIdleTimeout(std::chrono::milliseconds(0));
+    int sockfd = connectTCPClient();
+
+    EXPECT_EQ(manager.reapIdleConnections(std::chrono::steady_clock::now() + std::chrono::hours(24)), 0);
+    EXPECT_TRUE(manager.setHighWaterMark(1, 1024));
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, ReapedClientsLoseTheirSubscriptions) {
+    NotificationSystem notifications(&manager);
+    manager.setCloseHandler([&notifications](int clientID) { notifications.removeClient(clientID); });
+    manager.setIdleTimeout(std::chrono::seconds(1));
+    int sockfd = connectTCPClient();
+
+    notifications.subscribe(1, NotificationSubType::NO_STOCK);
+    ASSERT_EQ(manager.reapIdleConnections(std::chrono::steady_clock::now() + std::chrono::seconds(2)), 1);
+    EXPECT_EQ(notifications.notifySubscribers(NotificationSubType::NO_STOCK, "Restocked"), 0);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, OpenHandlerSeesEveryNewConnection) {
+    std::vector<int> opened;
+    manager.setOpenHandler([&opened](int clientID) { opened.push_back(clientID); });
+    int sockfd = connectTCPClient();
+
+    ASSERT_EQ(opened.size(), 1);
+    EXPECT_EQ(opened[0], 1);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, ReliableUDPDeduplicatesAndBatchesAcks) {
+    int sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sock_fd, 0);
+
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+
+    const std::string body = testMessage2->toJSONString().substr(1);
+    for (const std::string& datagram : {"{\"seq\":1," + body, "{\"seq\":1," + body, "{\"seq\":2," + body}) {
+        ASSERT_GT(sendto(sock_fd, datagram.c_str(), datagram.size(), 0,
+                         reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto messages = manager.receiveUDPMessage();
+    ASSERT_EQ(messages.size(), 2);
+    const int clientID = messages[0].getClientID();
+
+    char buffer[1024];
+    ssize_t bytes = recv(sock_fd, buffer, sizeof(buffer), 0);
+    ASSERT_GT(bytes, 0);
+    EXPECT_EQ(std::string(buffer, bytes), R"({"ack":2,"sack":[]})");
+    EXPECT_LT(recv(sock_fd, buffer, sizeof(buffer), MSG_DONTWAIT), 0);
+
+    // Replies to the peer are sequenced and resent until acknowledged.
+    manager.sendMessage(Message(clientID, MessageType::ALERT, AlertSubType::WEATHER, cJSON_CreateObject()));
+    bytes = recv(sock_fd, buffer, sizeof(buffer), 0);
+    ASSERT_GT(bytes, 0);
+    const std::string reply(buffer, bytes);
+    EXPECT_EQ(reply.rfind("{\"seq\":1,", 0), 0);
+    EXPECT_EQ(manager.getUnacknowledged(clientID), 1);
+
+    EXPECT_EQ(manager.retransmitReliable(std::chrono::steady_clock::now() + std::chrono::seconds(2)), 1);
+    bytes = recv(sock_fd, buffer, sizeof(buffer), 0);
+    EXPECT_EQ(std::string(buffer, bytes), reply);
+
+    const std::string ack = R"({"ack":1,"sack":[]})";
+    ASSERT_GT(sendto(sock_fd, ack.c_str(), ack.size(), 0, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_TRUE(manager.receiveUDPMessage().empty());
+    EXPECT_EQ(manager.getUnacknowledged(clientID), 0);
 
     close(sock_fd);
 }
+
+TEST_F(NetworkManagerTest, ReliablePeerResumesAfterBeingReaped) {
+    manager.setIdleTimeout(std::chrono::seconds(1));
+    int sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sock_fd, 0);
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+    auto sendDatagram = [&](const std::string& datagram) {
+        ASSERT_GT(sendto(sock_fd, datagram.c_str(), datagram.size(), 0,
+                         reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    };
+    const std::string body = testMessage2->toJSONString().substr(1);
+    char buffer[1024];
+
+    // A malformed datagram is neither delivered nor acknowledged, so the peer resends it.
+    sendDatagram("{\"seq\":1,\"broken");
+    EXPECT_TRUE(manager.receiveUDPMessage().empty());
+    EXPECT_LT(recv(sock_fd, buffer, sizeof(buffer), MSG_DONTWAIT), 0);
+    sendDatagram("{\"seq\":1," + body);
+    ASSERT_EQ(manager.receiveUDPMessage().size(), 1);
+    ASSERT_GT(recv(sock_fd, buffer, sizeof(buffer), 0), 0);
+
+    ASSERT_EQ(manager.reapIdleConnections(std::chrono::steady_clock::now() + std::chrono::seconds(2)), 1);
+    const std::uint64_t resumed = 3 * ReliableChannelConstants::RECEIVE_WINDOW;
+    sendDatagram("{\"seq\":" + std::to_string(resumed) + "," + body);
+    ASSERT_EQ(manager.receiveUDPMessage().size(), 1);
+    const ssize_t bytes = recv(sock_fd, buffer, sizeof(buffer), 0);
+    ASSERT_GT(bytes, 0);
+    EXPECT_EQ(std::string(buffer, bytes), "{\"ack\":" + std::to_string(resumed) + ",\"sack\":[]}");
+    close(sock_fd);
+}
+
+TEST_F(NetworkManagerTest, AcceptsIPv6Connections) {
+    int sockfd = socket(AF_INET6, SOCK_STREAM, 0);
+    ASSERT_GE(sockfd, 0);
+    sockaddr_in6 serverAddr{};
+    serverAddr.sin6_family = AF_INET6;
+    serverAddr.sin6_port = htons(port);
+    serverAddr.sin6_addr = in6addr_loopback;
+    if (connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) != 0) {
+        close(sockfd);
+        GTEST_SKIP() << "IPv6 loopback is not available";
+    }
+
+    EXPECT_EQ(manager.listenForConnections(1000), 1);
+    manager.sendMessage(*testMessage1);
+
+    char buffer[1024];
+    EXPECT_GT(recv(sockfd, buffer, sizeof(buffer), 0), 0);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, AcceptsAConnectionBurstInOneCall) {
+    constexpr int CLIENTS = 64;
+    std::vector<int> sockets;
+    for (int i = 0; i < CLIENTS; ++i) {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in serverAddr{};
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+        ASSERT_EQ(connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+        sockets.push_back(sockfd);
+    }
+
+    EXPECT_EQ(manager.listenForConnections(), CLIENTS);
+    EXPECT_EQ(manager.listenForConnections(0), 0);
+    for (int sockfd : sockets) close(sockfd);
+}
+
+TEST_F(NetworkManagerTest, InitializeThrowsWhenThePortIsTaken) {
+    NetworkManager other;
+    EXPECT_THROW(other.initialize(port), std::runtime_error);
+}
+
+TEST_F(NetworkManagerTest, ListenBacklogMustBePositive) {
+    EXPECT_THROW(manager.setListenBacklog(0), std::invalid_argument);
+    EXPECT_NO_THROW(manager.setListenBacklog(128));
+}
+
+class NetworkManagerIoUringTest : public ::testing::Test {
+protected:
+    NetworkManager manager;
+    int port = 40000 + (std::chrono::steady_clock::now().time_since_epoch().count() % 10000);
+
+    void SetUp() override {
+        manager.initialize(port, NetworkManager::IoBackend::IO_URING);
+        if (manager.getIoBackend() != NetworkManager::IoBackend::IO_URING) {
+            GTEST_SKIP() << "io_uring is not available";
+        }
+    }
+
+    int connectTCPClient() {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in serverAddr{};
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr));
+
+        manager.listenForConnections();
+        return sockfd;
+    }
+};
+
+TEST_F(NetworkManagerIoUringTest, ReceivesThroughMultishotRecv) {
+    int sockfd = connectTCPClient();
+
+    Message message(1, MessageType::INVENTORY, InventorySubType::HISTORY, cJSON_CreateObject());
+    const std::string json = message.toJSONString();
+    ASSERT_GT(send(sockfd, json.c_str(), json.size(), 0), 0);
+
+    auto received = manager.receiveTCPMessage(1);
+    ASSERT_TRUE(received.has_value());
+    EXPECT_EQ(received->getType(), MessageType::INVENTORY);
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerIoUringTest, SendsLargePayloadsInOrder) {
+    int sockfd = connectTCPClient();
+    ASSERT_TRUE(manager.setHighWaterMark(1, 16 * 1024 * 1024));
+
+    std::string data(4 * 1024 * 1024, '\0');
+    for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>('a' + i % 26);
+    const auto first = std::make_shared<const std::string>(data);
+    const auto second = std::make_shared<const std::string>("tail");
+    ASSERT_TRUE(manager.sendPayload(1, first));
+    ASSERT_TRUE(manager.sendPayload(1, second));
+
+    std::string received;
+    std::vector<char> buffer(64 * 1024);
+    for (int i = 0; i < 5000 && received.size() < data.size() + 4; ++i) {
+        ssize_t bytes = recv(sockfd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (bytes > 0) received.append(buffer.data(), static_cast<std::size_t>(bytes));
+        manager.processCompletions(1);
+    }
+    for (int i = 0; i < 100 && manager.hasPendingOutput(1); ++i) manager.processCompletions(10);
+
+    EXPECT_EQ(received, data + "tail");
+    EXPECT_FALSE(manager.hasPendingOutput(1));
+    close(sockfd);
+}
+
+TEST_F(NetworkManagerIoUringTest, ClosesConnectionWhenPeerCloses) {
+    std::vector<int> closed;
+    manager.setCloseHandler([&closed](int clientID) { closed.push_back(clientID); });
+    int sockfd = connectTCPClient();
+    close(sockfd);
+
+    for (int i = 0; i < 100 && closed.empty(); ++i) manager.processCompletions(10);
+    EXPECT_EQ(closed, std::vector<int>{1});
+    EXPECT_FALSE(manager.receiveTCPMessage(1).has_value());
+}
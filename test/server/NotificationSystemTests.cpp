@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "server/NotificationSystem.hpp"
+#include <algorithm>
 
 class NotificationSystemTest : public ::testing::Test {
 protected:
@@ -52,3 +53,50 @@ TEST_F(NotificationSystemTest, NotifyDoesNotSendIfNotSubscribed) {
 
     EXPECT_FALSE(system->notify(5, NotificationSubType::RECEIVED, "No message"));
 }
+
+TEST_F(NotificationSystemTest, SubscribersAreIndexedByType) {
+    system->registerClient(6);
+    system->registerClient(7);
+    system->unsubscribe(6, NotificationSubType::NO_STOCK);
+
+    const std::vector<int>& noStock = system->getSubscribers(NotificationSubType::NO_STOCK);
+    ASSERT_EQ(noStock.size(), 1);
+    EXPECT_EQ(noStock[0], 7);
+    EXPECT_TRUE(system->getSubscribers(NotificationSubType::DISCARDED).empty());
+    EXPECT_EQ(system->getSubscribers(NotificationSubType::ON_ROUTE).size(), 2);
+}
+
+TEST_F(NotificationSystemTest, RemoveClientKeepsIndexDense) {
+    system->registerClient(8);
+    system->registerClient(9);
+    system->registerClient(10);
+    system->removeClient(8);
+
+    const std::vector<int>& received = system->getSubscribers(NotificationSubType::RECEIVED);
+    ASSERT_EQ(received.size(), 2);
+    EXPECT_NE(std::find(received.begin(), received.end(), 9), received.end());
+    EXPECT_NE(std::find(received.begin(), received.end(), 10), received.end());
+
+    system->unsubscribe(10, NotificationSubType::RECEIVED);
+    EXPECT_TRUE(system->isSubscribed(9, NotificationSubType::RECEIVED));
+    EXPECT_FALSE(system->isSubscribed(10, NotificationSubType::RECEIVED));
+}
+
+TEST_F(NotificationSystemTest, SubscribeRegistersUnknownClient) {
+    system->subscribe(11, NotificationSubType::DISCARDED);
+
+    EXPECT_TRUE(system->isSubscribed(11, NotificationSubType::DISCARDED));
+    EXPECT_FALSE(system->isSubscribed(11, NotificationSubType::ON_ROUTE));
+    EXPECT_EQ(system->notifySubscribers(NotificationSubType::DISCARDED, "Discarded"), 1);
+}
+
+TEST_F(NotificationSystemTest, UnknownTypesAreIgnored) {
+    const auto unknown = static_cast<NotificationSubType>(40);
+    system->subscribe(1, unknown);
+    EXPECT_FALSE(system->isSubscribed(1, unknown));
+    EXPECT_TRUE(system->getSubscribers(unknown).empty());
+    system->unsubscribe(1, unknown);
+
+    system->registerClient(2);
+    EXPECT_FALSE(system->isSubscribed(2, static_cast<NotificationSubType>(NotificationConstants::NOTIFICATION_TYPE_COUNT)));
+}
@@ -0,0 +1,111 @@
+#include "server/RateLimiter.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class RateLimiterTest : public ::testing::Test {
+protected:
+    static RateLimiter::Options options(double rate, double burst) {
+        RateLimiter::Options result;
+        result.tokensPerSecond = rate;
+        result.burst = burst;
+        return result;
+    }
+};
+
+TEST_F(RateLimiterTest, InvalidOptionsThrow) {
+    EXPECT_THROW(RateLimiter(options(0, 5)), std::invalid_argument);
+    EXPECT_THROW(RateLimiter(options(1, 0.5)), std::invalid_argument);
+    EXPECT_THROW(RateLimiter(options(1, 1e9)), std::invalid_argument);
+}
+
+TEST_F(RateLimiterTest, BurstIsAvailableImmediately) {
+    RateLimiter limiter(options(1, 3));
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(limiter.tryAcquire(7, start));
+    EXPECT_TRUE(limiter.tryAcquire(7, start));
+    EXPECT_TRUE(limiter.tryAcquire(7, start));
+    EXPECT_FALSE(limiter.tryAcquire(7, start));
+}
+
+TEST_F(RateLimiterTest, TokensRefillOverTime) {
+    RateLimiter limiter(options(10, 1));
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(limiter.tryAcquire(1, start));
+    EXPECT_FALSE(limiter.tryAcquire(1, start + std::chrono::milliseconds(50)));
+    EXPECT_TRUE(limiter.tryAcquire(1, start + std::chrono::milliseconds(100)));
+    EXPECT_FALSE(limiter.tryAcquire(1, start + std::chrono::milliseconds(100)));
+}
+
+TEST_F(RateLimiterTest, RefillIsCappedAtBurst) {
+    RateLimiter limiter(options(10, 2));
+    const auto start = std::chrono::steady_clock::now();
+    const auto later = start + std::chrono::seconds(60);
+    EXPECT_TRUE(limiter.tryAcquire(1, later));
+    EXPECT_TRUE(limiter.tryAcquire(1, later));
+    EXPECT_FALSE(limiter.tryAcquire(1, later));
+}
+
+TEST_F(RateLimiterTest, KeysHaveSeparateBuckets) {
+    RateLimiter limiter(options(1, 1));
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(limiter.tryAcquire(1, start));
+    EXPECT_FALSE(limiter.tryAcquire(1, start));
+    EXPECT_TRUE(limiter.tryAcquire(2, start));
+}
+
+TEST_F(RateLimiterTest, ConcurrentAcquiresNeverExceedBurst) {
+    RateLimiter limiter(options(0.001, 100));
+    std::atomic<int> granted{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 100; ++j) {
+                if (limiter.tryAcquire(42)) granted++;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(granted.load(), 100);
+}
+
+TEST_F(RateLimiterTest, ManyKeysNeverShareABucket) {
+    RateLimiter limiter(options(0.001, 1));
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t key = 0; key < 20000; ++key) {
+        ASSERT_TRUE(limiter.tryAcquire(key, start)) << key;
+    }
+    for (std::uint64_t key = 0; key < 20000; ++key) {
+        ASSERT_FALSE(limiter.tryAcquire(key, start)) << key;
+    }
+}
+
+TEST_F(RateLimiterTest, TrackedKeysStayBounded) {
+    RateLimiter::Options bounded = options(10, 1);
+    bounded.maxKeys = RateLimiterConstants::SHARDS * 4;
+    RateLimiter limiter(bounded);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t key = 0; key < 10000; ++key) {
+        limiter.tryAcquire(key, start + std::chrono::milliseconds(key));
+    }
+    EXPECT_LE(limiter.getTrackedKeys(), bounded.maxKeys);
+
+    // Key 9999 was used last and has not refilled, so it was not dropped.
+    EXPECT_FALSE(limiter.tryAcquire(9999, start + std::chrono::milliseconds(9999)));
+}
+
+TEST_F(RateLimiterTest, OldestKeysAreDroppedWhenNoneHasRefilled) {
+    RateLimiter::Options bounded = options(0.001, 1);
+    bounded.maxKeys = RateLimiterConstants::SHARDS * 4;
+    RateLimiter limiter(bounded);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t key = 0; key < 10000; ++key) {
+        ASSERT_TRUE(limiter.tryAcquire(key, start));
+    }
+    EXPECT_LE(limiter.getTrackedKeys(), bounded.maxKeys);
+
+    // The newest keys keep their drained buckets; the first ones were dropped long ago.
+    EXPECT_FALSE(limiter.tryAcquire(9999, start));
+    EXPECT_TRUE(limiter.tryAcquire(0, start));
+}
@@ -0,0 +1,135 @@
+#include "server/ReliableChannel.hpp"
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+class ReliableChannelTest : public ::testing::Test {
+protected:
+    ReliableChannel channel;
+    ReliableChannel::Clock::time_point start = ReliableChannel::Clock::now();
+
+    static SharedPayload payload(const std::string& json) {
+        return std::make_shared<const std::string>(json);
+    }
+};
+
+TEST_F(ReliableChannelTest, ParsesSequenceAndAckFrames) {
+    EXPECT_EQ(ReliableChannel::parseSequence(R"({"seq":42,"type":1})"), 42);
+    EXPECT_FALSE(ReliableChannel::parseSequence(R"({"type":1,"seq":42})").has_value());
+    EXPECT_FALSE(ReliableChannel::parseSequence("Acknowledged").has_value());
+
+    const auto ack = ReliableChannel::parseAck(R"({"ack":7,"sack":[[9,10],[12,12]]})");
+    ASSERT_TRUE(ack.has_value());
+    EXPECT_EQ(ack->cumulative, 7);
+    ASSERT_EQ(ack->selective.size(), 2);
+    EXPECT_EQ(ack->selective[0], ReliableChannel::Range(9, 10));
+    EXPECT_FALSE(ReliableChannel::parseAck(R"({"seq":1})").has_value());
+}
+
+TEST_F(ReliableChannelTest, DuplicatesAreDetected) {
+    EXPECT_EQ(channel.receive(1), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.receive(3), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.receive(1), ReliableChannel::Delivery::DUPLICATE);
+    EXPECT_EQ(channel.receive(3), ReliableChannel::Delivery::DUPLICATE);
+    EXPECT_EQ(channel.receive(2), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.receive(2), ReliableChannel::Delivery::DUPLICATE);
+}
+
+TEST_F(ReliableChannelTest, DatagramsFarAheadAreRefused) {
+    ASSERT_EQ(channel.receive(1), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.receive(2 + ReliableChannelConstants::RECEIVE_WINDOW), ReliableChannel::Delivery::OUT_OF_WINDOW);
+    EXPECT_EQ(channel.receive(1 + ReliableChannelConstants::RECEIVE_WINDOW), ReliableChannel::Delivery::DELIVER);
+}
+
+TEST_F(ReliableChannelTest, ReorderedFirstDatagramIsDelivered) {
+    EXPECT_EQ(channel.receive(2), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.receive(1), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.takeAck(), R"({"ack":2,"sack":[]})");
+}
+
+TEST_F(ReliableChannelTest, RefusedDatagramsLeaveNoAckPending) {
+    EXPECT_EQ(channel.receive(0), ReliableChannel::Delivery::OUT_OF_WINDOW);
+    EXPECT_FALSE(channel.hasPendingAck());
+    ASSERT_EQ(channel.receive(1), ReliableChannel::Delivery::DELIVER);
+    channel.takeAck();
+    EXPECT_EQ(channel.receive(2 + ReliableChannelConstants::RECEIVE_WINDOW), ReliableChannel::Delivery::OUT_OF_WINDOW);
+    EXPECT_FALSE(channel.hasPendingAck());
+}
+
+TEST_F(ReliableChannelTest, ResumedStreamStartsTheWindowAtItsFirstDatagram) {
+    const std::uint64_t resumed = 5 * ReliableChannelConstants::RECEIVE_WINDOW;
+    EXPECT_FALSE(channel.isDuplicate(resumed));
+    EXPECT_EQ(channel.receive(resumed), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.receive(resumed + 2), ReliableChannel::Delivery::DELIVER);
+    EXPECT_TRUE(channel.isDuplicate(resumed - 1));
+    EXPECT_FALSE(channel.isDuplicate(resumed + 1));
+    EXPECT_EQ(channel.receive(resumed + 1), ReliableChannel::Delivery::DELIVER);
+    EXPECT_EQ(channel.takeAck(), "{\"ack\":" + std::to_string(resumed + 2) + ",\"sack\":[]}");
+}
+
+TEST_F(ReliableChannelTest, AckCoversEverythingReceived) {
+    EXPECT_FALSE(channel.hasPendingAck());
+    for (std::uint64_t sequence : {1, 2, 4, 5, 7}) channel.receive(sequence);
+
+    EXPECT_TRUE(channel.hasPendingAck());
+    EXPECT_EQ(channel.takeAck(), R"({"ack":2,"sack":[[4,5],[7,7]]})");
+    EXPECT_FALSE(channel.hasPendingAck());
+
+    channel.receive(2);
+    EXPECT_TRUE(channel.hasPendingAck());
+}
+
+TEST_F(ReliableChannelTest, SendFramesPayloadWithSequence) {
+    EXPECT_EQ(*channel.send(payload(R"({"type":1})"), start), R"({"seq":1,"type":1})");
+    EXPECT_EQ(*channel.send(payload("{}"), start), R"({"seq":2})");
+    EXPECT_EQ(channel.getUnacknowledged(), 2);
+    EXPECT_THROW(channel.send(payload("Acknowledged"), start), std::invalid_argument);
+}
+
+TEST_F(ReliableChannelTest, AcksReleaseDatagramsAndSampleRtt) {
+    channel.send(payload("{}"), start);
+    channel.send(payload("{}"), start);
+    channel.send(payload("{}"), start);
+
+    EXPECT_EQ(channel.acknowledge({1, {{3, 3}}}, start + 100ms), 2);
+    EXPECT_EQ(channel.getUnacknowledged(), 1);
+    // First sample R = 100 ms: SRTT = R, RTTVAR = R / 2, RTO = SRTT + 4 * RTTVAR.
+    EXPECT_EQ(channel.getRto(), 300ms);
+
+    EXPECT_EQ(channel.acknowledge({3, {}}, start + 150ms), 1);
+    EXPECT_EQ(channel.getUnacknowledged(), 0);
+}
+
+TEST_F(ReliableChannelTest, ExpiredTimerResendsOldestWithBackoff) {
+    const SharedPayload first = channel.send(payload("{}"), start);
+    channel.send(payload("{}"), start);
+
+    EXPECT_TRUE(channel.collectRetransmissions(start + 999ms).empty());
+    const auto resent = channel.collectRetransmissions(start + 1s);
+    ASSERT_EQ(resent.size(), 1);
+    EXPECT_EQ(*resent[0], *first);
+    EXPECT_EQ(channel.getRto(), 2s);
+    EXPECT_TRUE(channel.collectRetransmissions(start + 2s).empty());
+    EXPECT_EQ(channel.collectRetransmissions(start + 3s).size(), 1);
+}
+
+TEST_F(ReliableChannelTest, ResentDatagramsAreNotSampled) {
+    channel.send(payload("{}"), start);
+    ASSERT_EQ(channel.collectRetransmissions(start + 1s).size(), 1);
+
+    channel.acknowledge({1, {}}, start + 1010ms);
+    EXPECT_EQ(channel.getRto(), 2s);
+}
+
+TEST_F(ReliableChannelTest, PeerIsExhaustedAfterTransmissionLimit) {
+    channel.send(payload("{}"), start);
+    auto now = start;
+    for (std::uint32_t sent = 1; sent < ReliableChannelConstants::MAX_TRANSMISSIONS; ++sent) {
+        now += ReliableChannelConstants::MAX_RTO;
+        ASSERT_EQ(channel.collectRetransmissions(now).size(), 1);
+    }
+    EXPECT_FALSE(channel.isExhausted());
+
+    EXPECT_TRUE(channel.collectRetransmissions(now + ReliableChannelConstants::MAX_RTO).empty());
+    EXPECT_TRUE(channel.isExhausted());
+}
@@ -0,0 +1,161 @@
+#include "server/RotatingLogFile.hpp"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class RotatingLogFileTest : public ::testing::Test {
+protected:
+    std::string logFile = "test_rotating.log";
+    RotatingLogFile::Options options;
+
+    void SetUp() override {
+        removeSegments();
+        options.segmentBytes = RotatingLogFileConstants::MIN_SEGMENT_BYTES;
+        options.keepSegments = 3;
+    }
+
+    void TearDown() override {
+        removeSegments();
+    }
+
+    void removeSegments() {
+        unlink(logFile.c_str());
+        for (int i = 1; i <= 10; ++i) {
+            unlink((logFile + "." + std::to_string(i)).c_str());
+        }
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    bool exists(const std::string& path) {
+        return access(path.c_str(), F_OK) == 0;
+    }
+};
+
+TEST_F(RotatingLogFileTest, CloseTruncatesToWrittenBytes) {
+    {
+        RotatingLogFile file(logFile, options);
+        file.write("hello\n", 6);
+        EXPECT_EQ(file.getWrittenBytes(), 6);
+    }
+    EXPECT_EQ(readFile(logFile), "hello\n");
+}
+
+TEST_F(RotatingLogFileTest, ActiveSegmentHoldsOnlyWrittenBytes) {
+    RotatingLogFile file(logFile, options);
+    file.write("hello\n", 6);
+    EXPECT_EQ(readFile(logFile), "hello\n");
+    file.write("world\n", 6);
+    EXPECT_EQ(readFile(logFile), "hello\nworld\n");
+}
+
+TEST_F(RotatingLogFileTest, RotatesWhenSegmentIsFull) {
+    const std::string chunk(1000, 'x');
+    const std::size_t chunks = RotatingLogFileConstants::MIN_SEGMENT_BYTES * 5 / 2 / chunk.size();
+    {
+        RotatingLogFile file(logFile, options);
+        for (std::size_t i = 0; i < chunks; ++i) {
+            file.write(chunk.data(), chunk.size());
+        }
+    }
+
+    ASSERT_TRUE(exists((logFile + ".1")));
+    EXPECT_TRUE(exists((logFile + ".2")));
+    std::size_t total = readFile(logFile).size() + readFile((logFile + ".1")).size() + readFile((logFile + ".2")).size();
+    EXPECT_EQ(total, chunks * chunk.size());
+    // Writes that fit in a segment are never split.
+    EXPECT_EQ(readFile((logFile + ".1")).size() % chunk.size(), 0);
+}
+
+TEST_F(RotatingLogFileTest, KeepsOnlyConfiguredSegments) {
+    RotatingLogFile file(logFile, options);
+    for (int i = 0; i < 6; ++i) {
+        file.write("segment\n", 8);
+        file.rotate();
+    }
+
+    EXPECT_TRUE(exists((logFile + ".3")));
+    EXPECT_FALSE(exists((logFile + ".4")));
+}
+
+TEST_F(RotatingLogFileTest, PreambleStartsEveryNewSegment) {
+    {
+        RotatingLogFile file(logFile, options);
+        file.appendPreamble("HEADER\n");
+        file.write("first\n", 6);
+        file.rotate();
+        file.write("second\n", 7);
+    }
+
+    EXPECT_EQ(readFile((logFile + ".1")), "first\n");
+    EXPECT_EQ(readFile(logFile), "HEADER\nsecond\n");
+}
+
+TEST_F(RotatingLogFileTest, RotatesByAge) {
+    options.interval = std::chrono::milliseconds(20);
+    RotatingLogFile file(logFile, options);
+
+    EXPECT_FALSE(file.rotateIfDue());
+    file.write("old\n", 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_TRUE(file.rotateIfDue());
+    EXPECT_EQ(readFile((logFile + ".1")), "old\n");
+}
+
+TEST_F(RotatingLogFileTest, ExistingFileIsRotatedOnOpen) {
+    {
+        std::ofstream previous(logFile);
+        previous << "previous run\n";
+    }
+    {
+        RotatingLogFile file(logFile, options);
+        file.write("new run\n", 8);
+    }
+
+    EXPECT_EQ(readFile((logFile + ".1")), "previous run\n");
+    EXPECT_EQ(readFile(logFile), "new run\n");
+}
+
+TEST_F(RotatingLogFileTest, PreambleFillingTheSegmentDoesNotDropData) {
+    {
+        RotatingLogFile file(logFile, options);
+        file.appendPreamble(std::string(options.segmentBytes + 10, 'p'));
+        file.rotate();
+        EXPECT_TRUE(file.write("abc", 3));
+        EXPECT_EQ(file.getDroppedBytes(), 0);
+    }
+    const std::string contents = readFile(logFile);
+    ASSERT_EQ(contents.size(), options.segmentBytes + 13);
+    EXPECT_EQ(contents.substr(contents.size() - 3), "abc");
+}
+
+TEST_F(RotatingLogFileTest, FailedSegmentIsReportedAndRetried) {
+    const std::string directory = "rotating_test_dir";
+    const std::string path = directory + "/events.log";
+    options.keepSegments = 0;
+    mkdir(directory.c_str(), 0755);
+    {
+        RotatingLogFile file(path, options);
+        ASSERT_TRUE(file.write("a", 1));
+        unlink(path.c_str());
+        rmdir(directory.c_str());
+        file.rotate();
+
+        EXPECT_FALSE(file.write("lost", 4));
+        EXPECT_EQ(file.getDroppedBytes(), 4);
+
+        mkdir(directory.c_str(), 0755);
+        EXPECT_TRUE(file.write("kept", 4));
+    }
+    EXPECT_EQ(readFile(path), "kept");
+    unlink(path.c_str());
+    rmdir(directory.c_str());
+}
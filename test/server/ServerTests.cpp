@@ -0,0 +1,209 @@
+#include "server/Server.hpp"
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class ServerTest : public ::testing::Test {
+protected:
+    int port = 25000 + (std::chrono::steady_clock::now().time_since_epoch().count() % 5000);
+
+    int connectTCPClient(Server& server) {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in serverAddr{};
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+        EXPECT_EQ(connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+        server.runOnce(1000);
+        return sockfd;
+    }
+
+    static void sendPing(int sockfd) {
+        const std::string ping = Message(0, MessageType::HEARTBEAT, HeartbeatSubType::PING, cJSON_CreateObject()).toJSONString();
+        ASSERT_EQ(send(sockfd, ping.data(), ping.size(), 0), static_cast<ssize_t>(ping.size()));
+    }
+
+    static std::string receiveReply(Server& server, int sockfd) {
+        char buffer[1024];
+        for (int i = 0; i < 100; ++i) {
+            const ssize_t bytes = recv(sockfd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (bytes > 0) return {buffer, static_cast<std::size_t>(bytes)};
+            server.runOnce(10);
+        }
+        return {};
+    }
+};
+
+TEST_F(ServerTest, ReceivedMessagesAreQueuedAndDispatched) {
+    Server server;
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    ASSERT_EQ(server.getNetworkManager().getConnectionCount(), 1);
+
+    sendPing(sockfd);
+    const Message pong = Message::fromJSONString(receiveReply(server, sockfd));
+    EXPECT_EQ(pong.getType(), MessageType::HEARTBEAT);
+    EXPECT_EQ(pong.getSubType(), static_cast<int>(HeartbeatSubType::PONG));
+    EXPECT_EQ(server.getMessageQueue().getStats().dispatched, 1);
+    close(sockfd);
+}
+
+TEST_F(ServerTest, RejectedMessagesAreAnsweredBusy) {
+    Server::Options options;
+    options.queueCapacity = 1;
+    Server server(options);
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    ASSERT_EQ(server.getMessageQueue().push(Message(7, MessageType::HEARTBEAT, HeartbeatSubType::PONG, cJSON_CreateObject())),
+              MessageQueue::PushResult::ACCEPTED);
+
+    sendPing(sockfd);
+    const Message reply = Message::fromJSONString(receiveReply(server, sockfd));
+    EXPECT_EQ(reply.getType(), MessageType::STATUS);
+    EXPECT_EQ(reply.getSubType(), static_cast<int>(StatusSubType::BUSY));
+    EXPECT_EQ(server.getMessageQueue().getStats().rejected, 1);
+    close(sockfd);
+}
+
+TEST_F(ServerTest, BlockPolicyDispatchesInsteadOfBlockingTheLoop) {
+    Server::Options options;
+    options.queueCapacity = 1;
+    options.overflowPolicy = MessageQueue::OverflowPolicy::BLOCK;
+    Server server(options);
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    server.getMessageQueue().push(Message(7, MessageType::HEARTBEAT, HeartbeatSubType::PONG, cJSON_CreateObject()));
+
+    sendPing(sockfd);
+    const Message pong = Message::fromJSONString(receiveReply(server, sockfd));
+    EXPECT_EQ(pong.getSubType(), static_cast<int>(HeartbeatSubType::PONG));
+    EXPECT_EQ(server.getMessageQueue().getStats().dispatched, 2);
+    close(sockfd);
+}
+
+TEST_F(ServerTest, ClientsThatHangUpAreClosed) {
+    Server server;
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    ASSERT_EQ(server.getNetworkManager().getConnectionCount(), 1);
+
+    close(sockfd);
+    server.runOnce(1000);
+    EXPECT_EQ(server.getNetworkManager().getConnectionCount(), 0);
+}
+
+TEST_F(ServerTest, IoUringBackendFeedsTheQueue) {
+    Server::Options options;
+    options.ioBackend = NetworkManager::IoBackend::IO_URING;
+    Server server(options);
+    server.start(port);
+    if (server.getNetworkManager().getIoBackend() != NetworkManager::IoBackend::IO_URING) {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+    int sockfd = connectTCPClient(server);
+
+    sendPing(sockfd);
+    const Message pong = Message::fromJSONString(receiveReply(server, sockfd));
+    EXPECT_EQ(pong.getSubType(), static_cast<int>(HeartbeatSubType::PONG));
+    close(sockfd);
+}
+
+TEST_F(ServerTest, ClosedClientsLoseTheirState) {
+    Server server;
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    sendPing(sockfd);
+    ASSERT_FALSE(receiveReply(server, sockfd).empty());
+
+    server.getNotificationSystem().subscribe(1, NotificationSubType::NO_STOCK);
+    cJSON* items = cJSON_CreateObject();
+    cJSON_AddNumberToObject(items, "5", 3);
+    server.getInventoryManager().addClient(1, items);
+    cJSON_Delete(items);
+    ASSERT_NE(server.getHeartbeatMonitor().getRttHistogram(1), nullptr);
+
+    close(sockfd);
+    server.runOnce(1000);
+    EXPECT_FALSE(server.getNotificationSystem().isSubscribed(1, NotificationSubType::NO_STOCK));
+    EXPECT_EQ(server.getInventoryManager().getClientInventory(1), nullptr);
+    EXPECT_EQ(server.getInventoryManager().getStockLevel(5), 0);
+    EXPECT_EQ(server.getHeartbeatMonitor().getRttHistogram(1), nullptr);
+}
+
+TEST_F(ServerTest, MaintenanceTimerReapsIdleClients) {
+    Server::Options options;
+    options.idleTimeout = std::chrono::milliseconds(200);
+    Server server(options);
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    server.getNotificationSystem().subscribe(1, NotificationSubType::ON_ROUTE);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (server.getNetworkManager().getConnectionCount() > 0 && std::chrono::steady_clock::now() < deadline) {
+        server.runOnce(100);
+    }
+    EXPECT_EQ(server.getNetworkManager().getConnectionCount(), 0);
+    EXPECT_FALSE(server.getNotificationSystem().isSubscribed(1, NotificationSubType::ON_ROUTE));
+    close(sockfd);
+}
+
+TEST_F(ServerTest, MaintenanceTimerSendsHeartbeats) {
+    Server::Options options;
+    options.heartbeat.interval = std::chrono::milliseconds(100);
+    Server server(options);
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    sendPing(sockfd);
+    ASSERT_EQ(Message::fromJSONString(receiveReply(server, sockfd)).getSubType(), static_cast<int>(HeartbeatSubType::PONG));
+
+    const Message ping = Message::fromJSONString(receiveReply(server, sockfd));
+    EXPECT_EQ(ping.getType(), MessageType::HEARTBEAT);
+    EXPECT_EQ(ping.getSubType(), static_cast<int>(HeartbeatSubType::PING));
+    close(sockfd);
+}
+
+TEST_F(ServerTest, RunReturnsAfterStop) {
+    Server server;
+    server.start(port);
+    server.getEventLoop().post([&server] { server.stop(); });
+    server.run();
+    SUCCEED();
+}
+
+TEST_F(ServerTest, RequestedShutdownDrainsAndSnapshotsBeforeRunReturns) {
+    Server::Options options;
+    options.snapshotPath = "server_test_inventory.json";
+    std::remove(options.snapshotPath.c_str());
+    Server server(options);
+    server.start(port);
+    int sockfd = connectTCPClient(server);
+    cJSON* items = cJSON_CreateObject();
+    cJSON_AddNumberToObject(items, "7", 12);
+    server.getInventoryManager().addClient(3, items);
+    cJSON_Delete(items);
+
+    // The ping is queued but not dispatched when the shutdown is requested.
+    ASSERT_EQ(server.getMessageQueue().push(Message(1, MessageType::HEARTBEAT, HeartbeatSubType::PING, cJSON_CreateObject())),
+              MessageQueue::PushResult::ACCEPTED);
+    ShutdownCoordinator::requestShutdown();
+    server.run();
+
+    EXPECT_TRUE(server.getMessageQueue().empty());
+    EXPECT_EQ(server.getNetworkManager().getConnectionCount(), 0);
+    char buffer[1024];
+    const ssize_t bytes = recv(sockfd, buffer, sizeof(buffer), 0);
+    ASSERT_GT(bytes, 0);
+    EXPECT_EQ(Message::fromJSONString(std::string(buffer, bytes)).getSubType(), static_cast<int>(HeartbeatSubType::PONG));
+    std::ifstream snapshot(options.snapshotPath);
+    std::stringstream contents;
+    contents << snapshot.rdbuf();
+    EXPECT_EQ(contents.str(), R"({"global":{"7":12},"clients":{"3":{"7":12}}})");
+    std::remove(options.snapshotPath.c_str());
+    close(sockfd);
+}
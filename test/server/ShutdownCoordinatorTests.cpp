@@ -0,0 +1,142 @@
+#include "server/ShutdownCoordinator.hpp"
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+class ShutdownCoordinatorTest : public ::testing::Test {
+protected:
+    std::string logFile = "shutdown_test.log";
+    std::string snapshotFile = "shutdown_test_inventory.json";
+    int port = 20000 + (std::chrono::steady_clock::now().time_since_epoch().count() % 10000);
+    NetworkManager manager;
+    ShutdownCoordinator coordinator;
+
+    void SetUp() override {
+        std::remove(logFile.c_str());
+        std::remove(snapshotFile.c_str());
+        manager.initialize(port);
+        coordinator.setNetworkManager(&manager);
+    }
+
+    void TearDown() override {
+        std::remove(logFile.c_str());
+        std::remove(snapshotFile.c_str());
+    }
+
+    int connectTCPClient() {
+        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in serverAddr{};
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+        connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr));
+        manager.listenForConnections(1000);
+        return sockfd;
+    }
+
+    static std::string readFile(const std::string& path) {
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+};
+
+TEST_F(ShutdownCoordinatorTest, DispatchesQueuedMessagesBeforeClosing) {
+    Authentication::Config config;
+    config.kdfIterations = 1000;
+    Authentication auth(config);
+    auth.addCredentials(1, "password123");
+    ASSERT_TRUE(auth.authenticate(1, "password123"));
+
+    MessageQueue queue;
+    MessageDispatcher dispatcher(&queue);
+    dispatcher.setAuthentication(&auth);
+    coordinator.setDispatcher(&queue, &dispatcher);
+    queue.push(Message(1, MessageType::CREDENTIALS, CredentialSubType::LOGOUT, cJSON_CreateObject()));
+
+    const ShutdownCoordinator::Report report = coordinator.run();
+    EXPECT_EQ(report.dispatched, 1);
+    EXPECT_EQ(report.abandoned, 0);
+    EXPECT_TRUE(report.deadlineMet);
+    EXPECT_FALSE(auth.isAuthorized(1));
+    EXPECT_EQ(queue.push(Message(1, MessageType::CREDENTIALS, CredentialSubType::LOGOUT, cJSON_CreateObject())),
+              MessageQueue::PushResult::CLOSED);
+}
+
+TEST_F(ShutdownCoordinatorTest, FlushesOutboundQueuesThenCloses) {
+    std::vector<int> closed;
+    manager.setCloseHandler([&closed](int clientID) { closed.push_back(clientID); });
+    int sockfd = connectTCPClient();
+    ASSERT_TRUE(manager.sendPayload(1, std::make_shared<const std::string>("goodbye")));
+
+    const ShutdownCoordinator::Report report = coordinator.run();
+    EXPECT_TRUE(report.outboundFlushed);
+    EXPECT_EQ(closed, std::vector<int>{1});
+
+    char buffer[16];
+    ASSERT_EQ(recv(sockfd, buffer, sizeof(buffer), 0), 7);
+    EXPECT_EQ(std::string(buffer, 7), "goodbye");
+    EXPECT_EQ(recv(sockfd, buffer, sizeof(buffer), 0), 0);
+    close(sockfd);
+}
+
+TEST_F(ShutdownCoordinatorTest, GivesUpOnClientsThatDoNotReadAtTheDeadline) {
+    int sockfd = connectTCPClient();
+    ASSERT_TRUE(manager.setHighWaterMark(1, 64 * 1024 * 1024));
+    ASSERT_TRUE(manager.sendPayload(1, std::make_shared<const std::string>(32 * 1024 * 1024, 'x')));
+
+    const auto start = std::chrono::steady_clock::now();
+    const ShutdownCoordinator::Report report = coordinator.run(std::chrono::milliseconds(200));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_FALSE(report.outboundFlushed);
+    EXPECT_FALSE(report.deadlineMet);
+    EXPECT_FALSE(manager.hasPendingOutput(1));
+    close(sockfd);
+}
+
+TEST_F(ShutdownCoordinatorTest, LogsFlushesAndSnapshotsInventory) {
+    EventLogger logger(logFile);
+    InventoryManager inventory;
+    cJSON* items = cJSON_CreateObject();
+    cJSON_AddNumberToObject(items, "7", 12);
+    inventory.addClient(3, items);
+    cJSON_Delete(items);
+    coordinator.setEventLogger(&logger);
+    coordinator.setInventory(&inventory, snapshotFile);
+
+    const ShutdownCoordinator::Report report = coordinator.run();
+    EXPECT_TRUE(report.snapshotSaved);
+    EXPECT_NE(readFile(logFile).find("Shutting down"), std::string::npos);
+    EXPECT_EQ(readFile(snapshotFile), R"({"global":{"7":12},"clients":{"3":{"7":12}}})");
+}
+
+TEST_F(ShutdownCoordinatorTest, StopsAcceptingConnections) {
+    coordinator.run();
+
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+    EXPECT_NE(connect(sockfd, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)), 0);
+    EXPECT_EQ(manager.listenForConnections(), 0);
+    close(sockfd);
+}
+
+TEST_F(ShutdownCoordinatorTest, SignalsRequestShutdown) {
+    ShutdownCoordinator::installSignalHandlers();
+    raise(SIGTERM);
+    EXPECT_TRUE(ShutdownCoordinator::isShutdownRequested());
+
+    struct sigaction action{};
+    action.sa_handler = SIG_DFL;
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+}
@@ -0,0 +1,71 @@
+#include "server/TimerWheel.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+    TimerWheel::Clock::time_point start = TimerWheel::Clock::now();
+};
+
+TEST_F(TimerWheelTest, InvalidTickThrows) {
+    EXPECT_THROW(TimerWheel(0ms, start), std::invalid_argument);
+}
+
+TEST_F(TimerWheelTest, FiresAtDeadlineAndNotBefore) {
+    TimerWheel wheel(10ms, start);
+    wheel.schedule(1, start + 35ms);
+    EXPECT_EQ(wheel.size(), 1);
+
+    EXPECT_TRUE(wheel.advance(start + 30ms).empty());
+    EXPECT_EQ(wheel.advance(start + 40ms), std::vector<std::uint64_t>{1});
+    EXPECT_EQ(wheel.size(), 0);
+    EXPECT_TRUE(wheel.advance(start + 1s).empty());
+}
+
+TEST_F(TimerWheelTest, PastDeadlinesFireOnNextTick) {
+    TimerWheel wheel(10ms, start);
+    EXPECT_TRUE(wheel.advance(start + 100ms).empty());
+
+    wheel.schedule(2, start);
+    EXPECT_TRUE(wheel.advance(start + 100ms).empty());
+    EXPECT_EQ(wheel.advance(start + 110ms), std::vector<std::uint64_t>{2});
+}
+
+TEST_F(TimerWheelTest, DistantTimersCascadeToTheirTick) {
+    TimerWheel wheel(1ms, start);
+    const std::vector<std::chrono::milliseconds> delays = {1ms, 63ms, 64ms, 65ms, 4095ms, 4096ms, 4097ms, 300000ms};
+    for (std::size_t i = 0; i < delays.size(); ++i) {
+        wheel.schedule(i, start + delays[i]);
+    }
+
+    for (std::size_t i = 0; i < delays.size(); ++i) {
+        EXPECT_TRUE(wheel.advance(start + delays[i] - 1ms).empty()) << "delay " << delays[i].count();
+        EXPECT_EQ(wheel.advance(start + delays[i]), std::vector<std::uint64_t>{i}) << "delay " << delays[i].count();
+    }
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST_F(TimerWheelTest, TimersInTheSameTickFireTogether) {
+    TimerWheel wheel(10ms, start);
+    wheel.schedule(5, start + 2s);
+    wheel.schedule(6, start + 2s);
+    wheel.schedule(7, start + 3s);
+
+    std::vector<std::uint64_t> fired = wheel.advance(start + 2500ms);
+    std::sort(fired.begin(), fired.end());
+    EXPECT_EQ(fired, (std::vector<std::uint64_t>{5, 6}));
+    EXPECT_EQ(wheel.size(), 1);
+}
+
+TEST_F(TimerWheelTest, DeadlinesBeyondTheSpanAreClamped) {
+    TimerWheel wheel(1ms, start);
+    const auto span = std::chrono::milliseconds(std::int64_t{1} << 24);
+    wheel.schedule(9, start + span * 4);
+
+    EXPECT_TRUE(wheel.advance(start + span - 2ms).empty());
+    EXPECT_EQ(wheel.advance(start + span), std::vector<std::uint64_t>{9});
+}